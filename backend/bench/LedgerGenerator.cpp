@@ -0,0 +1,121 @@
+#include "LedgerGenerator.h"
+#include <cmath>
+#include <cstdio>
+
+LedgerGenerator::LedgerGenerator(uint64_t seed, int startYear, int years)
+    : rng(seed), startYear(startYear), years(years)
+{
+    profiles = {
+        {"Groceries", "#4CAF50", false, 22, 45.0, 0.6, {"Woolworths", "Coles", "Aldi", "IGA", "Harris Farm Markets", "Costco"}},
+        {"Dining", "#FF9800", false, 16, 28.0, 0.7, {"Starbucks", "McDonald's", "Uber Eats", "Local Cafe", "Sushi Train", "Pizza Hut", "Grill'd"}},
+        {"Transport", "#3F51B5", false, 12, 22.0, 0.8, {"Shell", "BP", "Uber", "Opal Top Up", "Caltex", "Secure Parking"}},
+        {"Utilities", "#2196F3", false, 5, 140.0, 0.4, {"AGL Energy", "Origin Energy", "Sydney Water", "Telstra", "Optus"}},
+        {"Rent", "#795548", false, 3, 1800.0, 0.1, {"Rent payment", "Ray White Property"}},
+        {"Entertainment", "#F44336", false, 8, 35.0, 0.8, {"Netflix", "Spotify", "Event Cinemas", "Steam", "Ticketek"}},
+        {"Health", "#009688", false, 4, 60.0, 0.9, {"Chemist Warehouse", "Priceline Pharmacy", "Medical Centre", "Dental Care"}},
+        {"Shopping", "#9C27B0", false, 10, 75.0, 1.0, {"Amazon", "Kmart", "JB Hi-Fi", "Bunnings", "Myer", "Target", "eBay"}},
+        {"Travel", "#00BCD4", false, 2, 420.0, 1.0, {"Qantas", "Virgin Australia", "Booking.com", "Airbnb"}},
+        {"Insurance", "#607D8B", false, 2, 160.0, 0.3, {"NRMA Insurance", "Medibank", "Bupa"}},
+        {"Salary", "#8BC34A", true, 5, 3200.0, 0.2, {"Monthly salary", "Payroll deposit"}},
+        {"Other Income", "#CDDC39", true, 3, 120.0, 1.2, {"Interest", "Refund", "Transfer from savings", "Dividend"}},
+    };
+
+    std::vector<double> weights;
+    for (const auto &profile : profiles)
+    {
+        weights.push_back(profile.weight);
+    }
+    categoryPick = std::discrete_distribution<int>(weights.begin(), weights.end());
+
+    // Slightly busier towards the end of the year
+    monthPick = std::discrete_distribution<int>({8, 7, 8, 8, 8, 8, 8, 8, 8, 9, 10, 13});
+}
+
+std::vector<Category> LedgerGenerator::makeCategories() const
+{
+    std::vector<Category> categories;
+    for (size_t i = 0; i < profiles.size(); i++)
+    {
+        categories.emplace_back(static_cast<int>(i + 1), profiles[i].name,
+                                std::string(profiles[i].name) + " transactions", profiles[i].color);
+    }
+    return categories;
+}
+
+size_t LedgerGenerator::skewedIndex(size_t count)
+{
+    // Squaring a uniform variate favours the first (most popular) entries
+    double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+    size_t index = static_cast<size_t>(u * u * count);
+    return index < count ? index : count - 1;
+}
+
+std::string LedgerGenerator::makeDate()
+{
+    int year = startYear + std::uniform_int_distribution<int>(0, years - 1)(rng);
+    int month = monthPick(rng) + 1;
+    int day = std::uniform_int_distribution<int>(1, 28)(rng);
+
+    // Sized for any three ints, so no field can be cut off
+    char buffer[36];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", year, month, day);
+    return buffer;
+}
+
+std::string LedgerGenerator::makeMonth()
+{
+    return makeDate().substr(0, 7);
+}
+
+Transaction LedgerGenerator::makeTransaction()
+{
+    int categoryIndex = categoryPick(rng);
+    const CategoryProfile &profile = profiles[categoryIndex];
+
+    std::string description = profile.merchants[skewedIndex(profile.merchants.size())];
+
+    // About a third of card transactions carry a store or reference number
+    if (!profile.isIncome && std::uniform_int_distribution<int>(0, 2)(rng) == 0)
+    {
+        description += " #" + std::to_string(std::uniform_int_distribution<int>(100, 999)(rng));
+    }
+
+    std::lognormal_distribution<double> amountPick(std::log(profile.medianAmount), profile.spread);
+    double amount = std::round(amountPick(rng) * 100.0) / 100.0;
+
+    return Transaction(0, makeDate(), amount, description, categoryIndex + 1, profile.isIncome);
+}
+
+std::vector<Transaction> LedgerGenerator::makeTransactions(size_t count)
+{
+    std::vector<Transaction> transactions;
+    transactions.reserve(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        transactions.push_back(makeTransaction());
+    }
+    return transactions;
+}
+
+std::vector<Budget> LedgerGenerator::makeBudgets()
+{
+    std::vector<Budget> budgets;
+    for (int year = startYear; year < startYear + years; year++)
+    {
+        for (int month = 1; month <= 12; month++)
+        {
+            char monthYear[16];
+            std::snprintf(monthYear, sizeof(monthYear), "%04d-%02d", year, month);
+
+            for (size_t i = 0; i < profiles.size(); i++)
+            {
+                if (!profiles[i].isIncome)
+                {
+                    double allocated = std::round(profiles[i].medianAmount * profiles[i].weight * 4.0);
+                    budgets.emplace_back(static_cast<int>(i + 1), monthYear, allocated);
+                }
+            }
+        }
+    }
+    return budgets;
+}
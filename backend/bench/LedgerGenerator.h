@@ -0,0 +1,103 @@
+/**
+ * @file LedgerGenerator.h
+ * @brief Defines the LedgerGenerator class that builds synthetic ledgers for benchmarks.
+ */
+#pragma once
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "../include/Transaction.h"
+#include "../include/Category.h"
+#include "../include/Budget.h"
+
+/**
+ * @class LedgerGenerator
+ * @brief Produces deterministic, realistic-looking categories, transactions and budgets.
+ *
+ * The same seed always yields the same ledger. Merchants are drawn with a skewed
+ * distribution so a few descriptions dominate, amounts follow a per-category
+ * log-normal distribution, and dates spread over a configurable number of years
+ * with a mild end-of-year peak.
+ */
+class LedgerGenerator
+{
+public:
+    /**
+     * @brief Constructs a generator.
+     *
+     * @param seed Seed for the random number generator
+     * @param startYear First year transactions are dated in
+     * @param years Number of years the transactions span
+     */
+    LedgerGenerator(uint64_t seed, int startYear = 2015, int years = 10);
+
+    /**
+     * @brief Builds the category set, with IDs 1..N.
+     * @return The categories
+     */
+    std::vector<Category> makeCategories() const;
+
+    /**
+     * @brief Builds a single transaction with ID 0.
+     * @return The transaction
+     */
+    Transaction makeTransaction();
+
+    /**
+     * @brief Builds a list of transactions with ID 0.
+     *
+     * @param count Number of transactions
+     * @return The transactions
+     */
+    std::vector<Transaction> makeTransactions(size_t count);
+
+    /**
+     * @brief Builds one budget per expense category and month of the span.
+     * @return The budgets
+     */
+    std::vector<Budget> makeBudgets();
+
+    /**
+     * @brief Picks a month of the span, weighted like transaction dates.
+     * @return Month and year in "YYYY-MM" format
+     */
+    std::string makeMonth();
+
+private:
+    /**
+     * @struct CategoryProfile
+     * @brief How transactions of one category look.
+     */
+    struct CategoryProfile
+    {
+        const char *name;                    /**< Category name */
+        const char *color;                   /**< Category color */
+        bool isIncome;                       /**< Whether the category holds income */
+        double weight;                       /**< Relative share of transactions */
+        double medianAmount;                 /**< Median transaction amount */
+        double spread;                       /**< Log-normal sigma of amounts */
+        std::vector<const char *> merchants; /**< Description stems, most frequent first */
+    };
+
+    std::mt19937_64 rng;                          /**< Random number generator */
+    int startYear;                                /**< First year of the span */
+    int years;                                    /**< Number of years in the span */
+    std::vector<CategoryProfile> profiles;        /**< One profile per category, in ID order */
+    std::discrete_distribution<int> categoryPick; /**< Picks a profile index by weight */
+    std::discrete_distribution<int> monthPick;    /**< Picks a calendar month with seasonality */
+
+    /**
+     * @brief Draws a skewed index in [0, count), favouring small indexes.
+     *
+     * @param count Number of choices
+     * @return The chosen index
+     */
+    size_t skewedIndex(size_t count);
+
+    /**
+     * @brief Draws a date within the span.
+     * @return Date in "YYYY-MM-DD" format
+     */
+    std::string makeDate();
+};
@@ -0,0 +1,411 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "../include/BudgetTrackerLib.h"
+#include "../include/DataManager.h"
+#include "../include/ThreadPool.h"
+#include "LedgerGenerator.h"
+
+/*
+ * Microbenchmark suite for the Budget Tracker backend.
+ *
+ * For each ledger size it builds a synthetic ledger with LedgerGenerator, then
+ * times CRUD, persistence, every DataManager analysis function and every C API
+ * read. Results are written as JSON or CSV so runs can be compared over time.
+ *
+ * Usage: budget_tracker_bench [--sizes 10000,1000000,10000000] [--seed 42]
+ *                             [--iterations 5] [--threads 0] [--format json|csv]
+ *                             [--output file] [--data-dir dir]
+ */
+
+// Keeps results observable so the optimizer cannot drop the timed calls
+static volatile double g_sink = 0.0;
+
+// Edits made before the incremental getChangesSince runs
+static const size_t kDeltaEdits = 16;
+
+/**
+ * @struct BenchOptions
+ * @brief Command line settings for a benchmark run.
+ */
+struct BenchOptions
+{
+    std::vector<size_t> sizes = {10000, 1000000, 10000000}; /**< Ledger sizes to run */
+    uint64_t seed = 42;                                      /**< Generator seed */
+    size_t iterations = 5;                                   /**< Iterations for read benchmarks */
+    size_t threads = 0;                                      /**< Analysis threads, 0 for hardware concurrency */
+    std::string format = "json";                             /**< Output format: json or csv */
+    std::string output;                                      /**< Output file, empty for stdout */
+    std::string dataDir;                                     /**< Scratch directory for ledger files */
+};
+
+/**
+ * @struct BenchResult
+ * @brief Timing summary of one benchmark at one ledger size.
+ */
+struct BenchResult
+{
+    std::string name;  /**< Benchmark name */
+    size_t rows;       /**< Ledger size */
+    size_t iterations; /**< Number of timed iterations */
+    double minMs;      /**< Fastest iteration */
+    double medianMs;   /**< Median iteration */
+    double meanMs;     /**< Mean iteration */
+    double maxMs;      /**< Slowest iteration */
+};
+
+/**
+ * @class BenchRunner
+ * @brief Times callables and collects their results.
+ */
+class BenchRunner
+{
+public:
+    /**
+     * @brief Times fn(iteration) for the given number of iterations.
+     *
+     * @param name Benchmark name
+     * @param rows Ledger size the benchmark runs against
+     * @param iterations Number of timed iterations
+     * @param fn The code to time
+     */
+    void run(const std::string &name, size_t rows, size_t iterations, const std::function<void(size_t)> &fn)
+    {
+        std::vector<double> samples;
+        samples.reserve(iterations);
+        for (size_t i = 0; i < iterations; i++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            fn(i);
+            auto end = std::chrono::steady_clock::now();
+            samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+
+        std::sort(samples.begin(), samples.end());
+        double sum = 0.0;
+        for (double sample : samples)
+        {
+            sum += sample;
+        }
+
+        BenchResult result{name, rows, iterations, samples.front(), samples[samples.size() / 2],
+                           sum / samples.size(), samples.back()};
+        results.push_back(result);
+        std::cerr << "  " << name << ": median " << result.medianMs << " ms" << std::endl;
+    }
+
+    /**
+     * @brief Gets every result collected so far.
+     * @return The results, in run order
+     */
+    const std::vector<BenchResult> &getResults() const { return results; }
+
+private:
+    std::vector<BenchResult> results; /**< Collected results */
+};
+
+static std::vector<size_t> parseSizes(const std::string &text)
+{
+    std::vector<size_t> sizes;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        if (!item.empty())
+        {
+            sizes.push_back(std::stoull(item));
+        }
+    }
+    return sizes;
+}
+
+static bool parseOptions(int argc, char **argv, BenchOptions &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+
+        std::string value = argv[++i];
+        if (arg == "--sizes")
+            options.sizes = parseSizes(value);
+        else if (arg == "--seed")
+            options.seed = std::stoull(value);
+        else if (arg == "--iterations")
+            options.iterations = std::max<size_t>(1, std::stoull(value));
+        else if (arg == "--threads")
+            options.threads = std::stoull(value);
+        else if (arg == "--format")
+            options.format = value;
+        else if (arg == "--output")
+            options.output = value;
+        else if (arg == "--data-dir")
+            options.dataDir = value;
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (options.dataDir.empty())
+    {
+        options.dataDir = (std::filesystem::temp_directory_path() / "budget_tracker_bench").string();
+    }
+    return options.format == "json" || options.format == "csv";
+}
+
+// Benchmarks the DataManager class directly
+static void runDataManagerBenchmarks(BenchRunner &runner, const BenchOptions &options, size_t rows, const std::string &dir)
+{
+    LedgerGenerator generator(options.seed);
+    auto categories = generator.makeCategories();
+    auto budgets = generator.makeBudgets();
+    auto transactions = generator.makeTransactions(rows);
+
+    // Precomputed arguments keep every run identical
+    std::vector<std::string> months;
+    std::vector<Transaction> extra = generator.makeTransactions(64);
+    for (size_t i = 0; i < std::max<size_t>(options.iterations, 64); i++)
+    {
+        months.push_back(generator.makeMonth());
+    }
+
+    // Single-row writes rewrite the whole file, so keep them few on big ledgers
+    size_t writeIterations = rows <= 100000 ? 20 : 3;
+
+    DataManager dm(dir);
+    for (auto &category : categories)
+    {
+        dm.addCategory(category);
+    }
+
+    dm.beginBatch();
+    for (auto &budget : budgets)
+    {
+        dm.addBudget(budget);
+    }
+    dm.commitBatch();
+
+    runner.run("DataManager::addTransactionsBatch", rows, 1, [&](size_t)
+               { g_sink = dm.addTransactionsBatch(transactions); });
+
+    std::vector<int> addedIds;
+    runner.run("DataManager::addTransaction", rows, writeIterations, [&](size_t i)
+               {
+        Transaction transaction = extra[i % extra.size()];
+        dm.addTransaction(transaction);
+        addedIds.push_back(transaction.getId()); });
+
+    runner.run("DataManager::updateTransaction", rows, writeIterations, [&](size_t i)
+               {
+        Transaction transaction = extra[(i + 1) % extra.size()];
+        transaction.setId(addedIds[i % addedIds.size()]);
+        g_sink = dm.updateTransaction(transaction); });
+
+    runner.run("DataManager::deleteTransaction", rows, writeIterations, [&](size_t i)
+               { g_sink = dm.deleteTransaction(addedIds[i]); });
+
+    runner.run("DataManager::getTransactionById", rows, options.iterations, [&](size_t i)
+               { g_sink = dm.getTransactionById(transactions[(i * 7919) % rows].getId()) != nullptr; });
+
+    runner.run("DataManager::saveAllData", rows, writeIterations, [&](size_t)
+               { g_sink = dm.saveAllData(); });
+
+    runner.run("DataManager::loadAllData", rows, writeIterations, [&](size_t)
+               { g_sink = dm.loadAllData(); });
+
+    runner.run("DataManager::getAllTransactions", rows, options.iterations, [&](size_t)
+               { g_sink = dm.getAllTransactions().size(); });
+
+    runner.run("DataManager::getAllCategories", rows, options.iterations, [&](size_t)
+               { g_sink = dm.getAllCategories().size(); });
+
+    runner.run("DataManager::getAllBudgets", rows, options.iterations, [&](size_t)
+               { g_sink = dm.getAllBudgets().size(); });
+
+    runner.run("DataManager::getTransactionsByMonth", rows, options.iterations, [&](size_t i)
+               { g_sink = dm.getTransactionsByMonth(months[i]).size(); });
+
+    runner.run("DataManager::getTransactionsByCategory", rows, options.iterations, [&](size_t i)
+               { g_sink = dm.getTransactionsByCategory(static_cast<int>(i % categories.size()) + 1).size(); });
+
+    runner.run("DataManager::getBudgetsByMonth", rows, options.iterations, [&](size_t i)
+               { g_sink = dm.getBudgetsByMonth(months[i]).size(); });
+
+    runner.run("DataManager::getTotalIncome", rows, options.iterations, [&](size_t i)
+               { g_sink = dm.getTotalIncome(months[i]); });
+
+    runner.run("DataManager::getTotalExpense", rows, options.iterations, [&](size_t i)
+               { g_sink = dm.getTotalExpense(months[i]); });
+
+    runner.run("DataManager::getCategoryTotal", rows, options.iterations, [&](size_t i)
+               { g_sink = dm.getCategoryTotal(static_cast<int>(i % categories.size()) + 1, months[i]); });
+
+    runner.run("DataManager::getCategoryTotals", rows, options.iterations, [&](size_t i)
+               { g_sink = dm.getCategoryTotals(months[i]).size(); });
+
+    runner.run("DataManager::getMonthlyTotals", rows, options.iterations, [&](size_t i)
+               { g_sink = dm.getMonthlyTotals(i % 2 == 0).size(); });
+
+    // loadAllData() reset the change log, so the previous version is answered with a full resync
+    runner.run("DataManager::getChangesSince resync", rows, options.iterations, [&](size_t)
+               { g_sink = dm.getChangesSince(dm.getDataVersion() - 1).version; });
+
+    // What a client that is already in sync fetches after a few edits
+    unsigned long long syncedVersion = dm.getDataVersion();
+    std::vector<Transaction> edits(transactions.begin(), transactions.begin() + std::min<size_t>(kDeltaEdits, rows));
+    for (auto &transaction : edits)
+    {
+        transaction.setAmount(transaction.getAmount() + 1.0);
+    }
+    dm.updateTransactionsBatch(edits);
+    runner.run("DataManager::getChangesSince", rows, options.iterations, [&](size_t)
+               { g_sink = dm.getChangesSince(syncedVersion).updatedTransactions.size(); });
+}
+
+// Benchmarks the C API reads against the files written by the DataManager run
+static void runCApiBenchmarks(BenchRunner &runner, const BenchOptions &options, size_t rows, const std::string &dir)
+{
+    LedgerGenerator generator(options.seed + 1);
+    std::vector<std::string> months;
+    for (size_t i = 0; i < options.iterations; i++)
+    {
+        months.push_back(generator.makeMonth());
+    }
+
+    void *manager = nullptr;
+    runner.run("CreateDataManager", rows, 1, [&](size_t)
+               { manager = CreateDataManager(dir.c_str()); });
+    if (manager == nullptr)
+    {
+        std::cerr << "Failed to open " << dir << std::endl;
+        return;
+    }
+
+    runner.run("GetAllTransactions", rows, options.iterations, [&](size_t)
+               { g_sink = std::char_traits<char>::length(GetAllTransactions(manager)); });
+
+    runner.run("GetTransactionsByMonth", rows, options.iterations, [&](size_t i)
+               { g_sink = std::char_traits<char>::length(GetTransactionsByMonth(manager, months[i].c_str())); });
+
+    runner.run("GetAllCategories", rows, options.iterations, [&](size_t)
+               { g_sink = std::char_traits<char>::length(GetAllCategories(manager)); });
+
+    runner.run("GetAllBudgets", rows, options.iterations, [&](size_t)
+               { g_sink = std::char_traits<char>::length(GetAllBudgets(manager)); });
+
+    runner.run("GetTotalIncome", rows, options.iterations, [&](size_t i)
+               { g_sink = GetTotalIncome(manager, months[i].c_str()); });
+
+    runner.run("GetTotalExpense", rows, options.iterations, [&](size_t i)
+               { g_sink = GetTotalExpense(manager, months[i].c_str()); });
+
+    runner.run("GetCategoryTotals", rows, options.iterations, [&](size_t i)
+               { g_sink = std::char_traits<char>::length(GetCategoryTotals(manager, months[i].c_str())); });
+
+    // A delta of a few edits, as a client already in sync would fetch
+    unsigned long long syncedVersion = GetDataVersion(manager);
+    BeginBatch(manager);
+    for (size_t i = 0; i < kDeltaEdits; i++)
+    {
+        Transaction transaction = generator.makeTransaction();
+        AddTransaction(manager, transaction.getDate().c_str(), transaction.getAmount(), transaction.getDescription().c_str(),
+                       transaction.getCategoryId(), transaction.getIsIncome());
+    }
+    CommitBatch(manager);
+    runner.run("GetChangesSince", rows, options.iterations, [&](size_t)
+               { g_sink = std::char_traits<char>::length(GetChangesSince(manager, syncedVersion)); });
+
+    DestroyDataManager(manager);
+}
+
+static void writeResults(std::ostream &out, const BenchOptions &options, const std::vector<BenchResult> &results)
+{
+    if (options.format == "csv")
+    {
+        out << "name,rows,iterations,min_ms,median_ms,mean_ms,max_ms\n";
+        for (const auto &result : results)
+        {
+            out << result.name << "," << result.rows << "," << result.iterations << ","
+                << result.minMs << "," << result.medianMs << "," << result.meanMs << "," << result.maxMs << "\n";
+        }
+        return;
+    }
+
+    nlohmann::json document;
+    document["meta"] = {
+        {"seed", options.seed},
+        {"threads", ThreadPool::shared().getThreadCount()},
+        {"timestamp", static_cast<long long>(std::time(nullptr))}};
+    document["results"] = nlohmann::json::array();
+    for (const auto &result : results)
+    {
+        document["results"].push_back({{"name", result.name},
+                                       {"rows", result.rows},
+                                       {"iterations", result.iterations},
+                                       {"min_ms", result.minMs},
+                                       {"median_ms", result.medianMs},
+                                       {"mean_ms", result.meanMs},
+                                       {"max_ms", result.maxMs}});
+    }
+    out << document.dump(2) << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "Usage: budget_tracker_bench [--sizes 10000,1000000,10000000] [--seed 42] "
+                     "[--iterations 5] [--threads 0] [--format json|csv] [--output file] [--data-dir dir]"
+                  << std::endl;
+        return 1;
+    }
+
+    if (options.threads != 0)
+    {
+        ThreadPool::shared().setThreadCount(options.threads);
+    }
+
+    BenchRunner runner;
+    for (size_t rows : options.sizes)
+    {
+        std::string dir = (std::filesystem::path(options.dataDir) / ("rows_" + std::to_string(rows))).string();
+        std::filesystem::remove_all(dir);
+
+        std::cerr << "Ledger with " << rows << " transactions" << std::endl;
+        runDataManagerBenchmarks(runner, options, rows, dir);
+        runCApiBenchmarks(runner, options, rows, dir);
+        std::filesystem::remove_all(dir);
+    }
+
+    if (options.output.empty())
+    {
+        writeResults(std::cout, options, runner.getResults());
+    }
+    else
+    {
+        std::ofstream file(options.output);
+        if (!file.is_open())
+        {
+            std::cerr << "Failed to open " << options.output << std::endl;
+            return 1;
+        }
+        writeResults(file, options, runner.getResults());
+    }
+    return 0;
+}
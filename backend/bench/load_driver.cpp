@@ -0,0 +1,355 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/BudgetTrackerLib.h"
+#include "../include/LatencyHistogram.h"
+#include "LedgerGenerator.h"
+
+/*
+ * Mixed-workload load generator for the Budget Tracker C API.
+ *
+ * N threads share one DataManager handle and replay a weighted mix of C API
+ * operations, optionally at a fixed total rate. Latency is measured per
+ * operation; in rate-limited mode it is measured from each operation's
+ * scheduled start, so queueing behind slow calls shows up in the tail.
+ *
+ * Usage: budget_tracker_load [--threads 8] [--duration 10] [--rate 0]
+ *                            [--rows 100000] [--seed 42]
+ *                            [--mix month=60,totals=30,add=10]
+ *                            [--format text|json] [--output file] [--data-dir dir]
+ *
+ * Operations: month (GetTransactionsByMonth), totals (GetCategoryTotals),
+ * income (GetTotalIncome), expense (GetTotalExpense), all (GetAllTransactions),
+ * changes (GetChangesSince), add (AddTransaction), update (UpdateTransaction).
+ */
+
+/**
+ * @struct LoadOptions
+ * @brief Command line settings for a load run.
+ */
+struct LoadOptions
+{
+    size_t threads = 8;                                  /**< Client threads */
+    double duration = 10.0;                              /**< Run time in seconds */
+    double rate = 0.0;                                   /**< Total target operations per second, 0 for closed loop */
+    size_t rows = 100000;                                /**< Initial ledger size */
+    uint64_t seed = 42;                                  /**< Generator seed */
+    std::string mix = "month=60,totals=30,add=10";       /**< Operation weights */
+    std::string format = "text";                         /**< Output format: text or json */
+    std::string output;                                  /**< Output file, empty for stdout */
+    std::string dataDir;                                 /**< Ledger directory */
+};
+
+static const std::vector<std::string> kOperations = {"month", "totals", "income", "expense", "all", "changes", "add", "update"};
+
+static bool parseMix(const std::string &text, std::vector<double> &weights)
+{
+    weights.assign(kOperations.size(), 0.0);
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        size_t equals = item.find('=');
+        if (equals == std::string::npos)
+        {
+            return false;
+        }
+
+        auto op = std::find(kOperations.begin(), kOperations.end(), item.substr(0, equals));
+        if (op == kOperations.end())
+        {
+            std::cerr << "Unknown operation " << item.substr(0, equals) << std::endl;
+            return false;
+        }
+        weights[op - kOperations.begin()] = std::stod(item.substr(equals + 1));
+    }
+    return std::any_of(weights.begin(), weights.end(), [](double w)
+                       { return w > 0.0; });
+}
+
+static bool parseOptions(int argc, char **argv, LoadOptions &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+
+        std::string value = argv[++i];
+        if (arg == "--threads")
+            options.threads = std::max<size_t>(1, std::stoull(value));
+        else if (arg == "--duration")
+            options.duration = std::stod(value);
+        else if (arg == "--rate")
+            options.rate = std::stod(value);
+        else if (arg == "--rows")
+            options.rows = std::stoull(value);
+        else if (arg == "--seed")
+            options.seed = std::stoull(value);
+        else if (arg == "--mix")
+            options.mix = value;
+        else if (arg == "--format")
+            options.format = value;
+        else if (arg == "--output")
+            options.output = value;
+        else if (arg == "--data-dir")
+            options.dataDir = value;
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (options.dataDir.empty())
+    {
+        options.dataDir = (std::filesystem::temp_directory_path() / "budget_tracker_load").string();
+    }
+    return options.format == "text" || options.format == "json";
+}
+
+// Fills the ledger through the batch API in bounded chunks
+static void populate(void *manager, const LoadOptions &options)
+{
+    LedgerGenerator generator(options.seed);
+    for (const auto &category : generator.makeCategories())
+    {
+        AddCategory(manager, category.getName().c_str(), category.getDescription().c_str(), category.getColor().c_str());
+    }
+
+    const size_t chunk = 100000;
+    for (size_t done = 0; done < options.rows; done += chunk)
+    {
+        auto transactions = generator.makeTransactions(std::min(chunk, options.rows - done));
+
+        std::vector<std::string> dates, descriptions;
+        std::vector<const char *> datePtrs, descriptionPtrs;
+        std::vector<double> amounts;
+        std::vector<int> categoryIds;
+        std::unique_ptr<bool[]> isIncome(new bool[transactions.size()]);
+        for (size_t i = 0; i < transactions.size(); i++)
+        {
+            dates.push_back(transactions[i].getDate());
+            descriptions.push_back(transactions[i].getDescription());
+            amounts.push_back(transactions[i].getAmount());
+            categoryIds.push_back(transactions[i].getCategoryId());
+            isIncome[i] = transactions[i].getIsIncome();
+        }
+        for (size_t i = 0; i < transactions.size(); i++)
+        {
+            datePtrs.push_back(dates[i].c_str());
+            descriptionPtrs.push_back(descriptions[i].c_str());
+        }
+
+        AddTransactionsBatch(manager, static_cast<int>(transactions.size()), datePtrs.data(), amounts.data(),
+                             descriptionPtrs.data(), categoryIds.data(), isIncome.get(), nullptr);
+    }
+}
+
+// Runs one operation and returns whether it succeeded
+static bool runOperation(void *manager, size_t op, LedgerGenerator &generator, std::mt19937_64 &rng, int maxId)
+{
+    const std::string &name = kOperations[op];
+    if (name == "month")
+    {
+        return GetTransactionsByMonth(manager, generator.makeMonth().c_str()) != nullptr;
+    }
+    if (name == "totals")
+    {
+        return GetCategoryTotals(manager, generator.makeMonth().c_str()) != nullptr;
+    }
+    if (name == "income")
+    {
+        return GetTotalIncome(manager, generator.makeMonth().c_str()) >= 0.0;
+    }
+    if (name == "expense")
+    {
+        return GetTotalExpense(manager, generator.makeMonth().c_str()) >= 0.0;
+    }
+    if (name == "all")
+    {
+        return GetAllTransactions(manager) != nullptr;
+    }
+    if (name == "changes")
+    {
+        unsigned long long version = GetDataVersion(manager);
+        return GetChangesSince(manager, version > 10 ? version - 10 : 0) != nullptr;
+    }
+
+    Transaction transaction = generator.makeTransaction();
+    if (name == "add")
+    {
+        return AddTransaction(manager, transaction.getDate().c_str(), transaction.getAmount(),
+                              transaction.getDescription().c_str(), transaction.getCategoryId(),
+                              transaction.getIsIncome()) >= 0;
+    }
+
+    int id = std::uniform_int_distribution<int>(1, std::max(1, maxId))(rng);
+    return UpdateTransaction(manager, id, transaction.getDate().c_str(), transaction.getAmount(),
+                             transaction.getDescription().c_str(), transaction.getCategoryId(),
+                             transaction.getIsIncome());
+}
+
+int main(int argc, char **argv)
+{
+    LoadOptions options;
+    std::vector<double> weights;
+    if (!parseOptions(argc, argv, options) || !parseMix(options.mix, weights))
+    {
+        std::cerr << "Usage: budget_tracker_load [--threads 8] [--duration 10] [--rate 0] [--rows 100000] "
+                     "[--seed 42] [--mix month=60,totals=30,add=10] [--format text|json] [--output file] "
+                     "[--data-dir dir]"
+                  << std::endl;
+        return 1;
+    }
+
+    std::filesystem::remove_all(options.dataDir);
+    void *manager = CreateDataManager(options.dataDir.c_str());
+    if (manager == nullptr)
+    {
+        std::cerr << "Failed to open " << options.dataDir << std::endl;
+        return 1;
+    }
+
+    std::cerr << "Populating " << options.rows << " transactions..." << std::endl;
+    populate(manager, options);
+
+    size_t opCount = kOperations.size();
+    std::vector<std::vector<LatencyHistogram>> histograms(options.threads, std::vector<LatencyHistogram>(opCount));
+    std::vector<std::vector<uint64_t>> failures(options.threads, std::vector<uint64_t>(opCount, 0));
+
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    auto end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.duration));
+
+    std::cerr << "Running for " << options.duration << " s on " << options.threads << " threads..." << std::endl;
+    std::vector<std::thread> clients;
+    for (size_t t = 0; t < options.threads; t++)
+    {
+        clients.emplace_back([&, t]()
+                             {
+            LedgerGenerator generator(options.seed + 1000 + t);
+            std::mt19937_64 rng(options.seed + t);
+            std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+
+            // In open-loop mode each thread issues its share of the total rate on a fixed schedule
+            Clock::duration interval = Clock::duration::zero();
+            if (options.rate > 0.0)
+            {
+                interval = std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double>(options.threads / options.rate));
+            }
+            Clock::time_point scheduled = start + interval * static_cast<long>(t) / static_cast<long>(options.threads);
+
+            while (true)
+            {
+                if (interval != Clock::duration::zero())
+                {
+                    std::this_thread::sleep_until(scheduled);
+                }
+
+                auto opStart = interval != Clock::duration::zero() ? scheduled : Clock::now();
+                if (opStart >= end)
+                {
+                    break;
+                }
+
+                size_t op = pick(rng);
+                bool success = runOperation(manager, op, generator, rng, static_cast<int>(options.rows));
+                auto opEnd = Clock::now();
+
+                histograms[t][op].record(std::chrono::duration_cast<std::chrono::nanoseconds>(opEnd - opStart).count());
+                if (!success)
+                {
+                    failures[t][op]++;
+                }
+                scheduled += interval;
+            } });
+    }
+    for (auto &client : clients)
+    {
+        client.join();
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    DestroyDataManager(manager);
+
+    // Merge the per-thread histograms
+    std::vector<LatencyHistogram> merged(opCount);
+    std::vector<uint64_t> failed(opCount, 0);
+    for (size_t t = 0; t < options.threads; t++)
+    {
+        for (size_t op = 0; op < opCount; op++)
+        {
+            merged[op].merge(histograms[t][op]);
+            failed[op] += failures[t][op];
+        }
+    }
+
+    std::ostringstream out;
+    if (options.format == "json")
+    {
+        out << "{\"threads\":" << options.threads << ",\"rows\":" << options.rows
+            << ",\"rate\":" << options.rate << ",\"elapsed_s\":" << elapsed << ",\"operations\":[";
+        bool first = true;
+        for (size_t op = 0; op < opCount; op++)
+        {
+            const LatencyHistogram &h = merged[op];
+            if (h.getCount() == 0)
+            {
+                continue;
+            }
+            out << (first ? "" : ",") << "{\"name\":\"" << kOperations[op] << "\",\"count\":" << h.getCount()
+                << ",\"failed\":" << failed[op] << ",\"throughput\":" << h.getCount() / elapsed
+                << ",\"mean_ms\":" << h.getMean() / 1e6 << ",\"p50_ms\":" << h.getPercentile(50) / 1e6
+                << ",\"p99_ms\":" << h.getPercentile(99) / 1e6 << ",\"p999_ms\":" << h.getPercentile(99.9) / 1e6
+                << ",\"max_ms\":" << h.getMax() / 1e6 << "}";
+            first = false;
+        }
+        out << "]}\n";
+    }
+    else
+    {
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-8s %10s %8s %10s %10s %10s %10s %10s\n",
+                      "op", "count", "failed", "ops/s", "p50 ms", "p99 ms", "p999 ms", "max ms");
+        out << line;
+        for (size_t op = 0; op < opCount; op++)
+        {
+            const LatencyHistogram &h = merged[op];
+            if (h.getCount() == 0)
+            {
+                continue;
+            }
+            std::snprintf(line, sizeof(line), "%-8s %10llu %8llu %10.1f %10.3f %10.3f %10.3f %10.3f\n",
+                          kOperations[op].c_str(), static_cast<unsigned long long>(h.getCount()),
+                          static_cast<unsigned long long>(failed[op]), h.getCount() / elapsed,
+                          h.getPercentile(50) / 1e6, h.getPercentile(99) / 1e6,
+                          h.getPercentile(99.9) / 1e6, h.getMax() / 1e6);
+            out << line;
+        }
+    }
+
+    if (options.output.empty())
+    {
+        std::cout << out.str();
+    }
+    else
+    {
+        std::ofstream file(options.output);
+        file << out.str();
+    }
+    return 0;
+}
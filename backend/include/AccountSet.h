@@ -0,0 +1,239 @@
+/**
+ * @file AccountSet.h
+ * @brief Defines the AccountSet class that keeps each account in its own DataManager shard.
+ */
+#pragma once
+#include <functional>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+#include "DataManager.h"
+
+/**
+ * @struct Account
+ * @brief One account of an AccountSet.
+ */
+struct Account
+{
+    int id;           /**< Account ID, never reused within the set */
+    std::string name; /**< Display name, e.g. "Checking" */
+};
+
+/**
+ * @struct AccountSummary
+ * @brief Income and expense of one account, as merged by AccountSet::getAccountSummaries().
+ */
+struct AccountSummary
+{
+    int accountId;            /**< Account ID */
+    std::string name;         /**< Account name */
+    std::string baseCurrency; /**< The shard's base currency; empty if none was set */
+    double income;            /**< Total income in the shard's base currency */
+    double expense;           /**< Total expense in the shard's base currency */
+};
+
+/**
+ * @class AccountSet
+ * @brief A directory of accounts, each persisted as a separate DataManager shard.
+ *
+ * The root directory holds an accounts.json manifest and one subdirectory per
+ * account, "account-<id>", with the usual transactions, categories, budgets
+ * and rates files. Shards are opened in parallel, and changing one account
+ * only rewrites that account's files.
+ *
+ * The analysis methods run the matching DataManager method on every shard in
+ * parallel on the shared ThreadPool and merge the partial results in account
+ * order, so results do not depend on scheduling. Each shard keeps its own
+ * categories, so category totals are merged by category name.
+ *
+ * Each shard also keeps its own exchange rates and reports in its own base
+ * currency. Totals across accounts are only added up when every shard has the
+ * same base currency; setBaseCurrency() sets it on all of them, and new
+ * accounts take the set's current one.
+ */
+class AccountSet
+{
+public:
+    /**
+     * @brief Opens the accounts under a root directory, creating it if needed.
+     *
+     * @param rootPath Path to the directory holding the manifest and the account directories
+     * @throws std::runtime_error if accounts.json exists but cannot be read, so it is never overwritten
+     */
+    explicit AccountSet(const std::string &rootPath);
+
+    /**
+     * @brief Adds an account with an empty shard, in the base currency the other accounts share.
+     *
+     * @param name Account name
+     * @return The new account's ID, or -1 if the manifest could not be saved
+     */
+    int addAccount(const std::string &name);
+
+    /**
+     * @brief Renames an account.
+     *
+     * @param accountId Account ID
+     * @param name New name
+     * @return true if the account exists and the manifest was saved
+     */
+    bool renameAccount(int accountId, const std::string &name);
+
+    /**
+     * @brief Removes an account from the set and closes its shard.
+     *
+     * The account's files stay on disk, so a removed account can be recovered
+     * by hand. Pointers returned by getAccount() for it become invalid.
+     *
+     * @param accountId Account ID
+     * @return true if the account existed and the manifest was saved
+     */
+    bool removeAccount(int accountId);
+
+    /**
+     * @brief Removes an account from the set and hands its shard to the caller.
+     *
+     * The account's files stay on disk. whileLocked runs only once the
+     * manifest no longer lists the account, under the set's exclusive lock, so
+     * no getAccount() can interleave with it; the caller may then finish work
+     * on the shard before releasing it.
+     *
+     * @param accountId Account ID
+     * @param whileLocked Called with the shard after the manifest was saved, or empty
+     * @return The shard, or nullptr if the account does not exist or the manifest could not be saved
+     */
+    std::unique_ptr<DataManager> detachAccount(int accountId, const std::function<void(DataManager *)> &whileLocked = nullptr);
+
+    /**
+     * @brief Lists the accounts.
+     *
+     * @return The accounts, in the order they were added
+     */
+    std::vector<Account> getAccounts() const;
+
+    /**
+     * @brief Gets the shard of an account, for reading and changing its data.
+     *
+     * @param accountId Account ID
+     * @param whileLocked Called with the shard while the set still holds its lock, so a removal cannot interleave; or empty
+     * @return The shard, owned by the set and valid until the account is removed; nullptr if not found
+     */
+    DataManager *getAccount(int accountId, const std::function<void(DataManager *)> &whileLocked = nullptr) const;
+
+    /**
+     * @brief Sets the base currency of every account.
+     *
+     * @param currency The currency code, e.g. "USD"
+     * @return true if every shard saved the setting
+     */
+    bool setBaseCurrency(const std::string &currency);
+
+    /**
+     * @brief Gets the base currency the accounts share.
+     *
+     * @param currency Receives the shared code; empty if none was set or there are no accounts
+     * @return false if the accounts have different base currencies
+     */
+    bool getBaseCurrency(std::string &currency) const;
+
+    /**
+     * @brief Calculates total income across all accounts.
+     *
+     * @param monthYear Month and year in "YYYY-MM" format, or empty for all time
+     * @param total Receives the sum of every shard's DataManager::getTotalIncome()
+     * @return false if the accounts have different base currencies
+     */
+    bool getTotalIncome(const std::string &monthYear, double &total) const;
+
+    /**
+     * @brief Calculates total expense across all accounts.
+     *
+     * @param monthYear Month and year in "YYYY-MM" format, or empty for all time
+     * @param total Receives the sum of every shard's DataManager::getTotalExpense()
+     * @return false if the accounts have different base currencies
+     */
+    bool getTotalExpense(const std::string &monthYear, double &total) const;
+
+    /**
+     * @brief Calculates net totals per category name across all accounts.
+     *
+     * Transactions whose category does not exist in their shard are counted
+     * under the empty name.
+     *
+     * @param monthYear Month and year in "YYYY-MM" format, or empty for all time
+     * @param totals Receives category name to net amount (income positive, expense negative)
+     * @return false if the accounts have different base currencies
+     */
+    bool getCategoryTotals(const std::string &monthYear, std::map<std::string, double> &totals) const;
+
+    /**
+     * @brief Calculates monthly income or expense totals across all accounts.
+     *
+     * @param isIncome true for income, false for expense
+     * @param totals Receives "YYYY-MM" to the sum of every shard's total for that month
+     * @return false if the accounts have different base currencies
+     */
+    bool getMonthlyTotals(bool isIncome, std::map<std::string, double> &totals) const;
+
+    /**
+     * @brief Calculates income and expense of each account, each in its own base currency.
+     *
+     * @param monthYear Month and year in "YYYY-MM" format, or empty for all time
+     * @return One summary per account, in account order
+     */
+    std::vector<AccountSummary> getAccountSummaries(const std::string &monthYear) const;
+
+private:
+    /**
+     * @struct Shard
+     * @brief An account and its open DataManager.
+     */
+    struct Shard
+    {
+        Account account;                      /**< The account */
+        std::unique_ptr<DataManager> manager; /**< Its data */
+    };
+
+    std::string rootPath;            /**< Directory holding the manifest and account directories */
+    std::vector<Shard> shards;       /**< Open accounts, in manifest order */
+    int nextAccountId;               /**< ID for the next added account */
+    mutable std::shared_mutex mutex; /**< Guards shards and nextAccountId; shards lock their own data */
+
+    /**
+     * @brief Gets the path of the manifest.
+     * @return rootPath + "/accounts.json"
+     */
+    std::string getManifestPath() const;
+
+    /**
+     * @brief Gets the directory of an account's shard.
+     * @param accountId Account ID
+     * @return rootPath + "/account-<id>"
+     */
+    std::string getAccountPath(int accountId) const;
+
+    /**
+     * @brief Checks that every shard reports in the same base currency. Caller holds the lock.
+     *
+     * @param currency Receives the shared code
+     * @return false, after logging the mismatch, if two shards differ
+     */
+    bool sharedBaseCurrency(std::string &currency) const;
+
+    /**
+     * @brief Writes the manifest through a temporary file. Caller holds the exclusive lock.
+     * @return true if saved
+     */
+    bool saveManifest() const;
+
+    /**
+     * @brief Runs a function on every shard in parallel. Caller holds the shared lock.
+     *
+     * @param compute Called once per shard with its DataManager
+     * @return The results, in account order
+     */
+    template <typename Partial, typename Compute>
+    std::vector<Partial> fanOut(Compute compute) const;
+};
@@ -0,0 +1,65 @@
+/**
+ * @file AsyncExecutor.h
+ * @brief Defines the AsyncExecutor class used by the asynchronous C API.
+ */
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * @class AsyncExecutor
+ * @brief Runs queued tasks one at a time, in submission order, on a background thread.
+ *
+ * Each DataManager handle used through the asynchronous C API gets its own
+ * executor, which is what guarantees per-handle ordering of async operations.
+ */
+class AsyncExecutor
+{
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Constructs an executor and starts its background thread.
+     */
+    AsyncExecutor();
+
+    /**
+     * @brief Runs every task still queued, then joins the background thread.
+     */
+    ~AsyncExecutor();
+
+    AsyncExecutor(const AsyncExecutor &) = delete;
+    AsyncExecutor &operator=(const AsyncExecutor &) = delete;
+
+    /**
+     * @brief Queues a task behind every task posted before it.
+     *
+     * @param task The task to run
+     * @return true if the task was queued, false if the executor is shutting down
+     */
+    bool post(Task task);
+
+    /**
+     * @brief Blocks until every queued task has finished.
+     *
+     * Must not be called from inside a task on the same executor.
+     */
+    void waitIdle();
+
+private:
+    std::deque<Task> tasks;         /**< Tasks waiting to run */
+    std::mutex mutex;               /**< Guards tasks, busy and stopping */
+    std::condition_variable wakeup; /**< Signalled when a task is queued or on shutdown */
+    std::condition_variable idle;   /**< Signalled when the queue drains */
+    bool busy;                      /**< Whether a task is currently running */
+    bool stopping;                  /**< Set when the executor is shutting down */
+    std::thread thread;             /**< The background thread */
+
+    /**
+     * @brief Main loop of the background thread.
+     */
+    void run();
+};
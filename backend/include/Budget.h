@@ -4,6 +4,7 @@
  */
 #pragma once
 #include <string>
+#include "BudgetTrackerExport.h"
 
 /**
  * @class Budget
@@ -12,7 +13,7 @@
  * The Budget class manages financial allocations for categories within specific
  * month/year periods. This allows for tracking planned spending against actual expenses.
  */
-class Budget
+class BUDGETTRACKER_API Budget
 {
 private:
     int categoryId;         /**< Identifier for the associated category */
@@ -77,4 +78,10 @@ public:
      * @return A string representation for debugging purposes
      */
     std::string toString() const;
+
+    /**
+     * @brief Gets the heap memory owned by this Budget's strings.
+     * @return Bytes allocated outside the object for string contents
+     */
+    size_t getHeapSize() const;
 };
\ No newline at end of file
@@ -0,0 +1,20 @@
+/**
+ * @file BudgetTrackerExport.h
+ * @brief Defines the BUDGETTRACKER_API macro that exports symbols from the shared library.
+ *
+ * The C API and the model classes the benchmark drivers link against are
+ * marked with it. Targets that compile the sources directly instead of
+ * linking the library define BUDGETTRACKER_STATIC.
+ */
+#pragma once
+
+// Define platform-specific export/import macros
+#if defined(_WIN32) && !defined(BUDGETTRACKER_STATIC)
+#ifdef BUDGETTRACKERLIB_EXPORTS
+#define BUDGETTRACKER_API __declspec(dllexport)
+#else
+#define BUDGETTRACKER_API __declspec(dllimport)
+#endif
+#else
+#define BUDGETTRACKER_API
+#endif
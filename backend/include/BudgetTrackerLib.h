@@ -6,21 +6,15 @@
  * client applications to interact with the budget tracking functionality through
  * a stable ABI. This API supports operations for categories, transactions, budgets,
  * and financial analysis.
+ *
+ * Functions taking a manager may be called from several threads at once on the
+ * same handle. Returned strings live in a per-thread buffer that is valid until
+ * the next call on the same thread.
  */
 #pragma once
 
-// Define platform-specific export/import macros
-#ifdef _WIN32
-#ifdef BUDGETTRACKERLIB_EXPORTS
-#define BUDGETTRACKER_API __declspec(dllexport)
-#else
-#define BUDGETTRACKER_API __declspec(dllimport)
-#endif
-#else
-#define BUDGETTRACKER_API
-#endif
-
 #include <stdbool.h>
+#include "BudgetTrackerExport.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -38,10 +32,162 @@ extern "C"
     /**
      * @brief Destroys a DataManager instance.
      *
+     * Asynchronous operations already queued on the handle finish first; new
+     * ones are rejected from the moment the call starts.
+     *
      * @param manager Pointer to the DataManager instance to destroy
      */
     BUDGETTRACKER_API void DestroyDataManager(void *manager);
 
+    /**
+     * @brief Opens a set of accounts, each stored as a separate DataManager shard.
+     *
+     * The root directory holds an accounts.json manifest and one subdirectory
+     * per account. Shards are opened in parallel.
+     *
+     * @param rootPath Path to the directory where the accounts are stored
+     * @return Pointer to the created AccountSet, or NULL if creation fails, e.g. when accounts.json is corrupt
+     */
+    BUDGETTRACKER_API void *CreateAccountSet(const char *rootPath);
+
+    /**
+     * @brief Destroys an AccountSet and every shard handle obtained from it.
+     *
+     * Waits for queued asynchronous operations on the shards first.
+     *
+     * @param accountSet Pointer to the AccountSet instance to destroy
+     */
+    BUDGETTRACKER_API void DestroyAccountSet(void *accountSet);
+
+    /**
+     * @brief Adds an account with no data.
+     *
+     * @param accountSet Pointer to the AccountSet instance
+     * @param name Account name, e.g. "Checking"
+     * @return ID of the new account, or -1 if it could not be saved
+     */
+    BUDGETTRACKER_API int AddAccount(void *accountSet, const char *name);
+
+    /**
+     * @brief Renames an account.
+     *
+     * @param accountSet Pointer to the AccountSet instance
+     * @param accountId ID of the account
+     * @param name New name
+     * @return true if the account exists and the change was saved, false otherwise
+     */
+    BUDGETTRACKER_API bool RenameAccount(void *accountSet, int accountId, const char *name);
+
+    /**
+     * @brief Removes an account from the set, leaving its files on disk.
+     *
+     * Waits for queued asynchronous operations on the account's handle, which
+     * becomes invalid.
+     *
+     * @param accountSet Pointer to the AccountSet instance
+     * @param accountId ID of the account
+     * @return true if the account existed and the change was saved, false otherwise
+     */
+    BUDGETTRACKER_API bool RemoveAccount(void *accountSet, int accountId);
+
+    /**
+     * @brief Gets all accounts.
+     *
+     * @param accountSet Pointer to the AccountSet instance
+     * @return JSON array of {"id","name"} in the order the accounts were added, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *GetAccounts(void *accountSet);
+
+    /**
+     * @brief Gets the DataManager handle of one account.
+     *
+     * The handle works with every function taking a manager, including the
+     * asynchronous ones. It is owned by the set: do not pass it to
+     * DestroyDataManager; it stays valid until RemoveAccount or
+     * DestroyAccountSet.
+     *
+     * @param accountSet Pointer to the AccountSet instance
+     * @param accountId ID of the account
+     * @return Pointer to the account's DataManager, or NULL if not found
+     */
+    BUDGETTRACKER_API void *GetAccountManager(void *accountSet, int accountId);
+
+    /**
+     * @brief Sets the base currency of every account, as SetBaseCurrency does for one.
+     *
+     * Totals across accounts need every account to report in the same base
+     * currency; accounts added later take this one.
+     *
+     * @param accountSet Pointer to the AccountSet instance
+     * @param currency The currency code, e.g. "USD"
+     * @return true if every account saved the setting, false otherwise
+     */
+    BUDGETTRACKER_API bool SetAccountsBaseCurrency(void *accountSet, const char *currency);
+
+    /**
+     * @brief Calculates total income across all accounts, scanning the accounts in parallel.
+     *
+     * @param accountSet Pointer to the AccountSet instance
+     * @param monthYear Month and year in "YYYY-MM" format, or "" for all time
+     * @return Sum of GetTotalIncome over the accounts; NaN if they have different base currencies
+     */
+    BUDGETTRACKER_API double GetAccountsTotalIncome(void *accountSet, const char *monthYear);
+
+    /**
+     * @brief Calculates total expense across all accounts, scanning the accounts in parallel.
+     *
+     * @param accountSet Pointer to the AccountSet instance
+     * @param monthYear Month and year in "YYYY-MM" format, or "" for all time
+     * @return Sum of GetTotalExpense over the accounts; NaN if they have different base currencies
+     */
+    BUDGETTRACKER_API double GetAccountsTotalExpense(void *accountSet, const char *monthYear);
+
+    /**
+     * @brief Calculates net totals per category across all accounts.
+     *
+     * Categories belong to one account each, so totals are merged by category
+     * name; transactions without a known category count under "".
+     *
+     * @param accountSet Pointer to the AccountSet instance
+     * @param monthYear Month and year in "YYYY-MM" format, or "" for all time
+     * @return JSON object mapping category name to net amount (income positive, expense negative), empty if the accounts have different base currencies, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *GetAccountsCategoryTotals(void *accountSet, const char *monthYear);
+
+    /**
+     * @brief Calculates income or expense per month across all accounts.
+     *
+     * @param accountSet Pointer to the AccountSet instance
+     * @param isIncome true for income, false for expense
+     * @return JSON object mapping "YYYY-MM" to the total, empty if the accounts have different base currencies, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *GetAccountsMonthlyTotals(void *accountSet, bool isIncome);
+
+    /**
+     * @brief Calculates income, expense and balance of each account, each in its own base currency.
+     *
+     * @param accountSet Pointer to the AccountSet instance
+     * @param monthYear Month and year in "YYYY-MM" format, or "" for all time
+     * @return JSON array of {"accountId","name","baseCurrency","income","expense","balance"} in account order, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *GetAccountsSummary(void *accountSet, const char *monthYear);
+
+    /**
+     * @brief Sets the number of worker threads used for analysis scans.
+     *
+     * The pool is shared by every DataManager instance.
+     *
+     * @param threadCount Number of worker threads; 0 uses one per hardware thread
+     */
+    BUDGETTRACKER_API void SetAnalysisThreadCount(int threadCount);
+
+    /**
+     * @brief Gets the number of worker threads used for analysis scans.
+     *
+     * @return The number of worker threads
+     */
+    BUDGETTRACKER_API int GetAnalysisThreadCount();
+
     // Category operations
     /**
      * @brief Adds a new category.
@@ -58,7 +204,7 @@ extern "C"
      * @brief Updates an existing category.
      *
      * @param manager Pointer to the DataManager instance
-     * @param id ID of the category to update
+     * @param id ID of the category to update; its parent is kept
      * @param name New name for the category
      * @param description New description for the category
      * @param color New color code for the category
@@ -67,7 +213,17 @@ extern "C"
     BUDGETTRACKER_API bool UpdateCategory(void *manager, int id, const char *name, const char *description, const char *color);
 
     /**
-     * @brief Deletes a category.
+     * @brief Moves a category under another category, or to the top level.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param categoryId ID of the category to move
+     * @param parentId ID of the new parent, or 0 for the top level; may not be the category itself or one of its descendants
+     * @return true if the category was moved successfully, false otherwise
+     */
+    BUDGETTRACKER_API bool SetCategoryParent(void *manager, int categoryId, int parentId);
+
+    /**
+     * @brief Deletes a category; its children move up to its parent.
      *
      * @param manager Pointer to the DataManager instance
      * @param categoryId ID of the category to delete
@@ -79,7 +235,7 @@ extern "C"
      * @brief Gets all categories.
      *
      * @param manager Pointer to the DataManager instance
-     * @return JSON string containing all categories, caller does not need to free this memory
+     * @return JSON string containing all categories with their "parentId" (0 for top level), caller does not need to free this memory
      */
     BUDGETTRACKER_API const char *GetAllCategories(void *manager);
 
@@ -107,10 +263,40 @@ extern "C"
      * @param description New description for the transaction
      * @param categoryId New category ID for the transaction
      * @param isIncome New income status for the transaction
-     * @return true if the transaction was updated successfully, false otherwise
+     * @return true if the transaction was updated successfully, false otherwise; its tags and currency are kept
      */
     BUDGETTRACKER_API bool UpdateTransaction(void *manager, int id, const char *date, double amount, const char *description, int categoryId, bool isIncome);
 
+    /**
+     * @brief Replaces the tags of a transaction.
+     *
+     * Tags are trimmed and lowercased; empty and repeated tags are dropped.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param transactionId ID of the transaction
+     * @param tags JSON array of tag strings, e.g. ["travel","work"]; empty array to clear
+     * @return true if the tags were saved, false otherwise
+     */
+    BUDGETTRACKER_API bool SetTransactionTags(void *manager, int transactionId, const char *tags);
+
+    /**
+     * @brief Gets every tag in use.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @return JSON array of {"tag","count"} objects in tag order, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *GetAllTags(void *manager);
+
+    /**
+     * @brief Sets the currency of a transaction's amount.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param transactionId ID of the transaction
+     * @param currency Currency code such as "EUR", or empty for the base currency
+     * @return true if the transaction exists and was saved, false otherwise
+     */
+    BUDGETTRACKER_API bool SetTransactionCurrency(void *manager, int transactionId, const char *currency);
+
     /**
      * @brief Deletes a transaction.
      *
@@ -137,6 +323,247 @@ extern "C"
      */
     BUDGETTRACKER_API const char *GetTransactionsByMonth(void *manager, const char *monthYear);
 
+    /**
+     * @brief Searches transaction descriptions.
+     *
+     * Matching ignores case and punctuation and is served by a trigram index,
+     * so it stays fast on large ledgers. The options object may set "prefix"
+     * to true to match only at the start of a word, and may restrict results
+     * with the same "month", "categoryId", "from" and "to" keys as
+     * ExportTransactions.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param query Text to look for
+     * @param limit Maximum number of results; 0 or less for no limit
+     * @param options JSON options object, or NULL or empty for a plain substring search
+     * @return JSON string containing matching transactions, newest ID first, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *SearchTransactions(void *manager, const char *query, int limit, const char *options);
+
+    /**
+     * @brief Suggests descriptions and category names completing what the user typed.
+     *
+     * Suggestions are ranked by how often they are used, with recent use
+     * counting more, and come from a prefix tree kept up to date as data
+     * changes. Each entry has "text", "kind" ("description" or "category"),
+     * "categoryId" (for descriptions, the category last used with it) and
+     * "count".
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param prefix Text typed so far; case and leading spaces are ignored
+     * @param k Maximum number of suggestions
+     * @return JSON string containing the suggestions, best first, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *SuggestDescriptions(void *manager, const char *prefix, int k);
+
+    /**
+     * @brief Finds transactions matching every predicate of a query spec.
+     *
+     * The spec is a JSON object whose keys are all optional: "month", "from"
+     * and "to" as in ExportTransactions; "categoryId" or a "categoryIds" array
+     * for a set of categories; "minAmount" and "maxAmount" in the base
+     * currency; "isIncome"; "text"
+     * with an optional "prefix" as in SearchTransactions; "tags", an array of
+     * tags every result must carry, and "excludeTags", an array of tags no
+     * result may carry; "limit" (0 for no limit) and "newestFirst" for the
+     * order. The engine reads candidates from the most selective month,
+     * category or description index, or scans every transaction when none
+     * narrows the query; a query with tags combines the tag bitmaps with the
+     * month and category indexes instead.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param spec JSON query spec, or NULL or empty to match every transaction
+     * @return JSON string containing matching transactions in ID order, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *QueryTransactions(void *manager, const char *spec);
+
+    /**
+     * @brief Reports how QueryTransactions would run a query spec, without running it.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param spec JSON query spec, as for QueryTransactions
+     * @return JSON object with "access" ("scan", "month", "category", "text" or "tag") and "estimatedRows", caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *ExplainQuery(void *manager, const char *spec);
+
+    // Change tracking
+    /**
+     * @brief Gets the current data version.
+     *
+     * The version increases with every change to transactions, categories or budgets.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @return The current data version
+     */
+    BUDGETTRACKER_API unsigned long long GetDataVersion(void *manager);
+
+    /**
+     * @brief Gets the net changes made after a data version.
+     *
+     * The result has the form
+     * {"version": N, "fullResync": bool,
+     *  "transactions": {"inserted": [...], "updated": [...], "deleted": [ids]},
+     *  "categories": {...}, "budgets": {...}}
+     * where inserted/updated hold full records shaped like GetAll* results and
+     * deleted budgets are {categoryId, monthYear} keys. If the change log no longer
+     * reaches back to version, fullResync is true and "inserted" holds every record.
+     * Pass the returned version to the next call.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param version The data version the client last synchronized to, 0 for a first sync
+     * @return JSON string describing the changes, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *GetChangesSince(void *manager, unsigned long long version);
+
+    // Batch operations
+    /**
+     * @brief Adds several transactions at once from parallel arrays.
+     *
+     * Either every row is added or none is, and the data is written to disk once.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param count Number of rows in each array
+     * @param dates Dates of the transactions in "YYYY-MM-DD" format
+     * @param amounts Amounts of the transactions
+     * @param descriptions Descriptions of the transactions
+     * @param categoryIds Category IDs associated with the transactions
+     * @param isIncome Income flags of the transactions
+     * @param outIds Optional array of count elements receiving the new IDs, may be NULL
+     * @return The number of transactions added, or -1 on failure
+     */
+    BUDGETTRACKER_API int AddTransactionsBatch(void *manager, int count, const char **dates, const double *amounts, const char **descriptions, const int *categoryIds, const bool *isIncome, int *outIds);
+
+    /**
+     * @brief Adds several transactions at once, detecting duplicates of existing ones.
+     *
+     * A row is a duplicate when a stored transaction, or an earlier row of the
+     * batch, has the same date, amount and description (compared ignoring case,
+     * punctuation and spacing). Duplicate checks are O(1) per row.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param count Number of rows in each array
+     * @param dates Dates of the transactions in "YYYY-MM-DD" format
+     * @param amounts Amounts of the transactions
+     * @param descriptions Descriptions of the transactions
+     * @param categoryIds Category IDs associated with the transactions
+     * @param isIncome Income flags of the transactions
+     * @param duplicatePolicy 0 to add duplicates silently, 1 to skip them, 2 to add and flag them
+     * @param outIds Optional array of count elements receiving the new IDs, -1 for skipped rows, may be NULL
+     * @param outDuplicateOf Optional array of count elements receiving the ID each row duplicates, 0 if none, may be NULL
+     * @return The number of transactions added, or -1 on failure
+     */
+    BUDGETTRACKER_API int AddTransactionsBatchChecked(void *manager, int count, const char **dates, const double *amounts, const char **descriptions, const int *categoryIds, const bool *isIncome, int duplicatePolicy, int *outIds, int *outDuplicateOf);
+
+    /**
+     * @brief Finds groups of stored transactions that duplicate each other.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @return JSON array of arrays of transaction IDs, one per group, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *GetDuplicateTransactions(void *manager);
+
+    /**
+     * @brief Updates several transactions at once from parallel arrays.
+     *
+     * Either every row is updated or none is, and the data is written to disk once.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param count Number of rows in each array
+     * @param ids IDs of the transactions to update
+     * @param dates New dates for the transactions
+     * @param amounts New amounts for the transactions
+     * @param descriptions New descriptions for the transactions
+     * @param categoryIds New category IDs for the transactions
+     * @param isIncome New income flags for the transactions
+     * @return true if all transactions were updated successfully, false otherwise
+     */
+    BUDGETTRACKER_API bool UpdateTransactionsBatch(void *manager, int count, const int *ids, const char **dates, const double *amounts, const char **descriptions, const int *categoryIds, const bool *isIncome);
+
+    /**
+     * @brief Deletes several transactions at once.
+     *
+     * Either every transaction is deleted or none is, and the data is written to disk once.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param count Number of IDs in the array
+     * @param transactionIds IDs of the transactions to delete
+     * @return true if all transactions were deleted successfully, false otherwise
+     */
+    BUDGETTRACKER_API bool DeleteTransactionsBatch(void *manager, int count, const int *transactionIds);
+
+    /**
+     * @brief Opens an explicit batch on the manager.
+     *
+     * Mutations made until CommitBatch or RollbackBatch are kept in memory and
+     * written to disk once on commit. The batch belongs to the calling thread;
+     * while it is open, writes from other threads fail, and that includes
+     * asynchronous operations, which run on the handle's worker thread.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @return true if the batch was opened, false if one is already open
+     */
+    BUDGETTRACKER_API bool BeginBatch(void *manager);
+
+    /**
+     * @brief Commits the open batch and writes all changes to disk.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @return true if the batch was saved, false otherwise (the batch is rolled back)
+     */
+    BUDGETTRACKER_API bool CommitBatch(void *manager);
+
+    /**
+     * @brief Discards every change made since BeginBatch.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @return true if a batch was rolled back, false if none was open or another thread opened it
+     */
+    BUDGETTRACKER_API bool RollbackBatch(void *manager);
+
+    // Statement import
+    /**
+     * @brief Imports a CSV, OFX/QFX or QIF bank statement.
+     *
+     * Entries are parsed in parallel and every valid one is added in a single
+     * batch with one save. Invalid entries are skipped. The result has "success",
+     * "imported" (number of transactions added), "firstId" and "lastId" of the
+     * added transactions, "errorCount" and "errors", a list of {"line", "message"}
+     * for the first 1000 rejected entries, and "duplicateCount" and "duplicates",
+     * the first 1000 entries matching existing transactions with their "line"
+     * and "existingId".
+     *
+     * Dates written with the year last are read in one field order for the
+     * whole file. With dateOrder 0 the order is detected from every date; a
+     * file whose dates disagree, or all read either way, imports nothing and
+     * reports one error on line 0.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param filePath Path of the statement file
+     * @param format "csv", "ofx", "qfx" or "qif"; NULL or empty to use the file extension
+     * @param duplicatePolicy 0 to import duplicates silently, 1 to skip them, 2 to import and flag them
+     * @param dateOrder 0 to detect, 1 for month first (MM/DD/YYYY), 2 for day first (DD/MM/YYYY)
+     * @return JSON string describing the outcome, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *ImportFile(void *manager, const char *filePath, const char *format, int duplicatePolicy, int dateOrder);
+
+    // Export
+    /**
+     * @brief Streams transactions to a CSV, NDJSON or columnar binary file.
+     *
+     * Rows are written as they are scanned, without building the whole result in
+     * memory. The filter is a JSON object whose optional keys "month"
+     * ("YYYY-MM"), "categoryId" (0 for uncategorized), "from" and "to"
+     * ("YYYY-MM-DD", inclusive) must all match. The columnar layout is described
+     * in TransactionExporter.h.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param filePath Destination path; replaced only if the export succeeds
+     * @param format "csv", "ndjson"/"jsonl" or "columnar"/"btcol"; NULL or empty to use the file extension
+     * @param filter JSON filter object, or NULL or empty to export every transaction
+     * @return The number of rows exported, or -1 on failure
+     */
+    BUDGETTRACKER_API long long ExportTransactions(void *manager, const char *filePath, const char *format, const char *filter);
+
     // Budget operations
     /**
      * @brief Adds a new budget.
@@ -178,6 +605,77 @@ extern "C"
      */
     BUDGETTRACKER_API const char *GetAllBudgets(void *manager);
 
+    /**
+     * @brief Compares every budget in a range of months with actual spending.
+     *
+     * Spending totals are maintained as transactions change, so no
+     * transactions are scanned. Each entry has "categoryId", "monthYear",
+     * "allocated", "spent", "remaining", "percentUsed" and "overBudget".
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param fromMonth First "YYYY-MM" month, or NULL or empty for no lower bound
+     * @param toMonth Last "YYYY-MM" month, or NULL or empty for no upper bound
+     * @return JSON string containing the comparisons by month and category, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *GetBudgetVariance(void *manager, const char *fromMonth, const char *toMonth);
+
+    /**
+     * @brief Takes the over-budget alerts raised since the last call.
+     *
+     * An alert is raised when adding or changing a transaction, or adding or
+     * lowering a budget, takes a category's spending in a month over its
+     * budget. Each entry has "categoryId", "monthYear", "allocated", "spent"
+     * and "transactionId" (-1 when a budget change raised it).
+     *
+     * @param manager Pointer to the DataManager instance
+     * @return JSON string containing the alerts, oldest first, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *GetBudgetAlerts(void *manager);
+
+    // Currency operations
+    /**
+     * @brief Sets the currency GetTotalIncome, GetTotalExpense, GetCategoryTotals, GetMonthlyTotals and GetReportBundle report in.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param currency Currency code such as "USD"; transactions without a currency are taken to be in it
+     * @return true if the setting was saved, false otherwise
+     */
+    BUDGETTRACKER_API bool SetBaseCurrency(void *manager, const char *currency);
+
+    /**
+     * @brief Sets the rate of a currency from a date on.
+     *
+     * A month converts at the latest rate dated on or before its last day, or
+     * at the earliest rate if it predates them all. Transactions in a
+     * currency without rates are left out of base currency totals until it
+     * has one; GetExchangeRates lists them under "unconverted".
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param currency Currency code such as "EUR"
+     * @param date First "YYYY-MM-DD" date the rate applies
+     * @param rate Base currency units per unit of the currency; must be positive
+     * @return true if the rate is valid and was saved, false otherwise
+     */
+    BUDGETTRACKER_API bool SetExchangeRate(void *manager, const char *currency, const char *date, double rate);
+
+    /**
+     * @brief Removes the rate of a currency on a date.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param currency Currency code
+     * @param date The date the rate was set for
+     * @return true if the rate existed and the change was saved, false otherwise
+     */
+    BUDGETTRACKER_API bool RemoveExchangeRate(void *manager, const char *currency, const char *date);
+
+    /**
+     * @brief Gets the base currency and every exchange rate.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @return JSON object with "baseCurrency", "rates", an array of {"currency","date","rate"} ordered by currency then date, and "unconverted", currency code to the number of transactions left out of totals for lack of a rate; caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *GetExchangeRates(void *manager);
+
     // Analysis functions
     /**
      * @brief Gets total income for a specific month.
@@ -206,6 +704,394 @@ extern "C"
      */
     BUDGETTRACKER_API const char *GetCategoryTotals(void *manager, const char *monthYear);
 
+    /**
+     * @brief Gets the totals of every category and of its subtree of subcategories.
+     *
+     * Served from running per-category totals in one bottom-up pass, without
+     * reading transactions. Each entry has "id", "parentId", "depth", "total"
+     * and "spent" for the category itself, and "subtreeTotal" and
+     * "subtreeSpent" including every descendant. Entries list parents before
+     * their children, depth first in ID order.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param monthYear Month and year in "YYYY-MM" format, or NULL or empty for all time
+     * @return JSON string containing the rollups, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *GetCategoryRollups(void *manager, const char *monthYear);
+
+    /**
+     * @brief Gets income, expenses, category totals and budget use for every month of a range.
+     *
+     * Replaces one GetTotalIncome, GetTotalExpense and GetCategoryTotals call
+     * per month with a single pass over the data. The result has "from", "to",
+     * range-wide "income", "expense" and "net", and a "months" array holding,
+     * per month, "month", "income", "expense", "net" and "categories". Each
+     * category entry has "id", "total" (income minus expenses), "spent" and,
+     * when the month has a budget for it, "budget" and "utilization" (spent
+     * divided by budget). Categories with neither transactions nor a budget in
+     * a month are left out.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param fromMonth First month in "YYYY-MM" format
+     * @param toMonth Last month in "YYYY-MM" format
+     * @return JSON string containing the report, or an empty object if the range is invalid, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *GetReportBundle(void *manager, const char *fromMonth, const char *toMonth);
+
+    /**
+     * @brief Gets income, expenses, running balance and moving averages per day, week or month.
+     *
+     * Served from per-day prefix sums, so the cost grows with the number of
+     * buckets rather than transactions. The result has "from", "to",
+     * "interval", "window" and a "points" array holding, per bucket, "start",
+     * "end", "income", "expense", "net", "balance" (income minus expenses of
+     * every day up to "end") and "averageIncome" and "averageExpense" (mean
+     * per day over the window ending at "end"). Weeks run Monday to Sunday;
+     * the first and last buckets are clipped to the range.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param fromDate First day in "YYYY-MM-DD" format
+     * @param toDate Last day in "YYYY-MM-DD" format
+     * @param interval "day", "week" or "month"
+     * @param windowDays Moving-average window in days; 0 leaves the averages at zero
+     * @return JSON string containing the series, or an empty object if the arguments are invalid, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *GetTimeSeries(void *manager, const char *fromDate, const char *toDate, const char *interval,
+                                                int windowDays);
+
+    /**
+     * @brief Gets the largest transactions in a scope.
+     *
+     * Runs in linear time with a bounded heap, without sorting the scope.
+     * Amounts are ranked in the base currency; transactions in a currency
+     * without rates are left out.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param spec JSON query spec as for QueryTransactions, e.g. {"month":"2024-03","isIncome":false}; its limit and order are ignored
+     * @param k Number of transactions to return
+     * @return JSON string containing the transactions, largest amount first, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *GetTopTransactions(void *manager, const char *spec, int k);
+
+    /**
+     * @brief Gets amount percentiles, overall or per category, for a scope.
+     *
+     * Each entry has "count", "min", "max", "mean" and a "percentiles" array
+     * of {"p", "value"} in request order, plus "categoryId" when grouped by
+     * category. Percentiles interpolate linearly between the closest ranks.
+     * Amounts are in the base currency; transactions in a currency without
+     * rates are left out.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param spec JSON query spec as for QueryTransactions; its limit and order are ignored
+     * @param percentiles JSON array of percentiles from 0 to 100, or NULL or empty for [50, 90]
+     * @param byCategory true for one entry per category, false for one entry over the whole scope
+     * @return JSON string containing the statistics, by category ID, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *GetAmountStatistics(void *manager, const char *spec, const char *percentiles, bool byCategory);
+
+    /**
+     * @brief Finds subscriptions, bills and other transactions that recur weekly, monthly or yearly.
+     *
+     * Transactions are grouped by description, ignoring case, punctuation and
+     * words containing digits, and by amounts within the tolerance. Each entry
+     * has "description" and "categoryId" of the latest occurrence, "isIncome",
+     * "period" ("weekly", "monthly" or "yearly"), the median "amount",
+     * "meanInterval" and "intervalDeviation" in days, "regularity" (fraction
+     * of intervals close to the period), "occurrences", "firstDate",
+     * "lastDate", "nextDate" and "transactionIds".
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param amountTolerance Largest relative amount difference within a series, e.g. 0.1 for 10%
+     * @param minOccurrences Fewest occurrences a series needs; at least 2
+     * @return JSON string containing the series, by next expected date, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *FindRecurringTransactions(void *manager, double amountTolerance, int minOccurrences);
+
+    // Metrics
+    /**
+     * @brief Gets the operation metrics collected since creation or the last reset.
+     *
+     * The result has an "operations" object keyed by operation name, each with a
+     * call count and latency mean, p50, p90, p99, p99.9 and max in microseconds,
+     * and a "counters" object with rowsScanned, rowsReturned, bytesSerialized,
+     * bytesWritten and bytesRead.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @return JSON string containing the metrics, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *GetMetrics(void *manager);
+
+    /**
+     * @brief Clears all collected metrics.
+     *
+     * @param manager Pointer to the DataManager instance
+     */
+    BUDGETTRACKER_API void ResetMetrics(void *manager);
+
+    // Memory accounting
+    /**
+     * @brief Reports an estimate of the memory held by a handle.
+     *
+     * The result breaks out transactionRecords, categoryRecords, budgetRecords,
+     * stringPayloads, indexes, changeLog, undoLog and the calling thread's
+     * returnBuffer, their total, and the peak transient JSON footprint seen during
+     * load (peakLoadTransient) and save (peakSaveTransient). All values are bytes.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @return JSON string containing the memory breakdown, caller does not need to free this memory
+     */
+    BUDGETTRACKER_API const char *GetMemoryStats(void *manager);
+
+    /**
+     * @brief Releases spare capacity held by a handle and the calling thread's return buffer.
+     *
+     * Any string previously returned on this thread becomes invalid.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @return Estimated bytes released, or -1 on error
+     */
+    BUDGETTRACKER_API long long Compact(void *manager);
+
+    // Tracing
+    /**
+     * @brief Starts recording trace spans for loads, saves, queries and C API calls.
+     *
+     * Spans are buffered in memory and written as Chrome trace-event JSON, which
+     * chrome://tracing and Perfetto can open, when tracing stops or the process
+     * exits. Setting the BUDGET_TRACKER_TRACE environment variable to a file path
+     * starts tracing when the library loads.
+     *
+     * @param filePath File to write the trace to
+     * @return true if tracing started, false if it was already running
+     */
+    BUDGETTRACKER_API bool StartTracing(const char *filePath);
+
+    /**
+     * @brief Stops tracing and writes the trace file.
+     *
+     * @return true if the trace file was written
+     */
+    BUDGETTRACKER_API bool StopTracing();
+
+    // Asynchronous operations
+    /**
+     * @brief Completion callback for asynchronous operations.
+     *
+     * Called on the handle's background thread. Operations on the same handle
+     * complete in the order they were queued.
+     *
+     * @param userData The cookie passed to the asynchronous call
+     * @param success Whether the operation succeeded
+     * @param value Numeric result: the new ID for add operations, the total for
+     *              GetTotalIncome/GetTotalExpense, otherwise 0
+     * @param json JSON result for queries, NULL otherwise; only valid during the callback
+     */
+    typedef void (*BudgetTrackerCallback)(void *userData, bool success, double value, const char *json);
+
+    /**
+     * @brief Queues AddCategory on the handle's background thread.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param name Name of the category
+     * @param description Description of the category
+     * @param color Color code for the category (in hex format)
+     * @param callback Called when the operation completes, may be NULL
+     * @param userData Cookie passed back to the callback
+     * @return true if the operation was queued, false otherwise
+     */
+    BUDGETTRACKER_API bool AddCategoryAsync(void *manager, const char *name, const char *description, const char *color, BudgetTrackerCallback callback, void *userData);
+
+    /**
+     * @brief Queues UpdateCategory on the handle's background thread.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param id ID of the category to update
+     * @param name New name for the category
+     * @param description New description for the category
+     * @param color New color code for the category
+     * @param callback Called when the operation completes, may be NULL
+     * @param userData Cookie passed back to the callback
+     * @return true if the operation was queued, false otherwise
+     */
+    BUDGETTRACKER_API bool UpdateCategoryAsync(void *manager, int id, const char *name, const char *description, const char *color, BudgetTrackerCallback callback, void *userData);
+
+    /**
+     * @brief Queues DeleteCategory on the handle's background thread.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param categoryId ID of the category to delete
+     * @param callback Called when the operation completes, may be NULL
+     * @param userData Cookie passed back to the callback
+     * @return true if the operation was queued, false otherwise
+     */
+    BUDGETTRACKER_API bool DeleteCategoryAsync(void *manager, int categoryId, BudgetTrackerCallback callback, void *userData);
+
+    /**
+     * @brief Queues AddTransaction on the handle's background thread.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param date Date of the transaction in "YYYY-MM-DD" format
+     * @param amount Amount of the transaction
+     * @param description Description of the transaction
+     * @param categoryId Category ID associated with the transaction
+     * @param isIncome Whether the transaction is income (true) or expense (false)
+     * @param callback Called when the operation completes, may be NULL
+     * @param userData Cookie passed back to the callback
+     * @return true if the operation was queued, false otherwise
+     */
+    BUDGETTRACKER_API bool AddTransactionAsync(void *manager, const char *date, double amount, const char *description, int categoryId, bool isIncome, BudgetTrackerCallback callback, void *userData);
+
+    /**
+     * @brief Queues UpdateTransaction on the handle's background thread.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param id ID of the transaction to update
+     * @param date New date for the transaction
+     * @param amount New amount for the transaction
+     * @param description New description for the transaction
+     * @param categoryId New category ID for the transaction
+     * @param isIncome New income status for the transaction
+     * @param callback Called when the operation completes, may be NULL
+     * @param userData Cookie passed back to the callback
+     * @return true if the operation was queued, false otherwise
+     */
+    BUDGETTRACKER_API bool UpdateTransactionAsync(void *manager, int id, const char *date, double amount, const char *description, int categoryId, bool isIncome, BudgetTrackerCallback callback, void *userData);
+
+    /**
+     * @brief Queues DeleteTransaction on the handle's background thread.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param transactionId ID of the transaction to delete
+     * @param callback Called when the operation completes, may be NULL
+     * @param userData Cookie passed back to the callback
+     * @return true if the operation was queued, false otherwise
+     */
+    BUDGETTRACKER_API bool DeleteTransactionAsync(void *manager, int transactionId, BudgetTrackerCallback callback, void *userData);
+
+    /**
+     * @brief Queues AddTransactionsBatch on the handle's background thread.
+     *
+     * The input arrays are copied before this function returns. The callback's
+     * value is the number of transactions added and its json is an array of the
+     * new IDs.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param count Number of rows in each array; must be positive
+     * @param dates Dates of the transactions in "YYYY-MM-DD" format
+     * @param amounts Amounts of the transactions
+     * @param descriptions Descriptions of the transactions
+     * @param categoryIds Category IDs associated with the transactions
+     * @param isIncome Income flags of the transactions
+     * @param callback Called when the operation completes, may be NULL
+     * @param userData Cookie passed back to the callback
+     * @return true if the operation was queued, false if the arguments are invalid or it could not be queued
+     */
+    BUDGETTRACKER_API bool AddTransactionsBatchAsync(void *manager, int count, const char **dates, const double *amounts, const char **descriptions, const int *categoryIds, const bool *isIncome, BudgetTrackerCallback callback, void *userData);
+
+    /**
+     * @brief Queues AddBudget on the handle's background thread.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param categoryId Category ID for the budget
+     * @param monthYear Month and year in "YYYY-MM" format
+     * @param allocatedAmount Amount allocated for the budget
+     * @param callback Called when the operation completes, may be NULL
+     * @param userData Cookie passed back to the callback
+     * @return true if the operation was queued, false otherwise
+     */
+    BUDGETTRACKER_API bool AddBudgetAsync(void *manager, int categoryId, const char *monthYear, double allocatedAmount, BudgetTrackerCallback callback, void *userData);
+
+    /**
+     * @brief Queues UpdateBudget on the handle's background thread.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param categoryId Category ID of the budget to update
+     * @param monthYear Month and year of the budget to update
+     * @param allocatedAmount New allocated amount for the budget
+     * @param callback Called when the operation completes, may be NULL
+     * @param userData Cookie passed back to the callback
+     * @return true if the operation was queued, false otherwise
+     */
+    BUDGETTRACKER_API bool UpdateBudgetAsync(void *manager, int categoryId, const char *monthYear, double allocatedAmount, BudgetTrackerCallback callback, void *userData);
+
+    /**
+     * @brief Queues DeleteBudget on the handle's background thread.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param categoryId Category ID of the budget to delete
+     * @param monthYear Month and year of the budget to delete
+     * @param callback Called when the operation completes, may be NULL
+     * @param userData Cookie passed back to the callback
+     * @return true if the operation was queued, false otherwise
+     */
+    BUDGETTRACKER_API bool DeleteBudgetAsync(void *manager, int categoryId, const char *monthYear, BudgetTrackerCallback callback, void *userData);
+
+    /**
+     * @brief Queues GetAllTransactions on the handle's background thread.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param callback Called with the JSON result
+     * @param userData Cookie passed back to the callback
+     * @return true if the operation was queued, false otherwise
+     */
+    BUDGETTRACKER_API bool GetAllTransactionsAsync(void *manager, BudgetTrackerCallback callback, void *userData);
+
+    /**
+     * @brief Queues GetTransactionsByMonth on the handle's background thread.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param monthYear Month and year in "YYYY-MM" format
+     * @param callback Called with the JSON result
+     * @param userData Cookie passed back to the callback
+     * @return true if the operation was queued, false otherwise
+     */
+    BUDGETTRACKER_API bool GetTransactionsByMonthAsync(void *manager, const char *monthYear, BudgetTrackerCallback callback, void *userData);
+
+    /**
+     * @brief Queues GetTotalIncome on the handle's background thread.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param monthYear Month and year in "YYYY-MM" format
+     * @param callback Called with the total as its value
+     * @param userData Cookie passed back to the callback
+     * @return true if the operation was queued, false otherwise
+     */
+    BUDGETTRACKER_API bool GetTotalIncomeAsync(void *manager, const char *monthYear, BudgetTrackerCallback callback, void *userData);
+
+    /**
+     * @brief Queues GetTotalExpense on the handle's background thread.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param monthYear Month and year in "YYYY-MM" format
+     * @param callback Called with the total as its value
+     * @param userData Cookie passed back to the callback
+     * @return true if the operation was queued, false otherwise
+     */
+    BUDGETTRACKER_API bool GetTotalExpenseAsync(void *manager, const char *monthYear, BudgetTrackerCallback callback, void *userData);
+
+    /**
+     * @brief Queues GetCategoryTotals on the handle's background thread.
+     *
+     * @param manager Pointer to the DataManager instance
+     * @param monthYear Month and year in "YYYY-MM" format
+     * @param callback Called with the JSON result
+     * @param userData Cookie passed back to the callback
+     * @return true if the operation was queued, false otherwise
+     */
+    BUDGETTRACKER_API bool GetCategoryTotalsAsync(void *manager, const char *monthYear, BudgetTrackerCallback callback, void *userData);
+
+    /**
+     * @brief Blocks until every asynchronous operation queued on the handle has completed.
+     *
+     * Must not be called from inside a completion callback. May run concurrently
+     * with DestroyDataManager on the same handle, in which case it returns once
+     * the queued operations have finished.
+     *
+     * @param manager Pointer to the DataManager instance
+     */
+    BUDGETTRACKER_API void WaitForAsyncOperations(void *manager);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -4,21 +4,24 @@
  */
 #pragma once
 #include <string>
+#include "BudgetTrackerExport.h"
 
 /**
  * @class Category
  * @brief Represents a category for transactions in the budget tracking system.
  *
  * Categories allow the grouping and organization of financial transactions
- * for better tracking and analysis of spending patterns.
+ * for better tracking and analysis of spending patterns. A category may sit
+ * under a parent, so "Food" can contain "Groceries" and "Restaurants".
  */
-class Category
+class BUDGETTRACKER_API Category
 {
 private:
     int id;                  /**< Unique identifier for the category */
     std::string name;        /**< Name of the category */
     std::string description; /**< Description of what the category includes */
     std::string color;       /**< Hex color code for UI visualization of the category */
+    int parentId;            /**< ID of the parent category, or 0 for a top-level category */
 
 public:
     /**
@@ -28,9 +31,10 @@ public:
      * @param name Name of the category
      * @param description Description of the category
      * @param color Hex color code for UI visualization
+     * @param parentId ID of the parent category, or 0 for a top-level category
      */
     Category(int id, const std::string &name,
-             const std::string &description, const std::string &color);
+             const std::string &description, const std::string &color, int parentId = 0);
 
     /**
      * @brief Default constructor for JSON deserialization.
@@ -62,6 +66,12 @@ public:
      */
     std::string getColor() const;
 
+    /**
+     * @brief Gets the parent category identifier.
+     * @return The ID of the parent category, or 0 for a top-level category
+     */
+    int getParentId() const;
+
     // Setters
     /**
      * @brief Sets the category identifier.
@@ -87,9 +97,21 @@ public:
      */
     void setColor(const std::string &color);
 
+    /**
+     * @brief Sets the parent category identifier.
+     * @param parentId The ID of the parent category, or 0 for a top-level category
+     */
+    void setParentId(int parentId);
+
     /**
      * @brief Generates a string representation of this Category.
      * @return A string representation for debugging purposes
      */
     std::string toString() const;
+
+    /**
+     * @brief Gets the heap memory owned by this Category's strings.
+     * @return Bytes allocated outside the object for string contents
+     */
+    size_t getHeapSize() const;
 };
\ No newline at end of file
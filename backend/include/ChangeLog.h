@@ -0,0 +1,158 @@
+/**
+ * @file ChangeLog.h
+ * @brief Defines the ChangeLog class that records versioned data changes.
+ */
+#pragma once
+#include <deque>
+#include <string>
+#include <vector>
+#include "Transaction.h"
+#include "Category.h"
+#include "Budget.h"
+
+/**
+ * @enum ChangeCollection
+ * @brief The collection a change applies to.
+ */
+enum class ChangeCollection
+{
+    Transactions,
+    Categories,
+    Budgets
+};
+
+/**
+ * @enum ChangeType
+ * @brief The kind of change applied to a record.
+ */
+enum class ChangeType
+{
+    Inserted,
+    Updated,
+    Deleted
+};
+
+/**
+ * @struct ChangeKey
+ * @brief Identifies a changed record.
+ *
+ * Transactions and categories are identified by id alone; budgets by their
+ * category id (stored in id) and monthYear.
+ */
+struct ChangeKey
+{
+    int id;                /**< Record ID, or category ID for budgets */
+    std::string monthYear; /**< Month and year for budgets, empty otherwise */
+};
+
+/**
+ * @struct ChangeSet
+ * @brief Net changes to every collection between two data versions.
+ *
+ * Records changed several times appear once, in the list matching their net
+ * effect. When fullResync is set the "inserted" lists hold the complete data
+ * and the client should replace its copy.
+ */
+struct ChangeSet
+{
+    unsigned long long version;                    /**< Data version the change set brings the client to */
+    bool fullResync;                               /**< Whether the log could not cover the requested range */
+    std::vector<Transaction> insertedTransactions; /**< Transactions created since the requested version */
+    std::vector<Transaction> updatedTransactions;  /**< Transactions modified since the requested version */
+    std::vector<int> deletedTransactionIds;        /**< IDs of transactions deleted since the requested version */
+    std::vector<Category> insertedCategories;      /**< Categories created since the requested version */
+    std::vector<Category> updatedCategories;       /**< Categories modified since the requested version */
+    std::vector<int> deletedCategoryIds;           /**< IDs of categories deleted since the requested version */
+    std::vector<Budget> insertedBudgets;           /**< Budgets created since the requested version */
+    std::vector<Budget> updatedBudgets;            /**< Budgets modified since the requested version */
+    std::vector<Budget> deletedBudgets;            /**< Keys (category and month) of budgets deleted since the requested version */
+};
+
+/**
+ * @class ChangeLog
+ * @brief Bounded log of record changes, each stamped with a new data version.
+ *
+ * The oldest entries are dropped once the log reaches its capacity; requests
+ * for changes older than what is still held then need a full resync.
+ */
+class ChangeLog
+{
+public:
+    /**
+     * @brief Constructs an empty log at version 0.
+     *
+     * @param capacity Maximum number of changes kept
+     */
+    explicit ChangeLog(size_t capacity = 100000);
+
+    /**
+     * @brief Records a change and advances the version.
+     *
+     * @param collection The collection that changed
+     * @param type The kind of change
+     * @param key The changed record
+     * @return The new data version
+     */
+    unsigned long long record(ChangeCollection collection, ChangeType type, const ChangeKey &key);
+
+    /**
+     * @brief Advances the version and forgets every change, forcing clients to resync.
+     */
+    void reset();
+
+    /**
+     * @brief Gets the current data version.
+     * @return The version of the latest change
+     */
+    unsigned long long getVersion() const;
+
+    /**
+     * @brief Checks whether the log still covers every change after a version.
+     *
+     * @param sinceVersion The version the client last saw
+     * @return true if collect() can answer for sinceVersion, false if a full resync is needed
+     */
+    bool covers(unsigned long long sinceVersion) const;
+
+    /**
+     * @brief Collects the net changes to one collection after a version.
+     *
+     * @param sinceVersion The version the client last saw
+     * @param collection The collection to collect changes for
+     * @param inserted Receives records that did not exist at sinceVersion and exist now
+     * @param updated Receives records that existed at sinceVersion and were modified
+     * @param deleted Receives records that existed at sinceVersion and no longer exist
+     */
+    void collect(unsigned long long sinceVersion, ChangeCollection collection,
+                 std::vector<ChangeKey> &inserted, std::vector<ChangeKey> &updated,
+                 std::vector<ChangeKey> &deleted) const;
+
+    /**
+     * @brief Estimates the memory held by the retained changes.
+     * @return Approximate size in bytes
+     */
+    size_t getMemoryUsage() const;
+
+    /**
+     * @brief Releases storage no longer needed by the retained changes.
+     */
+    void shrinkToFit();
+
+private:
+    /**
+     * @struct Entry
+     * @brief One logged change.
+     */
+    struct Entry
+    {
+        unsigned long long version;  /**< Version assigned to the change */
+        ChangeCollection collection; /**< Collection that changed */
+        ChangeType type;             /**< Kind of change */
+        ChangeKey key;               /**< Changed record */
+    };
+
+    std::deque<Entry> entries;       /**< Retained changes, oldest first */
+    size_t capacity;                 /**< Maximum number of retained changes */
+    unsigned long long version;      /**< Current data version */
+    unsigned long long floorVersion; /**< Oldest version the log can answer from */
+};
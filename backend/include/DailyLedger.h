@@ -0,0 +1,177 @@
+/**
+ * @file DailyLedger.h
+ * @brief Defines the DailyLedger class that keeps per-day income and expense totals with prefix sums.
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Transaction.h"
+
+/**
+ * @enum SeriesInterval
+ * @brief Bucket size of a time series.
+ */
+enum class SeriesInterval
+{
+    Day,
+    Week, /**< Monday to Sunday */
+    Month
+};
+
+/**
+ * @class DailyLedger
+ * @brief Income and expense totals of every day between the first and last transaction date.
+ *
+ * Days are numbered from 1970-01-01 and kept in a contiguous array, with
+ * prefix sums over it so the total of any range of days, and the running
+ * balance at any day, is two array reads. Changing a day only marks the
+ * prefix sums after it stale; they are recomputed from the earliest stale day
+ * by the next reader, so bulk loads cost one pass rather than one per row.
+ *
+ * Only dates from kFirstYear to kLastYear in "YYYY-MM-DD" form are tracked.
+ */
+class DailyLedger
+{
+public:
+    static const int kFirstYear = 1900;  /**< Earliest year tracked */
+    static const int kLastYear = 2199;   /**< Latest year tracked */
+    static const int kFirstDay = -25567; /**< Day number of January 1 of kFirstYear */
+
+    /**
+     * @brief Constructs an empty ledger.
+     */
+    DailyLedger();
+
+    DailyLedger(const DailyLedger &) = delete;
+    DailyLedger &operator=(const DailyLedger &) = delete;
+
+    /**
+     * @brief Converts a date to its day number.
+     *
+     * @param date Date in "YYYY-MM-DD" format; anything after the day is ignored
+     * @param day Receives the number of days since 1970-01-01
+     * @return true if the date is a valid calendar day between kFirstYear and kLastYear
+     */
+    static bool toDayNumber(const std::string &date, int &day);
+
+    /**
+     * @brief Converts a day number back to a date.
+     * @param day Days since 1970-01-01
+     * @return The date in "YYYY-MM-DD" format
+     */
+    static std::string fromDayNumber(int day);
+
+    /**
+     * @brief Gets the last day of the bucket containing a day.
+     *
+     * @param day Days since 1970-01-01
+     * @param interval The bucket size
+     * @return The day itself, the Sunday of its week or the last day of its month
+     */
+    static int bucketEnd(int day, SeriesInterval interval);
+
+    /**
+     * @brief Moves a day by whole calendar months.
+     *
+     * The day of the month is kept, or clamped to the last day of a shorter
+     * month, so 2024-01-31 plus one month is 2024-02-29.
+     *
+     * @param day Days since 1970-01-01
+     * @param months Months to add; may be negative
+     * @return The resulting day number
+     */
+    static int addMonths(int day, int months);
+
+    /**
+     * @brief Adds a transaction to its day.
+     * @param transaction The transaction; untracked dates are ignored
+     * @param amount Its amount in the ledger's currency
+     */
+    void add(const Transaction &transaction, double amount);
+
+    /**
+     * @brief Removes a transaction added with add().
+     * @param transaction The transaction, as it was added
+     * @param amount The amount it was added with
+     */
+    void remove(const Transaction &transaction, double amount);
+
+    /**
+     * @brief Removes every day.
+     */
+    void clear();
+
+    /**
+     * @brief Sums income over a range of days.
+     *
+     * @param first First day of the range
+     * @param last Last day of the range
+     * @return The total; days without transactions count as zero
+     */
+    double sumIncome(int first, int last) const;
+
+    /**
+     * @brief Sums expenses over a range of days.
+     *
+     * @param first First day of the range
+     * @param last Last day of the range
+     * @return The total; days without transactions count as zero
+     */
+    double sumExpense(int first, int last) const;
+
+    /**
+     * @brief Releases spare capacity of the day arrays.
+     */
+    void shrinkToFit();
+
+    /**
+     * @brief Estimates the memory held by the ledger.
+     * @return Approximate size in bytes
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    int firstDay;                 /**< Day number of index 0 in the arrays */
+    std::vector<double> income;   /**< Income per day */
+    std::vector<double> expense;  /**< Expenses per day */
+    std::vector<uint32_t> counts; /**< Transactions per day, so emptied days reset to exactly zero */
+
+    mutable std::vector<double> prefixIncome;  /**< prefixIncome[i] is the income of days before index i */
+    mutable std::vector<double> prefixExpense; /**< prefixExpense[i] is the expenses of days before index i */
+    mutable std::atomic<size_t> validPrefix;   /**< Number of leading prefix entries that are up to date */
+    mutable std::mutex refreshMutex;           /**< Serializes readers bringing the prefix sums up to date */
+
+    /**
+     * @brief Applies a transaction to its day.
+     *
+     * @param transaction The transaction
+     * @param amount Its amount in the ledger's currency
+     * @param sign 1 to add, -1 to remove
+     */
+    void apply(const Transaction &transaction, double amount, int sign);
+
+    /**
+     * @brief Grows the arrays to cover a day.
+     * @param day The day number
+     * @return Index of the day in the arrays
+     */
+    size_t cover(int day);
+
+    /**
+     * @brief Brings the prefix sums up to date.
+     */
+    void refresh() const;
+
+    /**
+     * @brief Sums one array's prefix sums over a range of days.
+     *
+     * @param prefix prefixIncome or prefixExpense
+     * @param first First day of the range
+     * @param last Last day of the range
+     * @return The total
+     */
+    double sumRange(const std::vector<double> &prefix, int first, int last) const;
+};
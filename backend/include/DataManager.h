@@ -9,16 +9,167 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <map>
+#include <deque>
+#include <unordered_map>
 #include <fstream>
 #include <memory>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
 #include "Transaction.h"
 #include "Category.h"
 #include "Budget.h"
+#include "ChangeLog.h"
+#include "Metrics.h"
+#include "StatementImporter.h"
+#include "TransactionExporter.h"
+#include "DuplicateIndex.h"
+#include "TextIndex.h"
+#include "SuggestionIndex.h"
+#include "PostingIndex.h"
+#include "TransactionQuery.h"
+#include "DailyLedger.h"
+#include "RecurringDetector.h"
+#include "TagIndex.h"
+#include "ExchangeRates.h"
 
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
 
+/**
+ * @struct MemoryStats
+ * @brief Approximate memory footprint of a DataManager, in bytes.
+ */
+struct MemoryStats
+{
+    size_t transactionRecords; /**< Transaction vector storage, including unused capacity */
+    size_t categoryRecords;    /**< Category vector storage, including unused capacity */
+    size_t budgetRecords;      /**< Budget vector storage, including unused capacity */
+    size_t stringPayloads;     /**< Heap-allocated string contents of every record */
+    size_t indexes;            /**< Month column and ID/key lookup tables */
+    size_t changeLog;          /**< Retained change log entries */
+    size_t undoLog;            /**< Undo records of the open batch */
+    size_t total;              /**< Sum of the resident sizes above */
+    size_t peakLoadTransient;  /**< Largest JSON DOM footprint seen while loading, estimated from the file sizes */
+    size_t peakSaveTransient;  /**< Largest JSON DOM footprint seen while saving, estimated from the file size */
+};
+
+/**
+ * @struct CategoryReport
+ * @brief Activity and budget of one category in one month.
+ */
+struct CategoryReport
+{
+    int categoryId;     /**< The category, 0 for uncategorized */
+    double total;       /**< Income minus expenses, as getCategoryTotal() reports it */
+    double spent;       /**< Expenses alone */
+    double allocated;   /**< Budgeted amount, 0 without a budget */
+    bool hasBudget;     /**< Whether a budget exists for the category and month */
+    double utilization; /**< spent / allocated, 0 without a budget or with a zero allocation */
+};
+
+/**
+ * @struct MonthReport
+ * @brief Totals of one month in a ReportBundle.
+ */
+struct MonthReport
+{
+    std::string monthYear;                   /**< Month and year in "YYYY-MM" format */
+    double income;                           /**< Total income */
+    double expense;                          /**< Total expenses */
+    double net;                              /**< Income minus expenses */
+    std::vector<CategoryReport> categories;  /**< Categories with transactions or a budget, by ID */
+};
+
+/**
+ * @struct ReportBundle
+ * @brief Dashboard totals for every month of a range, computed in one pass.
+ */
+struct ReportBundle
+{
+    std::string fromMonth;           /**< First month, "YYYY-MM" */
+    std::string toMonth;             /**< Last month, "YYYY-MM" */
+    double income;                   /**< Total income over the range */
+    double expense;                  /**< Total expenses over the range */
+    double net;                      /**< Income minus expenses over the range */
+    std::vector<MonthReport> months; /**< One entry per month of the range, in order */
+};
+
+/**
+ * @struct AmountStatistics
+ * @brief Order statistics of transaction amounts in one group, in the base currency.
+ */
+struct AmountStatistics
+{
+    int categoryId;                  /**< The category, or -1 for all matching transactions */
+    size_t count;                    /**< Number of transactions */
+    double min;                      /**< Smallest amount */
+    double max;                      /**< Largest amount */
+    double mean;                     /**< Average amount */
+    std::vector<double> percentiles; /**< Value of each requested percentile, in request order */
+};
+
+/**
+ * @struct SeriesPoint
+ * @brief One bucket of a time series.
+ */
+struct SeriesPoint
+{
+    std::string startDate; /**< First day of the bucket, "YYYY-MM-DD" */
+    std::string endDate;   /**< Last day of the bucket, "YYYY-MM-DD" */
+    double income;         /**< Income in the bucket */
+    double expense;        /**< Expenses in the bucket */
+    double net;            /**< Income minus expenses in the bucket */
+    double balance;        /**< Income minus expenses of all days up to the end of the bucket */
+    double averageIncome;  /**< Mean daily income over the window ending with the bucket */
+    double averageExpense; /**< Mean daily expenses over the window ending with the bucket */
+};
+
+/**
+ * @struct CategoryRollup
+ * @brief Totals of one category and of its whole subtree.
+ */
+struct CategoryRollup
+{
+    int categoryId;      /**< The category */
+    int parentId;        /**< Its parent, or 0 for a top-level category */
+    int depth;           /**< 0 for a top-level category, 1 for its children and so on */
+    double total;        /**< Income minus expenses of the category itself */
+    double spent;        /**< Expenses of the category itself */
+    double subtreeTotal; /**< Income minus expenses of the category and every descendant */
+    double subtreeSpent; /**< Expenses of the category and every descendant */
+};
+
+/**
+ * @struct BudgetVariance
+ * @brief A budget compared with the actual spending in its category and month.
+ */
+struct BudgetVariance
+{
+    int categoryId;        /**< The budgeted category */
+    std::string monthYear; /**< The budgeted month, "YYYY-MM" */
+    double allocated;      /**< Budgeted amount */
+    double spent;          /**< Expenses in the category and month */
+    double remaining;      /**< allocated minus spent; negative when over budget */
+    double percentUsed;    /**< spent as a percentage of allocated, 0 for a zero allocation */
+};
+
+/**
+ * @struct BudgetAlert
+ * @brief Notice that spending in a budgeted category and month went over its allocation.
+ */
+struct BudgetAlert
+{
+    int categoryId;        /**< The budgeted category */
+    std::string monthYear; /**< The budgeted month, "YYYY-MM" */
+    double allocated;      /**< Budgeted amount */
+    double spent;          /**< Expenses once the budget was exceeded */
+    int transactionId;     /**< Transaction that pushed spending over, -1 if a budget change did */
+};
+
 /**
  * @class DataManager
  * @brief Manages all data operations for the budget tracking system.
@@ -26,10 +177,18 @@ using json = nlohmann::json;
  * This class is responsible for storing and retrieving transaction, category,
  * and budget data to/from persistent storage. It also provides methods for
  * financial analysis of the stored data.
+ *
+ * All public methods are thread-safe. Readers share a reader/writer lock and run
+ * in parallel; writers apply their change under the exclusive lock and then
+ * write it to disk under the shared lock, so readers are not blocked by file I/O.
+ * Methods returning raw pointers into the store are the exception: the pointer
+ * is only valid while no other thread is modifying the manager.
  */
 class DataManager
 {
 private:
+    mutable std::shared_mutex mutex;       /**< Guards every member below */
+    std::mutex saveMutex;                  /**< Serializes writes to the data files */
     std::string dataPath;                  /**< Directory path where data files are stored */
     std::vector<Transaction> transactions; /**< In-memory cache of all transactions */
     std::vector<Category> categories;      /**< In-memory cache of all categories */
@@ -37,6 +196,440 @@ private:
     int nextTransactionId;                 /**< Next available ID for new transactions */
     int nextCategoryId;                    /**< Next available ID for new categories */
 
+    std::vector<int> transactionMonths;                 /**< Month key (YYYYMM) of each transaction, parallel to transactions */
+    std::vector<uint16_t> transactionCurrencies;        /**< Interned currency of each transaction, parallel to transactions */
+    std::vector<double> baseAmounts;                    /**< Amount of each transaction in the base currency, parallel to transactions */
+    ExchangeRates exchangeRates;                        /**< Dated conversion rates into the base currency */
+    std::unordered_map<int, size_t> transactionSlots;   /**< Transaction ID to position in transactions */
+    std::unordered_map<int, size_t> categorySlots;      /**< Category ID to position in categories */
+    std::unordered_map<std::string, size_t> budgetSlots; /**< Budget key to position in budgets */
+    DuplicateIndex duplicateIndex;                      /**< Fingerprints of all transactions, for duplicate detection */
+    TextIndex textIndex;                                /**< Description trigrams of all transactions, for search */
+    SuggestionIndex suggestionIndex;                    /**< Distinct descriptions and category names, for autocomplete */
+    PostingIndex monthIndex;                            /**< Transaction IDs by month key, -1 for irregular dates */
+    PostingIndex categoryIndex;                         /**< Transaction IDs by category ID */
+    TagIndex tagIndex;                                  /**< Compressed transaction ID sets by tag */
+    DailyLedger dailyLedger;                            /**< Income and expenses per day, with prefix sums for time series */
+
+    /**
+     * @struct Spending
+     * @brief Running income and expense totals of one category in one month.
+     */
+    struct Spending
+    {
+        double amount;      /**< Sum of the expenses */
+        size_t count;       /**< Number of expenses, so empty totals can be dropped */
+        double income;      /**< Sum of the income */
+        size_t incomeCount; /**< Number of income transactions */
+    };
+
+    std::unordered_map<uint64_t, Spending> categorySpending; /**< Totals by spendingKey(), for budget variance, alerts and category rollups; month -1 holds undated transactions */
+    std::deque<BudgetAlert> budgetAlerts;                   /**< Budgets exceeded since the last takeBudgetAlerts() */
+
+    ChangeLog changeLog; /**< Versioned record of every change, for delta sync */
+    mutable Metrics metrics; /**< Latency histograms and volume counters */
+
+    std::atomic<size_t> peakLoadBytes; /**< Largest JSON DOM footprint seen while loading */
+    std::atomic<size_t> peakSaveBytes; /**< Largest JSON DOM footprint seen while saving */
+
+    bool transactionsDirty; /**< Transactions changed since the last successful save */
+    bool categoriesDirty;   /**< Categories changed since the last successful save */
+    bool budgetsDirty;      /**< Budgets changed since the last successful save */
+    bool ratesDirty;        /**< Base currency or exchange rates changed since the last successful save */
+
+    /**
+     * @struct UndoRecord
+     * @brief One reversible step recorded while a batch is open.
+     */
+    struct UndoRecord
+    {
+        enum class Op
+        {
+            InsertTransaction,
+            UpdateTransaction,
+            DeleteTransaction,
+            InsertCategory,
+            UpdateCategory,
+            DeleteCategory,
+            InsertBudget,
+            UpdateBudget,
+            DeleteBudget
+        };
+
+        Op op;                   /**< The mutation that was applied */
+        Transaction transaction; /**< Affected transaction (previous value for updates/deletes) */
+        Category category;       /**< Affected category (previous value for updates/deletes) */
+        Budget budget;           /**< Affected budget (previous value for updates/deletes) */
+    };
+
+    bool batchActive;                /**< Whether mutations are currently being collected in a batch */
+    std::vector<UndoRecord> undoLog; /**< Steps needed to roll the open batch back */
+    int batchNextTransactionId;      /**< nextTransactionId when the batch was opened */
+    int batchNextCategoryId;         /**< nextCategoryId when the batch was opened */
+    size_t batchAlertCount;          /**< Size of budgetAlerts when the batch was opened */
+    std::thread::id batchOwner;      /**< Thread that opened the batch; only it may write while the batch is open */
+
+    /**
+     * @brief Builds the lookup key used by budgetSlots.
+     *
+     * @param categoryId Category ID of the budget
+     * @param monthYear Month and year in "YYYY-MM" format
+     * @return Key unique to the (category, month) pair
+     */
+    static std::string budgetKey(int categoryId, const std::string &monthYear);
+
+    /**
+     * @brief Converts the "YYYY-MM" prefix of a date into an integer month key.
+     *
+     * @param date Date in "YYYY-MM-DD" or "YYYY-MM" format
+     * @return The key YYYYMM, or -1 if the prefix is malformed
+     */
+    static int toMonthKey(const std::string &date);
+
+    /**
+     * @brief Converts a month filter argument into a month key.
+     *
+     * @param monthYear Month and year in "YYYY-MM" format
+     * @return The key YYYYMM, or -1 if monthYear is not exactly "YYYY-MM"
+     */
+    static int toQueryMonthKey(const std::string &monthYear);
+
+    /**
+     * @brief Converts a month key back into "YYYY-MM" format.
+     *
+     * @param monthKey Month key as returned by toMonthKey()
+     * @return The month and year in "YYYY-MM" format
+     */
+    static std::string fromMonthKey(int monthKey);
+
+    /**
+     * @brief Checks whether the transaction at a slot falls in a month.
+     *
+     * @param slot Position in transactions
+     * @param monthKey Month key from toQueryMonthKey(monthYear)
+     * @param monthYear Month and year in "YYYY-MM" format
+     * @return true if the transaction's date starts with monthYear
+     */
+    bool matchesMonth(size_t slot, int monthKey, const std::string &monthYear) const;
+
+    /**
+     * @struct FilterBounds
+     * @brief Month keys derived from a TransactionFilter, so rows can be tested on the month column.
+     */
+    struct FilterBounds
+    {
+        int monthKey;  /**< toQueryMonthKey() of the month, -1 if unset or irregular */
+        int fromMonth; /**< Month key of the start date, -1 if unset */
+        int toMonth;   /**< Month key of the end date, -1 if unset */
+    };
+
+    /**
+     * @brief Derives the month bounds of a filter.
+     *
+     * @param filter The filter
+     * @return The bounds to pass to matchesFilter()
+     */
+    static FilterBounds toFilterBounds(const TransactionFilter &filter);
+
+    /**
+     * @brief Checks whether the transaction at a slot passes a filter.
+     *
+     * The month column is tested first; dates are only compared as strings for
+     * rows in the first or last month of the range.
+     *
+     * @param slot Position in transactions
+     * @param filter The filter
+     * @param bounds toFilterBounds(filter)
+     * @return true if the transaction matches every field of the filter
+     */
+    bool matchesFilter(size_t slot, const TransactionFilter &filter, const FilterBounds &bounds) const;
+
+    /**
+     * @struct PreparedQuery
+     * @brief A TransactionQuery with its predicates converted to the forms tested per row.
+     */
+    struct PreparedQuery
+    {
+        const TransactionQuery *query;                   /**< The query */
+        FilterBounds bounds;                             /**< toFilterBounds() of the query's date filter */
+        bool hasDatePredicate;                           /**< Whether a month or date range is set */
+        int lowMonth;                                    /**< Smallest month key a regular date may have */
+        int highMonth;                                   /**< Largest month key a regular date may have */
+        bool keepIrregular;                              /**< Whether dates without a month key may match */
+        std::vector<char> categoryMask;                  /**< Accepted flag by category ID; empty when the set is empty or sparse */
+        std::vector<int> tagIds;                         /**< Sorted IDs carrying every required tag and no excluded one; only set when tags are required */
+        std::vector<const RoaringBitmap *> excludedTags; /**< Bitmaps of excluded tags, tested per row; only set when no tag is required */
+    };
+
+    /**
+     * @brief Converts a query's predicates for row testing.
+     *
+     * Tag predicates are resolved here, under the caller's lock. With
+     * required tags, their bitmaps are intersected and the excluded tags
+     * subtracted, costing time in the size of the tag sets only; month and
+     * category are left to the row tests on the survivors. With excluded
+     * tags alone, their bitmaps are kept for the row tests, so the month or
+     * category index can still choose the candidates.
+     *
+     * @param query The query
+     * @return The prepared query; it refers to query, which must outlive it
+     */
+    PreparedQuery prepareQuery(const TransactionQuery &query) const;
+
+    /**
+     * @brief Chooses how to find a query's candidates.
+     *
+     * Each index that can narrow the query is costed by the length of the
+     * posting lists it would read; the cheapest wins unless reading it, which
+     * costs a slot lookup per ID, is no cheaper than scanning every row.
+     * A query with required tags always reads the IDs prepareQuery() found,
+     * since row tests never look at required tags.
+     *
+     * @param prepared The prepared query
+     * @param lists Receives the posting lists of the chosen month, category or tag plan
+     * @return The plan
+     */
+    QueryPlan planQuery(const PreparedQuery &prepared, std::vector<const std::vector<int> *> &lists) const;
+
+    /**
+     * @brief Keeps the slots of a block that satisfy a query.
+     *
+     * Predicates run one at a time over the whole block, cheapest first, each
+     * compacting the slot list without branching, so later and costlier tests
+     * only see rows that survived the earlier ones.
+     *
+     * @param prepared The prepared query
+     * @param slots Positions in transactions; the survivors are moved to the front in order
+     * @param count Number of slots
+     * @return Number of surviving slots
+     */
+    size_t refineSlots(const PreparedQuery &prepared, size_t *slots, size_t count) const;
+
+    /**
+     * @brief Runs a query plan and folds every block of matching slots into per-partition results.
+     *
+     * A scan folds each chunk into its own partial in parallel; an index read
+     * folds everything into a single partial. The query's limit and order are
+     * ignored. The caller must hold the lock.
+     *
+     * @param prepared The prepared query
+     * @param plan The plan from planQuery()
+     * @param lists The posting lists from planQuery()
+     * @param fold Called as fold(partial, slots, count) with blocks of matching slots
+     * @return The partials, in chunk order
+     */
+    template <typename Partial, typename Fold>
+    std::vector<Partial> collectMatches(const PreparedQuery &prepared, const QueryPlan &plan,
+                                        const std::vector<const std::vector<int> *> &lists, Fold fold) const;
+
+    /**
+     * @brief Builds the key of a category and month in categorySpending.
+     *
+     * @param categoryId The category ID
+     * @param monthKey The month key
+     * @return The key
+     */
+    static uint64_t spendingKey(int categoryId, int monthKey);
+
+    /**
+     * @brief Adds a transaction to or removes it from the running category totals.
+     *
+     * Adding an expense that takes a budgeted category and month over its
+     * allocation queues a BudgetAlert; the check is one hash lookup.
+     *
+     * @param transaction The transaction
+     * @param amount Its amount in the base currency
+     * @param monthKey Month key of its date; -1 files it under month -1
+     * @param add true to add, false to remove
+     */
+    void applySpending(const Transaction &transaction, double amount, int monthKey, bool add);
+
+    /**
+     * @brief Adds the transaction at a slot to or removes it from categorySpending and dailyLedger.
+     *
+     * Both take its base amount; a transaction whose currency has no rate is
+     * left out of them.
+     *
+     * @param slot Position in transactions; every parallel column must be set
+     * @param add true to add, false to remove
+     */
+    void applyTotals(size_t slot, bool add);
+
+    /**
+     * @brief Rebuilds categorySpending and dailyLedger from baseAmounts, without queuing alerts.
+     */
+    void rebuildTotals();
+
+    /**
+     * @brief Queues an alert, dropping the oldest once kMaxBudgetAlerts are waiting.
+     * @param alert The alert
+     */
+    void queueBudgetAlert(const BudgetAlert &alert);
+
+    /**
+     * @brief Queues an alert if a budget change left its category and month over allocation.
+     *
+     * @param budget The new or changed budget
+     * @param previousAllocated Allocation before the change; a negative value for a new budget
+     */
+    void checkBudgetChange(const Budget &budget, double previousAllocated);
+
+    /**
+     * @brief Checks that a category may be placed under a parent.
+     *
+     * @param categoryId The category being placed
+     * @param parentId The proposed parent; 0 is always allowed
+     * @return true if the parent exists and is neither the category nor one of its descendants
+     */
+    bool isValidParent(int categoryId, int parentId) const;
+
+    /**
+     * @brief Rebuilds every in-memory index from the record vectors.
+     */
+    void rebuildIndexes();
+
+    /**
+     * @brief Appends a transaction and indexes it.
+     * @param transaction The transaction to store (ID must already be assigned)
+     */
+    void insertTransactionRecord(const Transaction &transaction);
+
+    /**
+     * @brief Appends a transaction whose fingerprint is already known.
+     *
+     * @param transaction The transaction to add
+     * @param fingerprint DuplicateIndex::fingerprint() of the transaction
+     */
+    void insertTransactionRecord(const Transaction &transaction, uint64_t fingerprint);
+
+    /**
+     * @brief Replaces the transaction stored at a slot.
+     *
+     * @param slot Position in transactions
+     * @param transaction The new value (same ID)
+     */
+    void replaceTransactionAt(size_t slot, const Transaction &transaction);
+
+    /**
+     * @brief Removes the transaction at a slot by moving the last record into it.
+     * @param slot Position in transactions
+     */
+    void removeTransactionAt(size_t slot);
+
+    /**
+     * @brief Appends a category and indexes it.
+     * @param category The category to store (ID must already be assigned)
+     */
+    void insertCategoryRecord(const Category &category);
+
+    /**
+     * @brief Replaces the category stored at a slot.
+     *
+     * @param slot Position in categories
+     * @param category The new value (same ID)
+     */
+    void replaceCategoryAt(size_t slot, const Category &category);
+
+    /**
+     * @brief Removes the category at a slot, keeping the order of the others.
+     * @param slot Position in categories
+     */
+    void removeCategoryAt(size_t slot);
+
+    /**
+     * @brief Appends a budget and indexes it.
+     * @param budget The budget to store
+     */
+    void insertBudgetRecord(const Budget &budget);
+
+    /**
+     * @brief Replaces the budget stored at a slot.
+     *
+     * @param slot Position in budgets
+     * @param budget The new value (same category and month)
+     */
+    void replaceBudgetAt(size_t slot, const Budget &budget);
+
+    /**
+     * @brief Removes the budget at a slot, keeping the order of the others.
+     * @param slot Position in budgets
+     */
+    void removeBudgetAt(size_t slot);
+
+    /**
+     * @brief Undoes every step recorded in the undo log, newest first.
+     */
+    void applyUndoLog();
+
+    /**
+     * @brief Opens a batch; the caller must hold the exclusive lock.
+     * @return true if the batch was opened, false if one is already open
+     */
+    bool openBatch();
+
+    /**
+     * @brief Commits or rolls back the open batch; the caller must hold the exclusive lock.
+     *
+     * @param commit Whether to save the batch (true) or discard it (false)
+     * @return true if the batch was committed or rolled back, false if saving failed
+     */
+    bool closeBatch(bool commit);
+
+    /**
+     * @brief Checks that no batch is open or the calling thread opened it; the caller must hold the exclusive lock.
+     * @return true if the caller may write, false (after logging) if another thread's batch is open
+     */
+    bool isBatchWriter() const;
+
+    /**
+     * @brief Writes collections that changed since the last save.
+     *
+     * Does nothing while a batch is open; the batch commit writes once instead.
+     * The caller must hold the exclusive lock, or the shared lock and saveMutex.
+     *
+     * @return true if every pending write succeeded, false otherwise
+     */
+    bool persist();
+
+    /**
+     * @brief Takes the shared lock and saveMutex, then calls persist().
+     * @return true if every pending write succeeded, false otherwise
+     */
+    bool persistShared();
+
+    /**
+     * @brief Takes the shared lock and saveMutex, then saves the rates.
+     *
+     * Rate changes are not part of a batch, so this writes even while one is open.
+     *
+     * @return true if the file was written successfully, false otherwise
+     */
+    bool persistRates();
+
+    /**
+     * @brief Saves the transactions collection.
+     * @return true if the file was written successfully, false otherwise
+     */
+    bool saveTransactions();
+
+    /**
+     * @brief Saves the categories collection.
+     * @return true if the file was written successfully, false otherwise
+     */
+    bool saveCategories();
+
+    /**
+     * @brief Saves the budgets collection.
+     * @return true if the file was written successfully, false otherwise
+     */
+    bool saveBudgets();
+
+    /**
+     * @brief Saves the base currency and exchange rates.
+     * @return true if the file was written successfully, false otherwise
+     */
+    bool saveRates();
+
     /**
      * @brief Gets the file path for transactions data.
      * @return The absolute path to the transactions JSON file
@@ -55,23 +648,47 @@ private:
      */
     std::string getBudgetsFilePath() const;
 
+    /**
+     * @brief Gets the file path for the base currency and exchange rates.
+     * @return The absolute path to the rates JSON file
+     */
+    std::string getRatesFilePath() const;
+
+    /**
+     * @brief Converts the amount of the transaction at a slot into the base currency.
+     * @param slot Position in transactions; its month and currency columns must be set
+     * @return The converted amount
+     */
+    double toBaseAmount(size_t slot) const;
+
+    /**
+     * @brief Recomputes baseAmounts for every transaction after the rates or base currency change.
+     *
+     * Chunks run in parallel, each resolving a rate only when the currency or
+     * month differs from the previous row's. The running totals are then
+     * rebuilt from the new amounts.
+     */
+    void convertAllAmounts();
+
     /**
      * @brief Saves JSON data to a file.
      *
      * @param filePath Path to the file where data will be saved
      * @param jsonData The JSON data to save
+     * @param fileBytes Receives the size of the written file, if not null
      * @return true if the operation was successful, false otherwise
      */
-    bool saveToFile(const std::string &filePath, const json &jsonData) const;
+    bool saveToFile(const std::string &filePath, const json &jsonData, size_t *fileBytes = nullptr) const;
 
     /**
      * @brief Loads JSON data from a file.
      *
      * @param filePath Path to the file from which to load data
      * @param jsonData Reference where the loaded JSON data will be stored
+     * @param fileBytes Receives the size of the file read, or is left alone if there is none; may be null
      * @return true if the operation was successful, false otherwise
      */
-    bool loadFromFile(const std::string &filePath, json &jsonData) const;
+    bool loadFromFile(const std::string &filePath, json &jsonData, size_t *fileBytes = nullptr) const;
 
 public:
     /**
@@ -85,22 +702,35 @@ public:
     /**
      * @brief Adds a new category.
      *
-     * @param category The category to add (ID will be assigned if it's 0)
+     * @param category The category to add (ID will be assigned if it's 0); its parent, if any, must exist
      * @return true if the category was added successfully, false otherwise
      */
     bool addCategory(Category &category);
 
     /**
-     * @brief Updates an existing category.
+     * @brief Updates an existing category's name, description and color.
+     *
+     * The stored parent is kept; use setCategoryParent() to move a category.
      *
      * @param category The category with updated information
      * @return true if the category was updated successfully, false otherwise
      */
     bool updateCategory(const Category &category);
 
+    /**
+     * @brief Moves a category under another parent, leaving its other fields as stored.
+     *
+     * @param categoryId ID of the category to move
+     * @param parentId ID of the new parent, or 0 for a top-level category; may not be the category itself or a descendant
+     * @return true if the category was moved and saved, false otherwise
+     */
+    bool setCategoryParent(int categoryId, int parentId);
+
     /**
      * @brief Deletes a category.
      *
+     * Its children move up to its parent, so the rest of the tree stays in place.
+     *
      * @param categoryId ID of the category to delete
      * @return true if the category was deleted successfully, false otherwise
      */
@@ -110,7 +740,7 @@ public:
      * @brief Gets a category by its ID.
      *
      * @param categoryId ID of the category to retrieve
-     * @return Pointer to the category, or nullptr if not found
+     * @return Pointer to the category, or nullptr if not found; not safe to use while other threads write
      */
     Category *getCategoryById(int categoryId);
 
@@ -133,9 +763,10 @@ public:
      * @brief Updates an existing transaction.
      *
      * @param transaction The transaction with updated information
+     * @param keepTagsAndCurrency Keep the stored tags and currency instead of the ones in transaction
      * @return true if the transaction was updated successfully, false otherwise
      */
-    bool updateTransaction(const Transaction &transaction);
+    bool updateTransaction(const Transaction &transaction, bool keepTagsAndCurrency = false);
 
     /**
      * @brief Deletes a transaction.
@@ -149,10 +780,34 @@ public:
      * @brief Gets a transaction by its ID.
      *
      * @param transactionId ID of the transaction to retrieve
-     * @return Pointer to the transaction, or nullptr if not found
+     * @return Pointer to the transaction, or nullptr if not found; not safe to use while other threads write
      */
     Transaction *getTransactionById(int transactionId);
 
+    /**
+     * @brief Replaces the tags of a transaction.
+     *
+     * @param transactionId ID of the transaction
+     * @param tags The new tags, normalized as by Transaction::setTags()
+     * @return true if the transaction exists and was saved, false otherwise
+     */
+    bool setTransactionTags(int transactionId, const std::vector<std::string> &tags);
+
+    /**
+     * @brief Changes the currency of a transaction, leaving its other fields as stored.
+     *
+     * @param transactionId ID of the transaction
+     * @param currency Currency code, normalized as by Transaction::setCurrency(); empty for the base currency
+     * @return true if the transaction exists and was saved, false otherwise
+     */
+    bool setTransactionCurrency(int transactionId, const std::string &currency);
+
+    /**
+     * @brief Gets every tag in use with the number of transactions carrying it.
+     * @return (tag, count) pairs in tag order
+     */
+    std::vector<std::pair<std::string, size_t>> getTagCounts() const;
+
     /**
      * @brief Gets all transactions.
      * @return Vector containing all transactions
@@ -175,6 +830,277 @@ public:
      */
     std::vector<Transaction> getTransactionsByMonth(const std::string &monthYear) const;
 
+    // Batch operations
+    /**
+     * @brief Adds several transactions with a single index pass and a single save.
+     *
+     * Transactions with ID 0 get a new ID assigned. Either every transaction is
+     * added or none is.
+     *
+     * @param newTransactions The transactions to add; assigned IDs are written back
+     * @return true if all transactions were added successfully, false otherwise
+     */
+    bool addTransactionsBatch(std::vector<Transaction> &newTransactions);
+
+    /**
+     * @brief Adds several transactions in one save, checking each against existing ones.
+     *
+     * A transaction is a duplicate when a stored transaction, or one earlier in
+     * the same batch, has the same date, amount and normalized description.
+     * Lookups are O(1) per row. With DuplicatePolicy::Skip duplicates are not
+     * added and keep ID 0; with DuplicatePolicy::Flag they are added anyway.
+     * Either way they are listed in duplicates.
+     *
+     * @param newTransactions The transactions to add; assigned IDs are written back
+     * @param policy What to do with duplicates
+     * @param duplicates Receives the duplicates found, in batch order
+     * @return true if the non-skipped transactions were added successfully, false otherwise
+     */
+    bool addTransactionsBatch(std::vector<Transaction> &newTransactions, DuplicatePolicy policy,
+                              std::vector<DuplicateMatch> &duplicates);
+
+    /**
+     * @brief Updates several transactions with a single save.
+     *
+     * Either every transaction is updated or none is.
+     *
+     * @param transactions The transactions with updated information
+     * @param keepTagsAndCurrency Keep the stored tags and currency instead of the ones in transactions
+     * @return true if all transactions were updated successfully, false otherwise
+     */
+    bool updateTransactionsBatch(const std::vector<Transaction> &transactions, bool keepTagsAndCurrency = false);
+
+    /**
+     * @brief Deletes several transactions with a single save.
+     *
+     * Either every transaction is deleted or none is.
+     *
+     * @param transactionIds IDs of the transactions to delete
+     * @return true if all transactions were deleted successfully, false otherwise
+     */
+    bool deleteTransactionsBatch(const std::vector<int> &transactionIds);
+
+    /**
+     * @brief Imports a bank statement file.
+     *
+     * The file is parsed in parallel and every valid entry is added in one batch,
+     * with a single save. Invalid entries are skipped and reported in the result,
+     * and so are duplicates of existing transactions unless policy is Allow.
+     *
+     * @param filePath Path of the statement file
+     * @param format Format of the statement
+     * @param result Receives the parsed transactions with their new IDs (0 if skipped),
+     *               the rejected entries and the duplicates
+     * @param policy What to do with entries that duplicate existing transactions
+     * @param dateOrder Field order of dates with the year last, or Detect to decide from the whole file
+     * @return true if the file was read and the valid entries were saved
+     */
+    bool importFile(const std::string &filePath, ImportFormat format, ImportResult &result,
+                    DuplicatePolicy policy = DuplicatePolicy::Allow, DateOrder dateOrder = DateOrder::Detect);
+
+    /**
+     * @brief Streams the transactions matching a filter to a file.
+     *
+     * Rows go straight from the store to a buffered writer, so memory use stays
+     * constant regardless of ledger size. The month and date range are checked
+     * against the month column first and only rows in range are compared by
+     * date string. Writers wait while the export runs; readers do not.
+     *
+     * @param filePath Destination path; replaced only if the export succeeds
+     * @param format Format of the output
+     * @param filter Rows to include
+     * @param rowsWritten Receives the number of rows exported
+     * @return true if the file was written
+     */
+    bool exportTransactions(const std::string &filePath, ExportFormat format, const TransactionFilter &filter,
+                            size_t &rowsWritten) const;
+
+    /**
+     * @brief Opens an explicit batch.
+     *
+     * Until commitBatch() or rollbackBatch() is called, mutations are applied in
+     * memory but not written to disk. The batch belongs to the calling thread:
+     * until it closes, writes, commits and rollbacks from other threads fail
+     * rather than landing in it. Exchange rates are not part of batches and
+     * stay writable.
+     *
+     * @return true if the batch was opened, false if one is already open
+     */
+    bool beginBatch();
+
+    /**
+     * @brief Closes the open batch and writes all changes once.
+     *
+     * If the write fails the batch is rolled back.
+     *
+     * @return true if the batch was committed and saved, false otherwise, including when another thread opened it
+     */
+    bool commitBatch();
+
+    /**
+     * @brief Closes the open batch and discards all of its changes.
+     * @return true if a batch was rolled back, false if none was open or another thread opened it
+     */
+    bool rollbackBatch();
+
+    /**
+     * @brief Checks whether an explicit batch is open.
+     * @return true if a batch is open, false otherwise
+     */
+    bool isBatchActive() const;
+
+    // Change tracking
+    /**
+     * @brief Gets the current data version.
+     *
+     * The version increases with every change to any collection.
+     *
+     * @return The current data version
+     */
+    unsigned long long getDataVersion() const;
+
+    /**
+     * @brief Gets the net changes made after a data version.
+     *
+     * Costs O(changes) while the change log still covers sinceVersion. Otherwise
+     * the result is flagged as a full resync and carries every record.
+     *
+     * @param sinceVersion The data version the client last synchronized to
+     * @return The changes needed to bring the client to the current version
+     */
+    ChangeSet getChangesSince(unsigned long long sinceVersion) const;
+
+    /**
+     * @brief Gets the operation metrics of this manager.
+     *
+     * Metrics are updated without locking and may be read and reset from any
+     * thread.
+     *
+     * @return The metrics
+     */
+    Metrics &getMetrics() const;
+
+    /**
+     * @brief Searches transaction descriptions.
+     *
+     * Matching ignores case and punctuation. Candidates come from the trigram
+     * index and are confirmed against the description; patterns too short for a
+     * trigram fall back to a parallel scan.
+     *
+     * @param query Text to look for
+     * @param prefix true to match only at the start of a word, false to match anywhere
+     * @param filter Month, category and date constraints on the results
+     * @param limit Maximum number of results; 0 for no limit
+     * @return Matching transactions, newest ID first
+     */
+    std::vector<Transaction> searchTransactions(const std::string &query, bool prefix, const TransactionFilter &filter,
+                                                size_t limit) const;
+
+    /**
+     * @brief Suggests descriptions and category names completing a prefix.
+     *
+     * Results are ranked by how often they are used, with recent uses counting
+     * more. Lookups read cached rankings and do not scan transactions.
+     *
+     * @param prefix Text typed so far; case and leading spaces are ignored
+     * @param limit Maximum number of suggestions
+     * @return The best suggestions, best first
+     */
+    std::vector<Suggestion> suggestDescriptions(const std::string &prefix, size_t limit) const;
+
+    /**
+     * @brief Runs a multi-predicate query.
+     *
+     * A planner reads candidates from the most selective of the month,
+     * category and description indexes, or scans every transaction in blocks
+     * when no index narrows the query enough. Either way each candidate is
+     * checked against every predicate.
+     *
+     * @param query The predicates, limit and order
+     * @return Matching transactions in ID order
+     */
+    std::vector<Transaction> queryTransactions(const TransactionQuery &query) const;
+
+    /**
+     * @brief Reports the plan queryTransactions() would use, without running it.
+     * @param query The query
+     * @return The chosen access path and its estimated candidates
+     */
+    QueryPlan explainQuery(const TransactionQuery &query) const;
+
+    /**
+     * @brief Finds the largest transactions matching a query.
+     *
+     * Each partition of the scan keeps a bounded heap of k entries, so the
+     * work is linear in the rows read and the memory is O(k) per partition.
+     * The query's limit and order are ignored. Amounts are ranked in the base
+     * currency; transactions in a currency listed by getUnconvertedCurrencies()
+     * are left out.
+     *
+     * @param scope Which transactions to consider, e.g. one month's expenses
+     * @param k Number of transactions to return
+     * @return Up to k transactions, largest base currency amount first, ties by ID
+     */
+    std::vector<Transaction> getTopTransactions(const TransactionQuery &scope, size_t k) const;
+
+    /**
+     * @brief Computes amount percentiles of the transactions matching a query.
+     *
+     * Amounts are gathered once and each percentile is selected with
+     * nth_element, in expected linear time; requested percentiles are served
+     * in ascending order so each selection only searches above the previous
+     * one. Values interpolate linearly between the closest ranks. Amounts are
+     * in the base currency; transactions in a currency listed by
+     * getUnconvertedCurrencies() are left out.
+     *
+     * @param scope Which transactions to consider; its limit and order are ignored
+     * @param percentiles Percentiles to compute, each from 0 to 100
+     * @param byCategory true for one entry per category, false for a single entry over all
+     * @return The statistics, by category ID; categoryId is -1 for the single overall entry
+     */
+    std::vector<AmountStatistics> getAmountStatistics(const TransactionQuery &scope, const std::vector<double> &percentiles,
+                                                      bool byCategory) const;
+
+    /**
+     * @brief Finds subscriptions, bills and other transactions that recur weekly, monthly or yearly.
+     *
+     * One parallel pass hashes every transaction's series key into shards,
+     * then the shards are merged and analyzed in parallel, so the cost is
+     * linear in the ledger plus a sort of each group. See RecurringDetector
+     * for how candidates are formed and judged.
+     *
+     * @param amountTolerance Largest relative amount difference within a series, e.g. 0.1 for 10%; negative counts as 0
+     * @param minOccurrences Fewest occurrences a series needs; at least 2 are always required
+     * @return The series, ordered by next expected date
+     */
+    std::vector<RecurringSeries> findRecurringTransactions(double amountTolerance, size_t minOccurrences) const;
+
+    /**
+     * @brief Finds groups of stored transactions that duplicate each other.
+     *
+     * Runs in linear time using the fingerprint index.
+     *
+     * @return The IDs of each group of two or more duplicates
+     */
+    std::vector<std::vector<int>> findDuplicateTransactions() const;
+
+    /**
+     * @brief Estimates how much memory this manager holds.
+     *
+     * Sizes are computed from container capacities and string allocations, so
+     * they approximate what the allocator has handed out.
+     *
+     * @return The memory breakdown
+     */
+    MemoryStats getMemoryStats() const;
+
+    /**
+     * @brief Releases spare capacity in record storage, indexes and logs.
+     *
+     * Useful after bulk deletes. The undo log is left alone while a batch is open.
+     */
+    void compact();
+
     // Budget operations
     /**
      * @brief Adds a new budget.
@@ -206,7 +1132,7 @@ public:
      *
      * @param categoryId Category ID of the budget to retrieve
      * @param monthYear Month and year of the budget to retrieve
-     * @return Pointer to the budget, or nullptr if not found
+     * @return Pointer to the budget, or nullptr if not found; not safe to use while other threads write
      */
     Budget *getBudget(int categoryId, const std::string &monthYear);
 
@@ -224,6 +1150,30 @@ public:
      */
     std::vector<Budget> getBudgetsByMonth(const std::string &monthYear) const;
 
+    /**
+     * @brief Compares budgets with actual spending.
+     *
+     * Expense totals per category and month are kept up to date as
+     * transactions change, so this is a single pass over the budgets probing
+     * those totals, with no transaction scan.
+     *
+     * @param fromMonth First "YYYY-MM" month to include, or empty for no lower bound
+     * @param toMonth Last "YYYY-MM" month to include, or empty for no upper bound
+     * @return One entry per budget in the range, by month and then category
+     */
+    std::vector<BudgetVariance> getBudgetVariance(const std::string &fromMonth, const std::string &toMonth) const;
+
+    /**
+     * @brief Takes the over-budget alerts queued since the last call.
+     *
+     * An alert is queued when an added or changed transaction, or a new or
+     * reduced budget, takes a category's spending in a month from within its
+     * budget to over it. Alerts of a rolled-back batch are discarded.
+     *
+     * @return The alerts, oldest first
+     */
+    std::vector<BudgetAlert> takeBudgetAlerts();
+
     // File operations
     /**
      * @brief Saves all data to persistent storage.
@@ -237,12 +1187,71 @@ public:
      */
     bool loadAllData();
 
+    // Currency operations
+    /**
+     * @brief Sets the currency the analysis functions report in.
+     *
+     * Exchange rates are read as base currency units per unit of each
+     * currency, so they should be re-entered after the base changes.
+     * Transactions without a currency are taken to be in the base currency.
+     * Like rates, the base currency is saved immediately and is not undone
+     * by rollbackBatch().
+     *
+     * @param currency The currency code, e.g. "USD"
+     * @return true if the setting was saved, false otherwise
+     */
+    bool setBaseCurrency(const std::string &currency);
+
+    /**
+     * @brief Gets the currency the analysis functions report in.
+     * @return The uppercase code; empty if none was set
+     */
+    std::string getBaseCurrency() const;
+
+    /**
+     * @brief Sets the rate of a currency from a date on.
+     *
+     * Every transaction's base amount is recomputed in one parallel pass.
+     *
+     * @param currency The currency code
+     * @param date First "YYYY-MM-DD" date the rate applies
+     * @param rate Base currency units per unit of the currency; must be positive
+     * @return true if the rate is valid and was saved, false otherwise
+     */
+    bool setExchangeRate(const std::string &currency, const std::string &date, double rate);
+
+    /**
+     * @brief Removes the rate of a currency on a date.
+     *
+     * @param currency The currency code
+     * @param date The date the rate was set for
+     * @return true if the rate existed and the change was saved, false otherwise
+     */
+    bool removeExchangeRate(const std::string &currency, const std::string &date);
+
+    /**
+     * @brief Gets every exchange rate.
+     * @return The rates, ordered by currency, then date
+     */
+    std::vector<ExchangeRate> getExchangeRates() const;
+
+    /**
+     * @brief Lists currencies that transactions use but that have no rate into the base currency.
+     *
+     * Transactions in these currencies are left out of every base currency
+     * total, budget, time series, top list, amount statistic and amount
+     * filter until a rate is set for them.
+     *
+     * @return Currency code to the number of transactions in it
+     */
+    std::map<std::string, size_t> getUnconvertedCurrencies() const;
+
     // Analysis functions
     /**
      * @brief Gets total income for a specific month.
      *
      * @param monthYear Month and year in "YYYY-MM" format
-     * @return The total income for the specified month
+     * @return The total income for the specified month, in the base currency
      */
     double getTotalIncome(const std::string &monthYear) const;
 
@@ -250,7 +1259,7 @@ public:
      * @brief Gets total expenses for a specific month.
      *
      * @param monthYear Month and year in "YYYY-MM" format
-     * @return The total expenses for the specified month
+     * @return The total expenses for the specified month, in the base currency
      */
     double getTotalExpense(const std::string &monthYear) const;
 
@@ -259,25 +1268,86 @@ public:
      *
      * @param categoryId ID of the category to analyze
      * @param monthYear Month and year in "YYYY-MM" format
-     * @return The net amount (income minus expenses) for the specified category and month
+     * @return The net amount (income minus expenses) for the specified category and month, in the base currency
      */
     double getCategoryTotal(int categoryId, const std::string &monthYear) const;
 
     /**
      * @brief Gets spending totals by category for a specific month.
      *
+     * Each transaction is converted at its month's rate in the same pass that
+     * adds it up, reading the base amount column kept alongside the records.
+     *
      * @param monthYear Month and year in "YYYY-MM" format
-     * @return Map of category IDs to their total amounts
+     * @return Map of category IDs to their total amounts in the base currency
      */
     std::map<int, double> getCategoryTotals(const std::string &monthYear) const;
 
+    /**
+     * @brief Gets the totals of every category and of its subtree.
+     *
+     * Per-category totals come from the running totals the record operations
+     * maintain, and subtrees are summed in one pass from the deepest
+     * categories up, so no transaction is read however deep the hierarchy.
+     * Transactions of unknown categories are left out, and amounts are in the
+     * base currency.
+     *
+     * @param monthYear Month and year in "YYYY-MM" format, or empty for all time
+     * @return One entry per category, parents before their children
+     */
+    std::vector<CategoryRollup> getCategoryRollups(const std::string &monthYear) const;
+
+    /**
+     * @brief Gets the net amount of a category and all its descendants.
+     *
+     * @param categoryId ID of the category at the top of the subtree
+     * @param monthYear Month and year in "YYYY-MM" format, or empty for all time
+     * @return Income minus expenses of the subtree; 0 if the category does not exist
+     */
+    double getCategorySubtreeTotal(int categoryId, const std::string &monthYear) const;
+
     /**
      * @brief Gets monthly totals for income or expenses.
      *
      * @param isIncome Whether to get totals for income (true) or expenses (false)
-     * @return Map of months ("YYYY-MM") to their total amounts
+     * @return Map of months ("YYYY-MM") to their total amounts in the base currency
      */
     std::map<std::string, double> getMonthlyTotals(bool isIncome) const;
+
+    /**
+     * @brief Computes the dashboard totals of a range of months together.
+     *
+     * Income, expenses and per-category totals of every month come from one
+     * pass, over the month index when the range holds few transactions and
+     * over the month column otherwise, and budgets are joined in afterwards.
+     * Dates without a regular "YYYY-MM" prefix are not counted. Amounts are
+     * converted into the base currency.
+     *
+     * @param fromMonth First month, "YYYY-MM"
+     * @param toMonth Last month, "YYYY-MM"
+     * @param bundle Receives the report
+     * @return true if both months are valid and fromMonth is not after toMonth
+     */
+    bool getReportBundle(const std::string &fromMonth, const std::string &toMonth, ReportBundle &bundle) const;
+
+    /**
+     * @brief Builds a time series of income, expenses, running balance and moving averages.
+     *
+     * Every value is a difference of two entries of the per-day prefix sums,
+     * so the series costs O(buckets) and reads no transactions. Buckets are
+     * clipped to the range. As in the month reports, transactions whose date
+     * is not a valid "YYYY-MM-DD" within the years DailyLedger tracks are not
+     * counted.
+     *
+     * @param fromDate First day, "YYYY-MM-DD"
+     * @param toDate Last day, "YYYY-MM-DD"
+     * @param interval Bucket size
+     * @param windowDays Length of the moving-average window in days; 0 leaves the averages at zero
+     * @param series Receives one point per bucket, in order
+     * @return true if both dates are valid and fromDate is not after toDate
+     */
+    bool getTimeSeries(const std::string &fromDate, const std::string &toDate, SeriesInterval interval, int windowDays,
+                       std::vector<SeriesPoint> &series) const;
 };
 
 // JSON serialization helpers
@@ -0,0 +1,139 @@
+/**
+ * @file DuplicateIndex.h
+ * @brief Defines the DuplicateIndex class used to detect duplicate transactions.
+ */
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Transaction.h"
+
+/**
+ * @enum DuplicatePolicy
+ * @brief What batch inserts and imports do with transactions that already exist.
+ */
+enum class DuplicatePolicy
+{
+    Allow, /**< Insert duplicates without reporting them */
+    Skip,  /**< Leave duplicates out and report them */
+    Flag   /**< Insert duplicates and report them */
+};
+
+/**
+ * @struct DuplicateMatch
+ * @brief A transaction found to duplicate an existing one.
+ */
+struct DuplicateMatch
+{
+    size_t index;            /**< Position of the transaction in the submitted batch */
+    int existingId;          /**< ID of a stored transaction with the same fingerprint */
+    Transaction transaction; /**< The submitted transaction */
+};
+
+/**
+ * @class DuplicateIndex
+ * @brief Fingerprint index answering "does this transaction already exist?" in O(1).
+ *
+ * A transaction's fingerprint hashes its date, signed amount in cents and its
+ * description normalized to lower-case words. Lookups first test a Bloom
+ * filter, which rejects most new transactions without touching the hash table;
+ * candidates that pass are confirmed against an exact fingerprint-to-ID table.
+ * Distinct transactions sharing a 64-bit fingerprint are treated as duplicates.
+ */
+class DuplicateIndex
+{
+public:
+    /**
+     * @brief Constructs an empty index.
+     */
+    DuplicateIndex();
+
+    /**
+     * @brief Computes the fingerprint of a transaction.
+     *
+     * @param transaction The transaction
+     * @return Its 64-bit fingerprint
+     */
+    static uint64_t fingerprint(const Transaction &transaction);
+
+    /**
+     * @brief Normalizes a description for comparison.
+     *
+     * Letters are lower-cased, runs of anything other than letters and digits
+     * become a single space, and leading and trailing spaces are dropped.
+     *
+     * @param description The description
+     * @return The normalized description
+     */
+    static std::string normalizeDescription(const std::string &description);
+
+    /**
+     * @brief Adds a stored transaction.
+     *
+     * @param fingerprint The transaction's fingerprint
+     * @param id The transaction's ID
+     */
+    void add(uint64_t fingerprint, int id);
+
+    /**
+     * @brief Removes a stored transaction.
+     *
+     * @param fingerprint The transaction's fingerprint
+     * @param id The transaction's ID
+     */
+    void remove(uint64_t fingerprint, int id);
+
+    /**
+     * @brief Finds a stored transaction with the given fingerprint.
+     *
+     * @param fingerprint The fingerprint to look up
+     * @return The ID of a matching transaction, or 0 if there is none
+     */
+    int find(uint64_t fingerprint) const;
+
+    /**
+     * @brief Groups stored transactions that share a fingerprint.
+     * @return The IDs of each group of two or more duplicates
+     */
+    std::vector<std::vector<int>> findGroups() const;
+
+    /**
+     * @brief Removes every entry and prepares for the given number of transactions.
+     * @param expectedCount Number of transactions about to be added
+     */
+    void reset(size_t expectedCount);
+
+    /**
+     * @brief Estimates the memory held by the index.
+     * @return Approximate size in bytes
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    static const int kHashCount = 4;     /**< Bloom filter probes per fingerprint */
+    static const int kBitsPerEntry = 10; /**< Bloom filter bits per expected entry, about 1% false positives */
+
+    std::vector<uint64_t> bloomBits;                   /**< Bloom filter bit array */
+    size_t bloomCapacity;                              /**< Entries the filter was sized for */
+    std::unordered_multimap<uint64_t, int> entries;    /**< Fingerprint to ID of every stored transaction */
+
+    /**
+     * @brief Sizes the Bloom filter for a number of entries and refills it.
+     * @param capacity Number of entries to size for
+     */
+    void resizeBloom(size_t capacity);
+
+    /**
+     * @brief Sets the filter bits of a fingerprint.
+     * @param fingerprint The fingerprint
+     */
+    void setBloomBits(uint64_t fingerprint);
+
+    /**
+     * @brief Tests whether every filter bit of a fingerprint is set.
+     *
+     * @param fingerprint The fingerprint
+     * @return false if the fingerprint is certainly absent
+     */
+    bool testBloomBits(uint64_t fingerprint) const;
+};
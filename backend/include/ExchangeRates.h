@@ -0,0 +1,160 @@
+/**
+ * @file ExchangeRates.h
+ * @brief Defines the ExchangeRates class, a dated table of conversion rates into a base currency.
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @struct ExchangeRate
+ * @brief The value of one unit of a currency in the base currency, from a date on.
+ */
+struct ExchangeRate
+{
+    std::string currency; /**< Currency code, e.g. "EUR" */
+    std::string date;     /**< First date the rate applies, "YYYY-MM-DD" */
+    double rate;          /**< Base currency units per unit of the currency */
+};
+
+/**
+ * @class ExchangeRates
+ * @brief Dated rates of each currency against the base currency, resolved and cached per month.
+ *
+ * Currency codes are interned to small indexes so a ledger can keep one
+ * index per transaction; index 0 stands for transactions without a currency,
+ * which are already in the base currency. A month converts at the latest
+ * rate dated on or before its last day, or at the earliest rate if the month
+ * predates them all; dates without a month use the latest rate. Resolved
+ * rates are cached per (currency, month), so converting a run of
+ * transactions costs one lookup per change of currency or month. The base
+ * currency itself converts at 1; any other currency without a rate cannot be
+ * converted and resolves to 0, so it drops out of base currency totals
+ * instead of being counted at face value.
+ */
+class ExchangeRates
+{
+public:
+    /**
+     * @brief Constructs a table with no base currency and no rates.
+     */
+    ExchangeRates();
+
+    /**
+     * @brief Normalizes a currency code: trimmed and uppercase.
+     * @param code The code
+     * @return The normalized code; empty if nothing is left
+     */
+    static std::string normalizeCode(const std::string &code);
+
+    /**
+     * @brief Gets the currency every rate converts into.
+     * @return The normalized base currency code; empty if none was set
+     */
+    const std::string &getBaseCurrency() const;
+
+    /**
+     * @brief Changes the currency every rate converts into.
+     *
+     * Existing rates are kept; they are expected to be re-entered against
+     * the new base.
+     *
+     * @param code The base currency code
+     */
+    void setBaseCurrency(const std::string &code);
+
+    /**
+     * @brief Gets or assigns the index of a currency.
+     * @param code A normalized currency code
+     * @return The index; 0 for an empty code
+     */
+    uint16_t intern(const std::string &code);
+
+    /**
+     * @brief Gets the code of an interned currency.
+     * @param currency Index from intern()
+     * @return The normalized code; empty for index 0
+     */
+    const std::string &getCode(uint16_t currency) const;
+
+    /**
+     * @brief Checks whether a currency can be converted into the base currency.
+     * @param currency Index from intern()
+     * @return true for index 0, the base currency and any currency with at least one rate
+     */
+    bool isConvertible(uint16_t currency) const;
+
+    /**
+     * @brief Sets the rate of a currency from a date on, replacing any rate on that date.
+     *
+     * @param code The currency code
+     * @param date First "YYYY-MM-DD" date the rate applies
+     * @param rate Base currency units per unit of the currency; must be positive
+     * @return true if the rate was stored, false if an argument is invalid
+     */
+    bool setRate(const std::string &code, const std::string &date, double rate);
+
+    /**
+     * @brief Removes the rate of a currency on a date.
+     *
+     * @param code The currency code
+     * @param date The date the rate was set for
+     * @return true if the rate existed
+     */
+    bool removeRate(const std::string &code, const std::string &date);
+
+    /**
+     * @brief Lists every rate.
+     * @return The rates, ordered by currency code, then date
+     */
+    std::vector<ExchangeRate> getRates() const;
+
+    /**
+     * @brief Gets the rate converting a currency into the base currency in a month.
+     *
+     * Safe to call from several threads at once while the table is not modified.
+     *
+     * @param currency Index from intern()
+     * @param monthKey Month key (YYYYMM), or -1 for a date without a month
+     * @return Base currency units per unit of the currency; 0 if it is not convertible
+     */
+    double monthlyRate(uint16_t currency, int monthKey) const;
+
+    /**
+     * @brief Removes every rate and the base currency; interned codes keep their indexes.
+     */
+    void clear();
+
+    /**
+     * @brief Estimates the memory held by the table and its cache.
+     * @return Approximate size in bytes
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    std::string baseCurrency;                           /**< Currency the rates convert into */
+    std::vector<std::string> codes;                     /**< Code of each index; codes[0] is empty */
+    std::unordered_map<std::string, uint16_t> indexes;  /**< Code to index */
+    std::vector<std::map<std::string, double>> rates;   /**< Rates by date, per index */
+    mutable std::mutex cacheMutex;                      /**< Guards monthCache */
+    mutable std::unordered_map<uint64_t, double> monthCache; /**< Resolved rate by (index, month key) */
+
+    /**
+     * @brief Resolves a rate without the cache.
+     *
+     * @param currency The currency index
+     * @param monthKey The month key, or -1
+     * @return The rate
+     */
+    double resolve(uint16_t currency, int monthKey) const;
+
+    /**
+     * @brief Drops every cached rate.
+     */
+    void invalidate();
+};
@@ -0,0 +1,111 @@
+/**
+ * @file LatencyHistogram.h
+ * @brief Defines the LatencyHistogram class for recording operation latencies.
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "BudgetTrackerExport.h"
+
+/**
+ * @class LatencyHistogram
+ * @brief Log-linear (HDR-style) histogram of nanosecond latencies.
+ *
+ * Each power of two is split into 32 linear sub-buckets, which bounds the
+ * relative error of any reported percentile to about 3%. Recording is a few
+ * relaxed atomic increments, so one histogram can be shared by many threads.
+ */
+class BUDGETTRACKER_API LatencyHistogram
+{
+public:
+    /**
+     * @brief Constructs an empty histogram.
+     */
+    LatencyHistogram();
+
+    /**
+     * @brief Copies a snapshot of another histogram.
+     * @param other The histogram to copy
+     */
+    LatencyHistogram(const LatencyHistogram &other);
+
+    /**
+     * @brief Replaces the contents with a snapshot of another histogram.
+     *
+     * @param other The histogram to copy
+     * @return This histogram
+     */
+    LatencyHistogram &operator=(const LatencyHistogram &other);
+
+    /**
+     * @brief Records one latency.
+     * @param nanos The latency in nanoseconds
+     */
+    void record(uint64_t nanos);
+
+    /**
+     * @brief Adds every sample of another histogram to this one.
+     * @param other The histogram to merge in
+     */
+    void merge(const LatencyHistogram &other);
+
+    /**
+     * @brief Discards every recorded sample.
+     */
+    void reset();
+
+    /**
+     * @brief Gets the number of recorded samples.
+     * @return The sample count
+     */
+    uint64_t getCount() const;
+
+    /**
+     * @brief Gets the largest recorded latency.
+     * @return The maximum in nanoseconds, or 0 if empty
+     */
+    uint64_t getMax() const;
+
+    /**
+     * @brief Gets the mean recorded latency.
+     * @return The mean in nanoseconds, or 0 if empty
+     */
+    double getMean() const;
+
+    /**
+     * @brief Gets a latency percentile.
+     *
+     * @param percentile Percentile between 0 and 100, e.g. 99.9
+     * @return The percentile in nanoseconds, or 0 if empty
+     */
+    uint64_t getPercentile(double percentile) const;
+
+private:
+    static const int kSubBucketBits = 5;                         /**< log2 of sub-buckets per power of two */
+    static const uint64_t kSubBucketCount = 1 << kSubBucketBits; /**< Sub-buckets per power of two */
+    static const int kMaxExponent = 40;                          /**< Values above 2^40 ns (~18 min) are clamped */
+    static const size_t kBucketCount = (kMaxExponent - kSubBucketBits + 2) * kSubBucketCount; /**< Total buckets */
+
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets; /**< Sample count per bucket */
+    std::atomic<uint64_t> count;                             /**< Total number of samples */
+    std::atomic<uint64_t> sum;                               /**< Sum of all samples */
+    std::atomic<uint64_t> max;                               /**< Largest sample */
+
+    /**
+     * @brief Maps a latency to its bucket.
+     *
+     * @param nanos The latency in nanoseconds
+     * @return The bucket index
+     */
+    static size_t bucketIndex(uint64_t nanos);
+
+    /**
+     * @brief Gets the value reported for a bucket (its midpoint).
+     *
+     * @param index The bucket index
+     * @return The representative latency in nanoseconds
+     */
+    static uint64_t bucketValue(size_t index);
+};
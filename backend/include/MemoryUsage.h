@@ -0,0 +1,20 @@
+/**
+ * @file MemoryUsage.h
+ * @brief Helpers shared by the getMemoryUsage() estimates of the model classes.
+ */
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Gets the heap bytes behind a string.
+ *
+ * Short strings live inside the object itself, so they count as zero.
+ *
+ * @param value The string
+ * @return The heap allocation, including the terminator
+ */
+inline size_t stringHeapSize(const std::string &value)
+{
+    return value.capacity() > std::string().capacity() ? value.capacity() + 1 : 0;
+}
@@ -0,0 +1,193 @@
+/**
+ * @file Metrics.h
+ * @brief Defines the Metrics class that collects per-operation statistics.
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "LatencyHistogram.h"
+#include "Tracer.h"
+
+/**
+ * @enum MetricOperation
+ * @brief Instrumented operations, each with its own latency histogram.
+ */
+enum class MetricOperation
+{
+    LoadAllData,
+    SaveAllData,
+    Persist,
+    ReadFile,
+    WriteFile,
+    AddTransaction,
+    UpdateTransaction,
+    DeleteTransaction,
+    TransactionsBatch,
+    AddCategory,
+    UpdateCategory,
+    DeleteCategory,
+    AddBudget,
+    UpdateBudget,
+    DeleteBudget,
+    CommitBatch,
+    GetAllTransactions,
+    GetTransactionsByCategory,
+    GetTransactionsByMonth,
+    GetTotalIncome,
+    GetTotalExpense,
+    GetCategoryTotal,
+    GetCategoryTotals,
+    GetMonthlyTotals,
+    GetChangesSince,
+    ImportFile,
+    ExportTransactions,
+    SearchTransactions,
+    SuggestDescriptions,
+    QueryTransactions,
+    GetReportBundle,
+    GetBudgetVariance,
+    GetTopTransactions,
+    GetAmountStatistics,
+    GetTimeSeries,
+    FindRecurringTransactions,
+    GetCategoryRollups,
+    SerializeResult,
+    Count
+};
+
+/**
+ * @enum MetricCounter
+ * @brief Instrumented volume counters.
+ */
+enum class MetricCounter
+{
+    RowsScanned,     /**< Rows visited by queries and aggregations */
+    RowsReturned,    /**< Rows returned by queries */
+    BytesSerialized, /**< JSON bytes produced for files and C API results */
+    BytesWritten,    /**< Bytes written to data files */
+    BytesRead,       /**< Bytes read from data files */
+    Count
+};
+
+/**
+ * @class Metrics
+ * @brief Call counts, latency histograms and volume counters for one DataManager.
+ *
+ * Every update is a handful of relaxed atomic operations and never takes a
+ * lock, so the instrumentation stays enabled in production builds.
+ */
+class Metrics
+{
+public:
+    /**
+     * @class Timer
+     * @brief Records the lifetime of a scope into an operation's histogram.
+     *
+     * When tracing is on, the scope is also recorded as a trace span named after
+     * the operation.
+     */
+    class Timer
+    {
+    public:
+        /**
+         * @brief Starts timing an operation.
+         *
+         * @param metrics The metrics to record into
+         * @param operation The operation being timed
+         */
+        Timer(Metrics &metrics, MetricOperation operation);
+
+        /**
+         * @brief Records the elapsed time.
+         */
+        ~Timer();
+
+        Timer(const Timer &) = delete;
+        Timer &operator=(const Timer &) = delete;
+
+        /**
+         * @brief Gets the trace span covering this scope, for attaching arguments.
+         * @return The span
+         */
+        TraceSpan &trace()
+        {
+            return span;
+        }
+
+    private:
+        Metrics &metrics;                                 /**< Destination metrics */
+        MetricOperation operation;                        /**< Operation being timed */
+        std::chrono::steady_clock::time_point startTime; /**< When the scope was entered */
+        TraceSpan span;                                   /**< Trace span for the same scope */
+    };
+
+    /**
+     * @brief Constructs empty metrics.
+     */
+    Metrics();
+
+    Metrics(const Metrics &) = delete;
+    Metrics &operator=(const Metrics &) = delete;
+
+    /**
+     * @brief Records one call of an operation.
+     *
+     * @param operation The operation
+     * @param nanos Its latency in nanoseconds
+     */
+    void record(MetricOperation operation, uint64_t nanos);
+
+    /**
+     * @brief Adds to a volume counter.
+     *
+     * @param counter The counter
+     * @param amount The amount to add
+     */
+    void add(MetricCounter counter, uint64_t amount);
+
+    /**
+     * @brief Gets the latency histogram of an operation.
+     *
+     * @param operation The operation
+     * @return Its histogram; the call count is the histogram's sample count
+     */
+    const LatencyHistogram &getHistogram(MetricOperation operation) const;
+
+    /**
+     * @brief Gets the value of a volume counter.
+     *
+     * @param counter The counter
+     * @return The counter value
+     */
+    uint64_t getCounter(MetricCounter counter) const;
+
+    /**
+     * @brief Clears every histogram and counter.
+     */
+    void reset();
+
+    /**
+     * @brief Gets the name used for an operation in reports.
+     *
+     * @param operation The operation
+     * @return The operation name
+     */
+    static const char *operationName(MetricOperation operation);
+
+    /**
+     * @brief Gets the name used for a counter in reports.
+     *
+     * @param counter The counter
+     * @return The counter name
+     */
+    static const char *counterName(MetricCounter counter);
+
+private:
+    static const size_t kOperationCount = static_cast<size_t>(MetricOperation::Count);
+    static const size_t kCounterCount = static_cast<size_t>(MetricCounter::Count);
+
+    std::array<LatencyHistogram, kOperationCount> histograms; /**< Latency per operation */
+    std::array<std::atomic<uint64_t>, kCounterCount> counters; /**< Volume counters */
+};
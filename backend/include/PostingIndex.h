@@ -0,0 +1,80 @@
+/**
+ * @file PostingIndex.h
+ * @brief Defines the PostingIndex class that maps integer keys to transaction IDs.
+ */
+#pragma once
+#include <cstddef>
+#include <map>
+#include <vector>
+
+/**
+ * @class PostingIndex
+ * @brief Ordered map from an integer key, such as a month or category, to the sorted IDs of its transactions.
+ *
+ * Transaction IDs grow over time, so adding new transactions appends to the
+ * posting lists; updates and deletes insert into or erase from the middle.
+ * Keys are kept in order so a range of months can be visited without
+ * touching the others.
+ */
+class PostingIndex
+{
+public:
+    /**
+     * @brief Adds a transaction under a key.
+     *
+     * @param key The key
+     * @param id The transaction ID
+     */
+    void add(int key, int id);
+
+    /**
+     * @brief Removes a transaction from a key, dropping the key once it is empty.
+     *
+     * @param key The key it was added under
+     * @param id The transaction ID
+     */
+    void remove(int key, int id);
+
+    /**
+     * @brief Gets the transactions under a key.
+     * @param key The key
+     * @return The sorted IDs, or nullptr if no transaction has the key
+     */
+    const std::vector<int> *find(int key) const;
+
+    /**
+     * @brief Counts the transactions under a key.
+     * @param key The key
+     * @return The number of IDs
+     */
+    size_t count(int key) const;
+
+    /**
+     * @brief Gets the posting lists of every key in a range.
+     *
+     * @param first Smallest key to include
+     * @param last Largest key to include
+     * @param lists Receives one sorted ID list per key present, in key order
+     * @return The total number of IDs in the lists
+     */
+    size_t findRange(int first, int last, std::vector<const std::vector<int> *> &lists) const;
+
+    /**
+     * @brief Removes every entry.
+     */
+    void clear();
+
+    /**
+     * @brief Releases spare capacity of every posting list.
+     */
+    void shrinkToFit();
+
+    /**
+     * @brief Estimates the memory held by the index.
+     * @return Approximate size in bytes
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    std::map<int, std::vector<int>> postings; /**< Key to sorted transaction IDs */
+};
@@ -0,0 +1,122 @@
+/**
+ * @file RecurringDetector.h
+ * @brief Defines the RecurringDetector class that finds subscriptions and other recurring transactions.
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @enum RecurrencePeriod
+ * @brief How often a recurring series repeats.
+ */
+enum class RecurrencePeriod
+{
+    Weekly,
+    Monthly,
+    Yearly
+};
+
+/**
+ * @brief Gets the name of a period, as reported by the C API.
+ * @param period The period
+ * @return "weekly", "monthly" or "yearly"
+ */
+const char *recurrencePeriodName(RecurrencePeriod period);
+
+/**
+ * @struct RecurringOccurrence
+ * @brief One transaction considered for a recurring series.
+ */
+struct RecurringOccurrence
+{
+    size_t slot;   /**< Position of the transaction in the DataManager's storage */
+    int day;       /**< Transaction date as days since 1970-01-01 */
+    double amount; /**< Transaction amount */
+};
+
+/**
+ * @struct RecurringSeries
+ * @brief Transactions that repeat with a similar description, amount and interval.
+ */
+struct RecurringSeries
+{
+    std::string description;          /**< Description of the latest occurrence */
+    int categoryId;                   /**< Category of the latest occurrence */
+    bool isIncome;                    /**< Whether the series is income */
+    RecurrencePeriod period;          /**< Detected period */
+    double amount;                    /**< Median amount */
+    double meanInterval;              /**< Mean days between occurrences */
+    double intervalDeviation;         /**< Standard deviation of the days between occurrences */
+    double regularity;                /**< Fraction of intervals close to the period, from 0 to 1 */
+    std::string firstDate;            /**< Date of the first occurrence, "YYYY-MM-DD" */
+    std::string lastDate;             /**< Date of the latest occurrence, "YYYY-MM-DD" */
+    std::string nextDate;             /**< Expected date of the next occurrence, "YYYY-MM-DD" */
+    std::vector<int> transactionIds;  /**< IDs of the occurrences, oldest first */
+};
+
+/**
+ * @class RecurringDetector
+ * @brief Groups transactions into candidate series and tests each for a weekly, monthly or yearly rhythm.
+ *
+ * Transactions are grouped by a hash of their description with words that
+ * contain digits removed, so reference numbers do not split a series, and of
+ * their income flag. Within a group, amounts are sorted and split wherever
+ * one exceeds the first of its band by more than the tolerance, so a
+ * merchant's subscription and its one-off purchases form separate candidates.
+ * A candidate is reported when the median gap between occurrences falls in a
+ * period's range and most gaps are close to that period.
+ */
+class RecurringDetector
+{
+public:
+    /**
+     * @brief Normalizes a description into its grouping key.
+     *
+     * As DuplicateIndex::normalizeDescription(), but words containing a digit
+     * are dropped; "Netflix #4411" and "NETFLIX 4412" both become "netflix".
+     *
+     * @param description The description
+     * @return The key; empty if no word is left
+     */
+    static std::string seriesKey(const std::string &description);
+
+    /**
+     * @brief Hashes a grouping key.
+     *
+     * @param key Key from seriesKey()
+     * @param isIncome The transaction's income flag
+     * @return 64-bit hash of both
+     */
+    static uint64_t groupHash(const std::string &key, bool isIncome);
+
+    /**
+     * @brief Finds the recurring series within one group.
+     *
+     * Only the timing and amount fields of each series are filled in, along
+     * with the slots of its occurrences; the caller resolves descriptions,
+     * categories and IDs from the slots.
+     *
+     * @param occurrences Transactions of the group, in any order; reordered
+     * @param amountTolerance Largest relative difference from the smallest amount of a band, e.g. 0.1 for 10%
+     * @param minOccurrences Fewest occurrences a series needs
+     * @param series Receives one entry per series found
+     * @param slots Receives the slots of each series' occurrences, oldest first, parallel to series
+     */
+    static void detect(std::vector<RecurringOccurrence> &occurrences, double amountTolerance, size_t minOccurrences,
+                       std::vector<RecurringSeries> &series, std::vector<std::vector<size_t>> &slots);
+
+private:
+    static constexpr double kMinRegularity = 0.75; /**< Fraction of gaps that must be close to the period */
+
+    /**
+     * @brief Tests one amount band for a period.
+     *
+     * @param band Occurrences of the band, sorted by day
+     * @param series Receives the series if one is found
+     * @return true if the band recurs
+     */
+    static bool analyzeBand(const std::vector<RecurringOccurrence> &band, RecurringSeries &series);
+};
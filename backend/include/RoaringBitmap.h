@@ -0,0 +1,139 @@
+/**
+ * @file RoaringBitmap.h
+ * @brief Defines the RoaringBitmap class, a compressed set of 32-bit integers.
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class RoaringBitmap
+ * @brief Compressed set of non-negative integers with fast set operations, after the Roaring layout.
+ *
+ * Values are split by their high 16 bits into containers holding the low 16
+ * bits. A container with up to kArrayLimit values is a sorted array; a fuller
+ * one is a 65536-bit bitmap. Sparse sets therefore cost two bytes per value and
+ * dense ones an eighth of a byte, and set operations work container by
+ * container, using word-wide AND, OR and AND-NOT between bitmaps.
+ */
+class RoaringBitmap
+{
+public:
+    static const size_t kArrayLimit = 4096; /**< Most values an array container holds */
+
+    /**
+     * @brief Adds a value.
+     * @param value The value
+     */
+    void add(uint32_t value);
+
+    /**
+     * @brief Adds ascending values, appending to the last container while it matches.
+     * @param values Values in ascending order, each non-negative
+     */
+    void addSorted(const std::vector<int> &values);
+
+    /**
+     * @brief Removes a value.
+     * @param value The value
+     */
+    void remove(uint32_t value);
+
+    /**
+     * @brief Checks whether a value is present.
+     * @param value The value
+     * @return true if the value was added and not removed
+     */
+    bool contains(uint32_t value) const;
+
+    /**
+     * @brief Counts the values.
+     * @return The number of values
+     */
+    size_t cardinality() const;
+
+    /**
+     * @brief Checks whether the set is empty.
+     * @return true if there are no values
+     */
+    bool empty() const;
+
+    /**
+     * @brief Keeps only the values also in another set.
+     * @param other The other set
+     */
+    void intersectWith(const RoaringBitmap &other);
+
+    /**
+     * @brief Adds every value of another set.
+     * @param other The other set
+     */
+    void unionWith(const RoaringBitmap &other);
+
+    /**
+     * @brief Removes every value of another set.
+     * @param other The other set
+     */
+    void subtract(const RoaringBitmap &other);
+
+    /**
+     * @brief Lists the values.
+     * @param values Receives the values in ascending order
+     */
+    void toVector(std::vector<int> &values) const;
+
+    /**
+     * @brief Removes every value.
+     */
+    void clear();
+
+    /**
+     * @brief Releases spare capacity of every container.
+     */
+    void shrinkToFit();
+
+    /**
+     * @brief Estimates the memory held by the set.
+     * @return Approximate size in bytes
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    static const size_t kBitmapWords = 1024; /**< 64-bit words of a bitmap container */
+
+    /**
+     * @struct Container
+     * @brief The low 16 bits of the values sharing one high half.
+     */
+    struct Container
+    {
+        std::vector<uint16_t> array; /**< Sorted values, while the container is an array */
+        std::vector<uint64_t> bits;  /**< kBitmapWords words, once the container is a bitmap */
+        uint32_t count;              /**< Number of values */
+
+        bool isBitmap() const { return !bits.empty(); }
+    };
+
+    std::vector<uint16_t> keys;        /**< High halves present, ascending */
+    std::vector<Container> containers; /**< Container of each key, parallel to keys */
+
+    /**
+     * @brief Turns an array container into a bitmap once it exceeds kArrayLimit values.
+     * @param container The container
+     */
+    static void toBitmapIfFull(Container &container);
+
+    /**
+     * @brief Turns a bitmap container back into an array once it holds kArrayLimit values or fewer.
+     * @param container The container
+     */
+    static void toArrayIfSparse(Container &container);
+
+    /**
+     * @brief Finds or inserts the container of a high half.
+     * @param key The high 16 bits
+     * @return The container
+     */
+    Container &containerFor(uint16_t key);
+};
@@ -0,0 +1,244 @@
+/**
+ * @file StatementImporter.h
+ * @brief Defines the StatementImporter class that parses bank statement files.
+ */
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Transaction.h"
+#include "Category.h"
+#include "DuplicateIndex.h"
+
+/**
+ * @enum ImportFormat
+ * @brief Supported bank statement formats.
+ */
+enum class ImportFormat
+{
+    Csv,
+    Ofx,
+    Qif
+};
+
+/**
+ * @enum DateOrder
+ * @brief Field order of dates written with the year last, such as 03/02/2024.
+ */
+enum class DateOrder
+{
+    Detect,     /**< Decide once per file from every date in it */
+    MonthFirst, /**< MM/DD/YYYY */
+    DayFirst    /**< DD/MM/YYYY */
+};
+
+/**
+ * @struct ImportError
+ * @brief A statement entry that could not be imported.
+ */
+struct ImportError
+{
+    size_t line;         /**< 1-based line where the entry starts */
+    std::string message; /**< Why the entry was rejected */
+};
+
+/**
+ * @struct ImportResult
+ * @brief Transactions parsed from a statement and the entries that were rejected.
+ */
+struct ImportResult
+{
+    std::vector<Transaction> transactions;  /**< Valid entries, in file order, with ID 0 */
+    std::vector<size_t> lines;              /**< Line each valid entry starts on, parallel to transactions */
+    std::vector<ImportError> errors;        /**< Rejected entries, in file order */
+    std::vector<DuplicateMatch> duplicates; /**< Valid entries matching existing transactions, filled in by DataManager::importFile */
+};
+
+/**
+ * @class StatementImporter
+ * @brief Parses CSV, OFX and QIF statements into transactions.
+ *
+ * The file is read in one pass and split into entries serially, which is a
+ * cheap byte scan; the entries are then parsed, validated and date-normalized
+ * in parallel on the shared ThreadPool. Results keep file order regardless of
+ * the thread count.
+ *
+ * CSV files need a header row. Recognized columns (case-insensitive) are date,
+ * amount or value, debit/withdrawal and credit/deposit, type, description,
+ * payee, name, memo or details, and category (a name) or categoryId. The
+ * delimiter (comma, semicolon or tab) is detected from the header. A negative
+ * amount is an expense unless a type column says otherwise. Category names
+ * that match no existing category leave the transaction uncategorized (ID 0).
+ *
+ * Dates with the year last are read in one field order for the whole file.
+ * With DateOrder::Detect, a date such as 13/02 means day first and 02/13
+ * month first; a file with both, or with only dates that read either way,
+ * is rejected with a single error on line 0 rather than guessed row by row.
+ */
+class StatementImporter
+{
+public:
+    /**
+     * @brief Constructs an importer that resolves category names against the given categories.
+     *
+     * @param categories Existing categories; names are matched case-insensitively
+     * @param dateOrder Field order of dates with the year last, or Detect to decide per file
+     */
+    explicit StatementImporter(const std::vector<Category> &categories, DateOrder dateOrder = DateOrder::Detect);
+
+    /**
+     * @brief Parses a statement file.
+     *
+     * @param filePath Path of the file to read
+     * @param format Format of the file
+     * @param result Receives the parsed transactions and rejected entries
+     * @return true if the file was read, false if it could not be opened
+     */
+    bool parseFile(const std::string &filePath, ImportFormat format, ImportResult &result) const;
+
+    /**
+     * @brief Parses statement text already in memory.
+     *
+     * @param text The statement contents
+     * @param format Format of the text
+     * @param result Receives the parsed transactions and rejected entries
+     */
+    void parse(const std::string &text, ImportFormat format, ImportResult &result) const;
+
+    /**
+     * @brief Resolves a format name, falling back to the file extension.
+     *
+     * @param name "csv", "ofx", "qfx" or "qif" in any case, or empty to use the extension
+     * @param filePath The file being imported
+     * @param format Receives the resolved format
+     * @return true if the format is known
+     */
+    static bool resolveFormat(const std::string &name, const std::string &filePath, ImportFormat &format);
+
+    /**
+     * @brief Converts a statement date to "YYYY-MM-DD".
+     *
+     * Accepts YYYY-MM-DD, YYYY/MM/DD, YYYYMMDD (with an optional OFX time
+     * suffix), MM/DD/YYYY or DD/MM/YYYY as given by order, DD.MM.YYYY and QIF
+     * forms such as 1/5'24.
+     *
+     * @param text The date as written in the statement
+     * @param isoDate Receives the normalized date
+     * @param order Field order of dates with the year last; Detect reads them month first
+     * @return true if the text is a valid date in that order
+     */
+    static bool normalizeDate(const std::string &text, std::string &isoDate, DateOrder order = DateOrder::MonthFirst);
+
+    /**
+     * @brief Decides the field order of a set of dates.
+     *
+     * Only dates with the year last and a '/', '-' or ' ' separator take part;
+     * one whose first field exceeds 12 is day first, one whose second field
+     * does is month first.
+     *
+     * @param dates The dates as written in the statement
+     * @param order Receives the order; MonthFirst if no date has the year last
+     * @param error Receives why the order cannot be decided
+     * @return false if the dates disagree or every such date reads both ways
+     */
+    static bool detectDateOrder(const std::vector<std::string> &dates, DateOrder &order, std::string &error);
+
+    /**
+     * @brief Parses a statement amount.
+     *
+     * Currency symbols, spaces and thousands separators are ignored; a leading
+     * minus sign or surrounding parentheses make the amount negative.
+     *
+     * @param text The amount as written in the statement
+     * @param value Receives the signed amount
+     * @return true if the text is a valid amount
+     */
+    static bool parseAmount(const std::string &text, double &value);
+
+private:
+    /**
+     * @struct Entry
+     * @brief The bytes of one statement entry.
+     */
+    struct Entry
+    {
+        size_t begin; /**< Offset of the first byte */
+        size_t end;   /**< Offset one past the last byte */
+        size_t line;  /**< 1-based line of the first byte */
+    };
+
+    /**
+     * @struct CsvLayout
+     * @brief Column positions found in a CSV header; -1 when absent.
+     */
+    struct CsvLayout
+    {
+        char delimiter;
+        int date;
+        int amount;
+        int debit;
+        int credit;
+        int type;
+        int description;
+        int memo;
+        int category;
+        int categoryId;
+    };
+
+    std::unordered_map<std::string, int> categoryIds; /**< Category IDs by lower-case name */
+    DateOrder dateOrder;                              /**< Order given to the constructor */
+
+    /**
+     * @brief Settles the date order of one file, reading the raw dates in parallel when detecting.
+     *
+     * @param entries The file's entries
+     * @param rawDate Called as rawDate(entry) to get an entry's date text
+     * @param order Receives the order to parse with
+     * @param result Receives the file-level error if the order cannot be decided
+     * @return true if the entries can be parsed
+     */
+    template <typename RawDate>
+    bool resolveDateOrder(const std::vector<Entry> &entries, RawDate rawDate, DateOrder &order, ImportResult &result) const;
+
+    /**
+     * @brief Parses every entry in parallel, keeping file order.
+     *
+     * @param entries The entries to parse
+     * @param parseEntry Called as parseEntry(entry, transaction, error); returns false to reject
+     * @param result Receives the outcome
+     */
+    template <typename ParseEntry>
+    void parseEntries(const std::vector<Entry> &entries, ParseEntry parseEntry, ImportResult &result) const;
+
+    /**
+     * @brief Parses a CSV statement.
+     *
+     * @param text The statement contents
+     * @param result Receives the outcome
+     */
+    void parseCsv(const std::string &text, ImportResult &result) const;
+
+    /**
+     * @brief Parses an OFX or QFX statement.
+     *
+     * @param text The statement contents
+     * @param result Receives the outcome
+     */
+    void parseOfx(const std::string &text, ImportResult &result) const;
+
+    /**
+     * @brief Parses a QIF statement.
+     *
+     * @param text The statement contents
+     * @param result Receives the outcome
+     */
+    void parseQif(const std::string &text, ImportResult &result) const;
+
+    /**
+     * @brief Looks up a category by name.
+     *
+     * @param name The category name in any case
+     * @return The category ID, or 0 if no category has that name
+     */
+    int findCategory(const std::string &name) const;
+};
@@ -0,0 +1,230 @@
+/**
+ * @file SuggestionIndex.h
+ * @brief Defines the SuggestionIndex class that autocompletes descriptions and category names.
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Transaction.h"
+#include "Category.h"
+
+/**
+ * @struct Suggestion
+ * @brief One autocomplete result.
+ */
+struct Suggestion
+{
+    std::string text; /**< Description or category name, as last written */
+    bool isCategory;  /**< true for a category name, false for a description */
+    int categoryId;   /**< The category, or the category most recently used with the description */
+    uint32_t count;   /**< Transactions using the description or category */
+};
+
+/**
+ * @class SuggestionIndex
+ * @brief Radix tree over distinct descriptions and category names, ranked by decayed frequency.
+ *
+ * Keys are the texts lower-cased and trimmed, so different spellings of the
+ * same description share one entry. Each use of an entry adds a weight that
+ * doubles every kHalfLifeDays of the transaction date, so the sum ranks
+ * entries by frequency with recent use counting more, and the order never
+ * changes merely because time passes. Every inner node caches its subtree's
+ * kCachedSuggestions best entries, so a lookup is a walk down the prefix plus
+ * a copy; leaves, which hold only their own entries, rank them on demand. Adding a use touches only the nodes above its entry; removing one
+ * recomputes those nodes from their children's caches.
+ */
+class SuggestionIndex
+{
+public:
+    static const size_t kCachedSuggestions = 16; /**< Best entries cached per node */
+    static const int kHalfLifeDays = 90;         /**< Age at which a use counts half */
+
+    /**
+     * @brief Constructs an empty index.
+     */
+    SuggestionIndex();
+
+    /**
+     * @brief Rebuilds the index from every transaction and category.
+     *
+     * Counts are accumulated first and the node caches are filled in one
+     * bottom-up pass, which is much cheaper than adding the uses one by one.
+     *
+     * @param transactions All transactions
+     * @param categories All categories
+     */
+    void rebuild(const std::vector<Transaction> &transactions, const std::vector<Category> &categories);
+
+    /**
+     * @brief Records a use of a transaction's description and category.
+     * @param transaction The added transaction
+     */
+    void addTransaction(const Transaction &transaction);
+
+    /**
+     * @brief Withdraws a use recorded by addTransaction().
+     * @param transaction The removed transaction, as it was added
+     */
+    void removeTransaction(const Transaction &transaction);
+
+    /**
+     * @brief Adds a category name with no uses.
+     * @param category The added category
+     */
+    void addCategory(const Category &category);
+
+    /**
+     * @brief Moves a category's entry to its new name, keeping its uses.
+     * @param category The updated category
+     */
+    void updateCategory(const Category &category);
+
+    /**
+     * @brief Removes a category name.
+     * @param categoryId ID of the removed category
+     */
+    void removeCategory(int categoryId);
+
+    /**
+     * @brief Finds the best entries starting with a prefix.
+     *
+     * @param prefix Text typed so far; case and leading spaces are ignored
+     * @param limit Maximum number of results
+     * @return The best matches, best first
+     */
+    std::vector<Suggestion> suggest(const std::string &prefix, size_t limit) const;
+
+    /**
+     * @brief Estimates the memory held by the index.
+     * @return Approximate size in bytes
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    /**
+     * @struct Entry
+     * @brief A distinct description or category name.
+     */
+    struct Entry
+    {
+        std::string text; /**< Display text */
+        int node;         /**< Radix tree node where the key ends */
+        bool isCategory;  /**< Category name rather than description */
+        int categoryId;   /**< Category ID, or latest category used with the description */
+        int lastId;       /**< Newest transaction ID that used the entry */
+        uint32_t count;   /**< Number of uses */
+        double score;     /**< Sum of the recency weights of the uses */
+    };
+
+    /**
+     * @struct Node
+     * @brief A radix tree node.
+     */
+    struct Node
+    {
+        uint32_t labelStart;              /**< Offset in labels of the bytes on the edge from the parent */
+        uint32_t labelLength;             /**< Number of bytes on the edge from the parent */
+        int parent;                       /**< Parent node, -1 for the root */
+        int descriptionEntry;             /**< Description entry ending here, -1 if none */
+        std::vector<int> children;        /**< Child nodes, sorted by the first byte of their label */
+        std::vector<int> categoryEntries; /**< Category entries ending here; names need not be unique */
+        std::vector<int> top;             /**< Best entries in the subtree, best first; empty for leaves */
+    };
+
+    std::vector<Node> nodes;                     /**< Radix tree, root at index 0 */
+    std::string labels;                          /**< Edge labels of every node; splitting an edge only moves offsets */
+    std::vector<Entry> entries;                  /**< Entries, some of them free */
+    std::vector<int> freeEntries;                /**< Indexes of free entries */
+    std::unordered_map<int, int> categoryLookup; /**< Category ID to its entry */
+
+    /**
+     * @brief Lower-cases and trims text into a tree key.
+     *
+     * @param text The text
+     * @param trimEnd Whether to drop trailing spaces; prefixes keep them
+     * @return The key
+     */
+    static std::string toKey(const std::string &text, bool trimEnd);
+
+    /**
+     * @brief Computes the weight one use on a date adds to a score.
+     * @param date Date in "YYYY-MM-DD" format
+     * @return 2 raised to the number of half-lives since 2000-01-01; 1 for a date DailyLedger does not track
+     */
+    static double recencyWeight(const std::string &date);
+
+    /**
+     * @brief Checks whether one entry ranks above another.
+     *
+     * @param a Index of the first entry
+     * @param b Index of the second entry
+     * @return true if a ranks above b
+     */
+    bool ranksAbove(int a, int b) const;
+
+    /**
+     * @brief Finds or creates the node where a key ends.
+     * @param key The key
+     * @return Index of the node
+     */
+    int insertKey(const std::string &key);
+
+    /**
+     * @brief Finds the node whose subtree holds every key starting with a prefix.
+     * @param prefix The prefix key
+     * @return Index of the node, or -1 if no key starts with the prefix
+     */
+    int findPrefix(const std::string &prefix) const;
+
+    /**
+     * @brief Allocates an entry ending at a node.
+     *
+     * @param node The node
+     * @param text Display text
+     * @param isCategory Category name rather than description
+     * @return Index of the entry
+     */
+    int createEntry(int node, const std::string &text, bool isCategory);
+
+    /**
+     * @brief Detaches an entry from its node and frees it.
+     * @param entry Index of the entry
+     */
+    void releaseEntry(int entry);
+
+    /**
+     * @brief Moves an entry up the caches from its node to the root after its score grew.
+     * @param entry Index of the entry
+     */
+    void promote(int entry);
+
+    /**
+     * @brief Recomputes the caches from a node to the root after a score shrank.
+     * @param node Index of the deepest changed node
+     */
+    void refresh(int node);
+
+    /**
+     * @brief Recomputes one node's cache from its own entries and its children's caches.
+     * @param node Index of the node
+     */
+    void recomputeTop(int node);
+
+    /**
+     * @brief Gets a node's best entries, from its cache or, for a leaf, its own entries.
+     *
+     * @param node Index of the node
+     * @param ranked Receives the entries, best first
+     */
+    void rankEntries(int node, std::vector<int> &ranked) const;
+
+    /**
+     * @brief Collects every entry in a subtree.
+     *
+     * @param node Root of the subtree
+     * @param found Receives the entry indexes
+     */
+    void collectEntries(int node, std::vector<int> &found) const;
+};
@@ -0,0 +1,77 @@
+/**
+ * @file TagIndex.h
+ * @brief Defines the TagIndex class that maps tags to compressed sets of transaction IDs.
+ */
+#pragma once
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+#include "RoaringBitmap.h"
+
+/**
+ * @class TagIndex
+ * @brief Ordered map from a tag to a RoaringBitmap of the IDs of the transactions carrying it.
+ *
+ * The index also keeps the IDs of every indexed transaction, so a query that
+ * only excludes tags can start from the full set and subtract, without
+ * visiting the rows.
+ */
+class TagIndex
+{
+public:
+    /**
+     * @brief Adds a transaction under each of its tags.
+     *
+     * @param id The transaction ID
+     * @param tags The transaction's normalized tags
+     */
+    void add(int id, const std::vector<std::string> &tags);
+
+    /**
+     * @brief Removes a transaction from each of its tags, dropping tags left empty.
+     *
+     * @param id The transaction ID
+     * @param tags The tags it was added with
+     */
+    void remove(int id, const std::vector<std::string> &tags);
+
+    /**
+     * @brief Gets the transactions carrying a tag.
+     * @param tag The normalized tag
+     * @return The IDs, or nullptr if no transaction has the tag
+     */
+    const RoaringBitmap *find(const std::string &tag) const;
+
+    /**
+     * @brief Gets every indexed transaction.
+     * @return The IDs of all transactions, tagged or not
+     */
+    const RoaringBitmap &all() const;
+
+    /**
+     * @brief Lists every tag with the number of transactions carrying it.
+     * @param counts Receives (tag, count) pairs in tag order
+     */
+    void getTagCounts(std::vector<std::pair<std::string, size_t>> &counts) const;
+
+    /**
+     * @brief Removes every entry.
+     */
+    void clear();
+
+    /**
+     * @brief Releases spare capacity of every bitmap.
+     */
+    void shrinkToFit();
+
+    /**
+     * @brief Estimates the memory held by the index.
+     * @return Approximate size in bytes
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    std::map<std::string, RoaringBitmap> bitmaps; /**< Tag to the IDs carrying it */
+    RoaringBitmap allIds;                         /**< IDs of every indexed transaction */
+};
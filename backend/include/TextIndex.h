@@ -0,0 +1,107 @@
+/**
+ * @file TextIndex.h
+ * @brief Defines the TextIndex class used to search transaction descriptions.
+ */
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class TextIndex
+ * @brief Trigram inverted index over transaction descriptions.
+ *
+ * Descriptions are normalized to lower-case words separated by single spaces,
+ * with a leading space marking the start of the first word. Every distinct
+ * three-byte sequence of the normalized text maps to the sorted IDs of the
+ * transactions containing it, so trigrams that span a leading space identify
+ * word starts. A query is answered by intersecting the postings of its own
+ * trigrams, which yields a small candidate set that the caller confirms
+ * against the actual text.
+ */
+class TextIndex
+{
+public:
+    /**
+     * @brief Normalizes text for indexing and matching.
+     *
+     * ASCII letters are lower-cased, bytes outside ASCII are kept so accented
+     * text still matches, and runs of other characters become one space. The
+     * result starts with a space unless it is empty and never ends with one.
+     *
+     * @param text The text
+     * @return The normalized text
+     */
+    static std::string normalize(const std::string &text);
+
+    /**
+     * @brief Adds a transaction's description.
+     *
+     * Adding IDs in ascending order appends to the postings; any other order
+     * inserts into them.
+     *
+     * @param id The transaction ID
+     * @param description The description
+     */
+    void add(int id, const std::string &description);
+
+    /**
+     * @brief Removes a transaction's description.
+     *
+     * @param id The transaction ID
+     * @param description The description it was added with
+     */
+    void remove(int id, const std::string &description);
+
+    /**
+     * @brief Visits the transactions whose description may contain a pattern.
+     *
+     * Candidates are produced newest ID first by walking the rarest posting list
+     * backwards and probing the others with binary search, so a caller that
+     * only needs the first few matches stops early instead of intersecting the
+     * full lists.
+     *
+     * @param pattern Normalized text to look for, with a leading space to require a word start
+     * @param visit Called with each candidate ID; returns false to stop
+     * @return false if the pattern is shorter than a trigram and the index cannot narrow it
+     */
+    bool visitCandidates(const std::string &pattern, const std::function<bool(int)> &visit) const;
+
+    /**
+     * @brief Bounds the number of candidates visitCandidates() would produce.
+     *
+     * @param pattern Normalized text to look for
+     * @param estimate Receives the length of the rarest posting list of the pattern
+     * @return false if the pattern is shorter than a trigram and the index cannot narrow it
+     */
+    bool estimateCandidates(const std::string &pattern, size_t &estimate) const;
+
+    /**
+     * @brief Removes every entry.
+     */
+    void clear();
+
+    /**
+     * @brief Releases spare capacity of every posting list.
+     */
+    void shrinkToFit();
+
+    /**
+     * @brief Estimates the memory held by the index.
+     * @return Approximate size in bytes
+     */
+    size_t getMemoryUsage() const;
+
+private:
+    std::unordered_map<uint32_t, std::vector<int>> postings; /**< Trigram to sorted transaction IDs */
+
+    /**
+     * @brief Collects the distinct trigrams of normalized text.
+     *
+     * @param normalized Normalized text
+     * @param trigrams Receives the trigrams, sorted and without repeats
+     */
+    static void collectTrigrams(const std::string &normalized, std::vector<uint32_t> &trigrams);
+};
@@ -0,0 +1,147 @@
+/**
+ * @file ThreadPool.h
+ * @brief Defines the ThreadPool class used to parallelize analysis scans.
+ */
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Work-stealing thread pool shared by every DataManager.
+ *
+ * Each worker owns a task deque. Workers pop from the back of their own deque
+ * and steal from the front of the others when they run dry. Callers waiting on
+ * a parallelFor() execute pending tasks themselves, so nested use from inside a
+ * task cannot deadlock.
+ */
+class ThreadPool
+{
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Constructs a pool with the given number of worker threads.
+     *
+     * @param threadCount Number of workers; 0 uses the hardware concurrency
+     */
+    explicit ThreadPool(size_t threadCount = 0);
+
+    /**
+     * @brief Stops and joins all workers after draining queued tasks.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief Gets the pool shared by all DataManager instances.
+     * @return The process-wide pool
+     */
+    static ThreadPool &shared();
+
+    /**
+     * @brief Replaces the workers with a new set of the given size.
+     *
+     * Waits for parallel work that is already running to finish first.
+     *
+     * @param threadCount Number of workers; 0 uses the hardware concurrency
+     */
+    void setThreadCount(size_t threadCount);
+
+    /**
+     * @brief Gets the number of worker threads.
+     * @return The number of workers
+     */
+    size_t getThreadCount() const;
+
+    /**
+     * @brief Queues a task for execution on a worker.
+     * @param task The task to run
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Runs body over [0, count) split into fixed-size chunks.
+     *
+     * Chunk boundaries depend only on count and grainSize, never on the thread
+     * count, so per-chunk partial results reduced in chunk order are identical
+     * across runs. Inputs no larger than one chunk, or a pool with a single
+     * worker, run inline on the calling thread.
+     *
+     * @param count Number of items
+     * @param grainSize Items per chunk
+     * @param body Called as body(chunkIndex, begin, end) for every chunk
+     */
+    void parallelFor(size_t count, size_t grainSize,
+                     const std::function<void(size_t, size_t, size_t)> &body);
+
+    /**
+     * @brief Gets the number of chunks parallelFor() will use.
+     *
+     * @param count Number of items
+     * @param grainSize Items per chunk
+     * @return The number of chunks
+     */
+    static size_t chunkCount(size_t count, size_t grainSize);
+
+private:
+    /**
+     * @struct Worker
+     * @brief A worker thread and its task deque.
+     */
+    struct Worker
+    {
+        std::deque<Task> tasks; /**< Pending tasks, owner pops from the back */
+        std::mutex mutex;       /**< Guards tasks */
+        std::thread thread;     /**< The worker thread */
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers; /**< All workers */
+    mutable std::shared_mutex resizeMutex;        /**< Held shared while work runs, exclusive while resizing */
+    std::mutex poolMutex;                         /**< Guards wakeups */
+    std::condition_variable wakeup;               /**< Signalled when tasks are queued */
+    std::atomic<size_t> pending;                  /**< Number of queued, not yet started tasks */
+    std::atomic<size_t> nextQueue;                /**< Round-robin cursor for submissions */
+    bool stopping;                                /**< Set when workers should exit */
+
+    /**
+     * @brief Starts the given number of workers.
+     * @param threadCount Number of workers; 0 uses the hardware concurrency
+     */
+    void start(size_t threadCount);
+
+    /**
+     * @brief Drains the queues and joins all workers.
+     */
+    void stop();
+
+    /**
+     * @brief Main loop of a worker thread.
+     * @param index Index of the worker
+     */
+    void workerLoop(size_t index);
+
+    /**
+     * @brief Queues a task; the caller must hold resizeMutex.
+     * @param task The task to run
+     */
+    void enqueue(Task task);
+
+    /**
+     * @brief Takes one task, preferring the given worker's own deque.
+     *
+     * @param index Index of the worker to pop from first
+     * @param task Receives the task
+     * @return true if a task was taken, false if all deques are empty
+     */
+    bool takeTask(size_t index, Task &task);
+};
@@ -0,0 +1,196 @@
+/**
+ * @file Tracer.h
+ * @brief Defines the Tracer and TraceSpan classes for Chrome trace-event export.
+ */
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct TraceEvent
+ * @brief One completed span.
+ */
+struct TraceEvent
+{
+    const char *name;                                        /**< Span name, a string literal */
+    const char *category;                                    /**< Span category, a string literal */
+    double startMicros;                                      /**< Start time relative to when tracing began */
+    double durationMicros;                                   /**< Duration of the span */
+    uint32_t threadId;                                       /**< Small sequential id of the recording thread */
+    std::vector<std::pair<const char *, std::string>> args; /**< Argument name and JSON-encoded value */
+};
+
+/**
+ * @class Tracer
+ * @brief Process-wide collector of trace spans, written as Chrome trace-event JSON.
+ *
+ * The resulting file loads in chrome://tracing and Perfetto. Tracing starts
+ * when the BUDGET_TRACKER_TRACE environment variable names an output file, or
+ * through start(). While tracing is off a span costs one relaxed atomic load.
+ */
+class Tracer
+{
+public:
+    /**
+     * @brief Gets the process-wide tracer.
+     * @return The tracer
+     */
+    static Tracer &instance();
+
+    /**
+     * @brief Checks whether spans are currently being recorded.
+     * @return true if tracing is on
+     */
+    static bool isEnabled()
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Starts recording, discarding any unwritten events.
+     *
+     * @param filePath File the trace is written to when tracing stops
+     * @return true if tracing started, false if it was already running
+     */
+    bool start(const std::string &filePath);
+
+    /**
+     * @brief Stops recording and writes the trace file.
+     * @return true if the file was written, false if tracing was off or the write failed
+     */
+    bool stop();
+
+    /**
+     * @brief Adds a completed span; dropped if tracing stopped meanwhile.
+     * @param event The span
+     */
+    void record(TraceEvent &&event);
+
+    /**
+     * @brief Gets the current time on the trace clock.
+     * @return Microseconds since tracing started
+     */
+    double now() const;
+
+    /**
+     * @brief Gets a small sequential id for the calling thread.
+     * @return The thread id
+     */
+    static uint32_t currentThreadId();
+
+    /**
+     * @brief Writes any pending trace on shutdown.
+     */
+    ~Tracer();
+
+    Tracer(const Tracer &) = delete;
+    Tracer &operator=(const Tracer &) = delete;
+
+private:
+    static const size_t kMaxEvents = 1000000; /**< Events beyond this are counted but not kept */
+
+    static std::atomic<bool> enabled;               /**< Whether spans are recorded */
+    std::mutex mutex;                               /**< Guards the members below */
+    std::string filePath;                           /**< Output file */
+    std::atomic<int64_t> originNanos;               /**< Time zero of the trace on the steady clock */
+    std::vector<TraceEvent> events;                 /**< Recorded spans */
+    size_t droppedEvents;                           /**< Spans discarded once the buffer was full */
+
+    /**
+     * @brief Constructs the tracer and starts it if the environment asks for it.
+     */
+    Tracer();
+
+    /**
+     * @brief Writes the recorded events; the caller holds mutex.
+     * @return true if the file was written
+     */
+    bool writeFile();
+};
+
+/**
+ * @class TraceSpan
+ * @brief Records the lifetime of a scope as a trace span when tracing is on.
+ */
+class TraceSpan
+{
+public:
+    /**
+     * @brief Opens a span.
+     *
+     * @param name Span name; must be a string literal or otherwise outlive the trace
+     * @param category Span category, with the same lifetime requirement
+     */
+    TraceSpan(const char *name, const char *category)
+        : active(Tracer::isEnabled())
+    {
+        if (active)
+        {
+            begin(name, category);
+        }
+    }
+
+    /**
+     * @brief Closes the span and hands it to the tracer.
+     */
+    ~TraceSpan()
+    {
+        if (active)
+        {
+            end();
+        }
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+    /**
+     * @brief Checks whether this span is being recorded.
+     *
+     * Callers can test this before computing expensive arguments.
+     *
+     * @return true if the span will be recorded
+     */
+    bool isActive() const
+    {
+        return active;
+    }
+
+    /**
+     * @brief Attaches a numeric argument; ignored when the span is inactive.
+     *
+     * @param key Argument name, a string literal
+     * @param value Argument value
+     */
+    void addArg(const char *key, long long value);
+
+    /**
+     * @brief Attaches a string argument; ignored when the span is inactive.
+     *
+     * @param key Argument name, a string literal
+     * @param value Argument value
+     */
+    void addArg(const char *key, const std::string &value);
+
+private:
+    bool active;      /**< Whether tracing was on when the span opened */
+    TraceEvent event; /**< The span being built */
+
+    /**
+     * @brief Fills in the start of the span.
+     *
+     * @param name Span name
+     * @param category Span category
+     */
+    void begin(const char *name, const char *category);
+
+    /**
+     * @brief Measures the span and hands it to the tracer.
+     */
+    void end();
+};
@@ -4,17 +4,19 @@
  */
 #pragma once
 #include <string>
+#include <vector>
 #include <ctime>
+#include "BudgetTrackerExport.h"
 
 /**
  * @class Transaction
  * @brief Represents a financial transaction in the budget tracking system.
  *
  * The Transaction class stores details about financial activities, including
- * the date, amount, description, associated category, and whether it represents
- * income or expense.
+ * the date, amount and its currency, description, associated category, whether
+ * it represents income or expense, and any free-form tags.
  */
-class Transaction
+class BUDGETTRACKER_API Transaction
 {
 private:
     int id;                  /**< Unique identifier for the transaction */
@@ -23,6 +25,8 @@ private:
     std::string description; /**< Description of the transaction */
     int categoryId;          /**< ID of the category associated with the transaction */
     bool isIncome;           /**< Flag indicating if this is income (true) or expense (false) */
+    std::vector<std::string> tags; /**< Normalized tags, sorted and unique */
+    std::string currency;    /**< Currency code of the amount; empty for the ledger's base currency */
 
 public:
     /**
@@ -80,6 +84,18 @@ public:
      */
     bool getIsIncome() const;
 
+    /**
+     * @brief Gets the transaction tags.
+     * @return The tags, lowercase, sorted and without duplicates
+     */
+    const std::vector<std::string> &getTags() const;
+
+    /**
+     * @brief Gets the currency of the amount.
+     * @return The uppercase currency code, or empty for the base currency
+     */
+    const std::string &getCurrency() const;
+
     // Setters
     /**
      * @brief Sets the transaction identifier.
@@ -117,9 +133,38 @@ public:
      */
     void setIsIncome(bool isIncome);
 
+    /**
+     * @brief Sets the transaction tags.
+     *
+     * Each tag is trimmed and lowercased; empty tags are dropped and the rest
+     * are sorted with duplicates removed.
+     *
+     * @param tags The new tags
+     */
+    void setTags(const std::vector<std::string> &tags);
+
+    /**
+     * @brief Normalizes a tag as setTags() does.
+     * @param tag The tag
+     * @return The trimmed, lowercase tag; empty if nothing is left
+     */
+    static std::string normalizeTag(const std::string &tag);
+
+    /**
+     * @brief Sets the currency of the amount.
+     * @param currency Currency code such as "EUR", trimmed and uppercased; empty for the base currency
+     */
+    void setCurrency(const std::string &currency);
+
     /**
      * @brief Generates a string representation of this Transaction.
      * @return A string representation for debugging purposes
      */
     std::string toString() const;
+
+    /**
+     * @brief Gets the heap memory owned by this Transaction's strings.
+     * @return Bytes allocated outside the object for string contents
+     */
+    size_t getHeapSize() const;
 };
\ No newline at end of file
@@ -0,0 +1,176 @@
+/**
+ * @file TransactionExporter.h
+ * @brief Defines the TransactionExporter class that streams transactions to a file.
+ */
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Transaction.h"
+#include "Category.h"
+
+/**
+ * @enum ExportFormat
+ * @brief Supported export file formats.
+ */
+enum class ExportFormat
+{
+    Csv,
+    Ndjson,
+    Columnar
+};
+
+/**
+ * @struct TransactionFilter
+ * @brief Row filter applied while scanning transactions; empty fields match everything.
+ */
+struct TransactionFilter
+{
+    std::string monthYear; /**< Only this "YYYY-MM" month */
+    int categoryId = -1;   /**< Only this category; -1 for any, 0 for uncategorized */
+    std::string fromDate;  /**< Only dates on or after this "YYYY-MM-DD" */
+    std::string toDate;    /**< Only dates on or before this "YYYY-MM-DD" */
+};
+
+/**
+ * @class TransactionExporter
+ * @brief Writes transactions one at a time to a CSV, NDJSON or columnar file.
+ *
+ * Rows are formatted into a fixed-size buffer that is flushed to disk when it
+ * fills, so memory use does not grow with the number of rows. Output goes to a
+ * temporary file that replaces the destination only when close() succeeds.
+ *
+ * CSV and NDJSON rows carry id, date, amount, description, categoryId,
+ * categoryName, isIncome, the currency code, empty for the base currency,
+ * and the tags: a JSON array in NDJSON, one field separated by semicolons in
+ * CSV. The columnar format stores rows in groups of up to kRowGroupSize, each column
+ * contiguous, in host byte order:
+ *
+ *     file   := "BTCOLS03" group* footer
+ *     group  := u32 rows, i32 id[rows], strings date, f64 amount[rows],
+ *               strings description, i32 categoryId[rows], u8 isIncome[rows],
+ *               strings tags, strings currency
+ *     strings:= u32 offset[rows + 1], then the concatenated bytes
+ *     footer := u32 0, u64 totalRows, "BTCOLS03"
+ *
+ * A row's tags entry is each of its tags followed by a NUL byte, so a row
+ * without tags is empty.
+ */
+class TransactionExporter
+{
+public:
+    static const size_t kRowGroupSize = 65536; /**< Rows per columnar group */
+
+    /**
+     * @brief Constructs an exporter that labels rows with the given categories.
+     *
+     * @param format Format of the output
+     * @param categories Existing categories, used for the categoryName field
+     */
+    TransactionExporter(ExportFormat format, const std::vector<Category> &categories);
+
+    /**
+     * @brief Removes the temporary file if close() was never called.
+     */
+    ~TransactionExporter();
+
+    TransactionExporter(const TransactionExporter &) = delete;
+    TransactionExporter &operator=(const TransactionExporter &) = delete;
+
+    /**
+     * @brief Starts writing to a file and emits the format header.
+     *
+     * @param filePath Destination path
+     * @return true if the temporary file was created
+     */
+    bool open(const std::string &filePath);
+
+    /**
+     * @brief Appends one transaction.
+     *
+     * @param transaction The transaction to write
+     */
+    void write(const Transaction &transaction);
+
+    /**
+     * @brief Flushes the remaining rows and moves the file into place.
+     *
+     * @return true if every byte was written and the file was renamed
+     */
+    bool close();
+
+    /**
+     * @brief Gets the number of rows written so far.
+     * @return The row count
+     */
+    uint64_t getRowCount() const;
+
+    /**
+     * @brief Gets the number of bytes written to disk so far.
+     * @return The byte count
+     */
+    uint64_t getBytesWritten() const;
+
+    /**
+     * @brief Resolves a format name, falling back to the file extension.
+     *
+     * @param name "csv", "ndjson"/"jsonl" or "columnar"/"btcol" in any case, or empty to use the extension
+     * @param filePath The destination file
+     * @param format Receives the resolved format
+     * @return true if the format is known
+     */
+    static bool resolveFormat(const std::string &name, const std::string &filePath, ExportFormat &format);
+
+private:
+    ExportFormat format;                                 /**< Format being written */
+    std::unordered_map<int, std::string> categoryNames; /**< Category names by ID */
+    std::string filePath;                                /**< Destination path */
+    std::string tempPath;                                /**< Path being written until close() */
+    std::ofstream file;                                  /**< The temporary file */
+    std::string buffer;                                  /**< Bytes not yet written to file */
+    uint64_t rowCount;                                   /**< Rows written */
+    uint64_t bytesWritten;                               /**< Bytes flushed to file */
+
+    // Column buffers of the current columnar row group
+    std::vector<int32_t> ids;
+    std::vector<uint32_t> dateOffsets;
+    std::string dates;
+    std::vector<double> amounts;
+    std::vector<uint32_t> descriptionOffsets;
+    std::string descriptions;
+    std::vector<int32_t> categoryIds;
+    std::vector<uint8_t> incomeFlags;
+    std::vector<uint32_t> tagOffsets;
+    std::string tags;
+    std::vector<uint32_t> currencyOffsets;
+    std::string currencies;
+
+    /**
+     * @brief Writes the buffer to the file once it holds at least the given number of bytes.
+     * @param threshold Minimum buffered bytes before writing; 0 always writes
+     */
+    void flush(size_t threshold);
+
+    /**
+     * @brief Appends the buffered columns as one row group and clears them.
+     */
+    void writeRowGroup();
+
+    /**
+     * @brief Appends raw bytes to the output buffer.
+     *
+     * @param data The bytes
+     * @param size Number of bytes
+     */
+    void append(const void *data, size_t size);
+
+    /**
+     * @brief Looks up the name shown for a category.
+     *
+     * @param categoryId The category ID
+     * @return The category name, or "Uncategorized" if no category has that ID
+     */
+    const std::string &categoryName(int categoryId) const;
+};
@@ -0,0 +1,251 @@
+/**
+ * @file TransactionQuery.h
+ * @brief Defines the TransactionQuery builder and the plans the DataManager chooses for it.
+ */
+#pragma once
+#include <string>
+#include <vector>
+#include "TransactionExporter.h"
+
+/**
+ * @enum QueryAccess
+ * @brief How a query finds its candidate transactions.
+ */
+enum class QueryAccess
+{
+    Scan,     /**< Every transaction, filtered in blocks */
+    Month,    /**< The month index, for a month or date range */
+    Category, /**< The category index, for a set of categories */
+    Text,     /**< The description trigram index, for a text match */
+    Tag       /**< The tag bitmaps, combined with the month and category indexes */
+};
+
+/**
+ * @struct QueryPlan
+ * @brief The access path chosen for a query.
+ */
+struct QueryPlan
+{
+    QueryAccess access;   /**< Where candidates come from */
+    size_t estimatedRows; /**< Upper bound on the candidates the access path produces */
+};
+
+/**
+ * @brief Gets the name of an access path, as reported in traces and the C API.
+ * @param access The access path
+ * @return "scan", "month", "category", "text" or "tag"
+ */
+const char *queryAccessName(QueryAccess access);
+
+/**
+ * @class TransactionQuery
+ * @brief Conjunction of predicates over transactions, built by chaining calls.
+ *
+ * Every predicate left unset matches everything, so an empty query returns
+ * all transactions. For example:
+ *
+ *     TransactionQuery().between("2024-01-01", "2024-03-31").inCategory(4).minAmount(50).limit(20)
+ */
+class TransactionQuery
+{
+public:
+    /**
+     * @brief Constructs a query that matches every transaction.
+     */
+    TransactionQuery();
+
+    /**
+     * @brief Keeps only transactions in a month.
+     * @param monthYear Month and year in "YYYY-MM" format
+     * @return This query
+     */
+    TransactionQuery &inMonth(const std::string &monthYear);
+
+    /**
+     * @brief Keeps only transactions dated within a range.
+     *
+     * @param fromDate First "YYYY-MM-DD" date to include, or empty for no lower bound
+     * @param toDate Last "YYYY-MM-DD" date to include, or empty for no upper bound
+     * @return This query
+     */
+    TransactionQuery &between(const std::string &fromDate, const std::string &toDate);
+
+    /**
+     * @brief Adds a category to the set of accepted categories.
+     * @param categoryId The category ID, 0 for uncategorized
+     * @return This query
+     */
+    TransactionQuery &inCategory(int categoryId);
+
+    /**
+     * @brief Adds several categories to the set of accepted categories.
+     * @param categoryIds The category IDs
+     * @return This query
+     */
+    TransactionQuery &inCategories(const std::vector<int> &categoryIds);
+
+    /**
+     * @brief Keeps only transactions of at least an amount in the base currency.
+     *
+     * Transactions in a currency with no rate into the base currency never match.
+     *
+     * @param amount Smallest amount to include
+     * @return This query
+     */
+    TransactionQuery &minAmount(double amount);
+
+    /**
+     * @brief Keeps only transactions of at most an amount in the base currency.
+     *
+     * Transactions in a currency with no rate into the base currency never match.
+     *
+     * @param amount Largest amount to include
+     * @return This query
+     */
+    TransactionQuery &maxAmount(double amount);
+
+    /**
+     * @brief Keeps only income or only expenses.
+     * @param isIncome true for income, false for expenses
+     * @return This query
+     */
+    TransactionQuery &income(bool isIncome);
+
+    /**
+     * @brief Keeps only transactions whose description contains some text.
+     *
+     * Matching ignores case and punctuation, as in DataManager::searchTransactions().
+     *
+     * @param text Text to look for
+     * @param prefix true to match only at the start of a word
+     * @return This query
+     */
+    TransactionQuery &containing(const std::string &text, bool prefix = false);
+
+    /**
+     * @brief Keeps only transactions carrying a tag; several calls require all of them.
+     * @param tag The tag, normalized as by Transaction::setTags()
+     * @return This query
+     */
+    TransactionQuery &withTag(const std::string &tag);
+
+    /**
+     * @brief Drops transactions carrying a tag.
+     * @param tag The tag, normalized as by Transaction::setTags()
+     * @return This query
+     */
+    TransactionQuery &withoutTag(const std::string &tag);
+
+    /**
+     * @brief Caps the number of results.
+     * @param count Maximum number of results; 0 for no limit
+     * @return This query
+     */
+    TransactionQuery &limit(size_t count);
+
+    /**
+     * @brief Chooses the result order.
+     * @param descending true for newest ID first, false for oldest first
+     * @return This query
+     */
+    TransactionQuery &newestFirst(bool descending);
+
+    /**
+     * @brief Gets the month and date range; its categoryId is always -1.
+     * @return The date part of the query
+     */
+    const TransactionFilter &getDateFilter() const;
+
+    /**
+     * @brief Gets the accepted categories.
+     * @return Sorted category IDs without repeats; empty for any
+     */
+    const std::vector<int> &getCategoryIds() const;
+
+    /**
+     * @brief Checks whether a minimum amount was set.
+     * @return true if minAmount() was called
+     */
+    bool hasMinAmount() const;
+
+    /**
+     * @brief Gets the smallest amount to include.
+     * @return The minimum amount
+     */
+    double getMinAmount() const;
+
+    /**
+     * @brief Checks whether a maximum amount was set.
+     * @return true if maxAmount() was called
+     */
+    bool hasMaxAmount() const;
+
+    /**
+     * @brief Gets the largest amount to include.
+     * @return The maximum amount
+     */
+    double getMaxAmount() const;
+
+    /**
+     * @brief Checks whether the query keeps only income or only expenses.
+     * @return true if income() was called
+     */
+    bool hasIncomeFlag() const;
+
+    /**
+     * @brief Gets the accepted income flag.
+     * @return true for income, false for expenses
+     */
+    bool getIsIncome() const;
+
+    /**
+     * @brief Gets the maximum number of results.
+     * @return The limit; 0 for no limit
+     */
+    size_t getLimit() const;
+
+    /**
+     * @brief Gets the result order.
+     * @return true if results are ordered newest ID first
+     */
+    bool isNewestFirst() const;
+
+    /**
+     * @brief Gets the normalized text pattern.
+     * @return TextIndex::normalize() of the text, with the leading space only for a prefix match; empty for none
+     */
+    const std::string &getPattern() const;
+
+    /**
+     * @brief Gets the required tags.
+     * @return Normalized tags, sorted without repeats; empty for none
+     */
+    const std::vector<std::string> &getTags() const;
+
+    /**
+     * @brief Gets the excluded tags.
+     * @return Normalized tags, sorted without repeats; empty for none
+     */
+    const std::vector<std::string> &getExcludedTags() const;
+
+    /**
+     * @brief Checks whether any tag predicate is set.
+     * @return true if withTag() or withoutTag() was called
+     */
+    bool hasTagPredicate() const;
+
+private:
+    TransactionFilter dateFilter;  /**< Month and date range */
+    std::vector<int> categoryIds;  /**< Accepted categories, sorted */
+    bool minAmountSet;             /**< Whether minimumAmount applies */
+    double minimumAmount;          /**< Smallest amount to include */
+    bool maxAmountSet;             /**< Whether maximumAmount applies */
+    double maximumAmount;          /**< Largest amount to include */
+    bool incomeSet;                /**< Whether incomeFlag applies */
+    bool incomeFlag;               /**< Accepted income flag */
+    std::string pattern;           /**< Normalized text to match */
+    std::vector<std::string> tags; /**< Required tags, sorted */
+    std::vector<std::string> excludedTags; /**< Excluded tags, sorted */
+    size_t resultLimit;            /**< Maximum number of results */
+    bool descending;               /**< Newest ID first */
+};
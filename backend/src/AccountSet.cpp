@@ -0,0 +1,362 @@
+#include "../include/AccountSet.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include "../include/ThreadPool.h"
+
+template <typename Partial, typename Compute>
+std::vector<Partial> AccountSet::fanOut(Compute compute) const
+{
+    // One shard per task; each shard's own scan splits further on the same pool
+    std::vector<Partial> partials(shards.size());
+    ThreadPool::shared().parallelFor(shards.size(), 1, [&](size_t, size_t begin, size_t end)
+                                     {
+        for (size_t i = begin; i < end; i++)
+        {
+            partials[i] = compute(*shards[i].manager);
+        } });
+    return partials;
+}
+
+AccountSet::AccountSet(const std::string &rootPath) : rootPath(rootPath), nextAccountId(1)
+{
+    std::filesystem::create_directories(rootPath);
+
+    std::ifstream file(getManifestPath());
+    if (file.is_open())
+    {
+        try
+        {
+            nlohmann::json manifest;
+            file >> manifest;
+            nextAccountId = manifest.value("nextAccountId", 1);
+            for (const auto &item : manifest.value("accounts", nlohmann::json::array()))
+            {
+                Shard shard;
+                shard.account.id = item.at("id").get<int>();
+                shard.account.name = item.value("name", "");
+                nextAccountId = std::max(nextAccountId, shard.account.id + 1);
+                shards.push_back(std::move(shard));
+            }
+        }
+        catch (const std::exception &e)
+        {
+            // Treating the manifest as empty would drop every account on the next save
+            throw std::runtime_error("Cannot read account manifest " + getManifestPath() + ": " + e.what());
+        }
+    }
+
+    // Each shard parses its own files, so opening them is independent work
+    ThreadPool::shared().parallelFor(shards.size(), 1, [&](size_t, size_t begin, size_t end)
+                                     {
+        for (size_t i = begin; i < end; i++)
+        {
+            shards[i].manager = std::make_unique<DataManager>(getAccountPath(shards[i].account.id));
+        } });
+}
+
+int AccountSet::addAccount(const std::string &name)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    Shard shard;
+    shard.account.id = nextAccountId;
+    shard.account.name = name;
+    shard.manager = std::make_unique<DataManager>(getAccountPath(shard.account.id));
+
+    // Join the set's base currency, so totals across accounts stay comparable
+    std::string baseCurrency;
+    if (sharedBaseCurrency(baseCurrency) && !baseCurrency.empty() &&
+        shard.manager->getBaseCurrency() != baseCurrency && !shard.manager->setBaseCurrency(baseCurrency))
+    {
+        return -1;
+    }
+    shards.push_back(std::move(shard));
+    nextAccountId++;
+
+    if (!saveManifest())
+    {
+        shards.pop_back();
+        nextAccountId--;
+        return -1;
+    }
+    return shards.back().account.id;
+}
+
+bool AccountSet::renameAccount(int accountId, const std::string &name)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    for (auto &shard : shards)
+    {
+        if (shard.account.id == accountId)
+        {
+            std::string previous = shard.account.name;
+            shard.account.name = name;
+            if (!saveManifest())
+            {
+                shard.account.name = previous;
+                return false;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AccountSet::removeAccount(int accountId)
+{
+    return detachAccount(accountId) != nullptr;
+}
+
+std::unique_ptr<DataManager> AccountSet::detachAccount(int accountId, const std::function<void(DataManager *)> &whileLocked)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    for (auto it = shards.begin(); it != shards.end(); ++it)
+    {
+        if (it->account.id == accountId)
+        {
+            Shard removed = std::move(*it);
+            shards.erase(it);
+            if (!saveManifest())
+            {
+                // Put the account back where it was; the manifest still lists it
+                auto position = std::find_if(shards.begin(), shards.end(), [&](const Shard &shard)
+                                             { return shard.account.id > accountId; });
+                shards.insert(position, std::move(removed));
+                return nullptr;
+            }
+            if (whileLocked)
+            {
+                whileLocked(removed.manager.get());
+            }
+            return std::move(removed.manager);
+        }
+    }
+    return nullptr;
+}
+
+std::vector<Account> AccountSet::getAccounts() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::vector<Account> accounts;
+    accounts.reserve(shards.size());
+    for (const auto &shard : shards)
+    {
+        accounts.push_back(shard.account);
+    }
+    return accounts;
+}
+
+DataManager *AccountSet::getAccount(int accountId, const std::function<void(DataManager *)> &whileLocked) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    for (const auto &shard : shards)
+    {
+        if (shard.account.id == accountId)
+        {
+            if (whileLocked)
+            {
+                whileLocked(shard.manager.get());
+            }
+            return shard.manager.get();
+        }
+    }
+    return nullptr;
+}
+
+bool AccountSet::setBaseCurrency(const std::string &currency)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    bool saved = true;
+    for (const auto &shard : shards)
+    {
+        saved = shard.manager->setBaseCurrency(currency) && saved;
+    }
+    return saved;
+}
+
+bool AccountSet::getBaseCurrency(std::string &currency) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return sharedBaseCurrency(currency);
+}
+
+bool AccountSet::getTotalIncome(const std::string &monthYear, double &total) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::string currency;
+    if (!sharedBaseCurrency(currency))
+    {
+        return false;
+    }
+
+    total = 0.0;
+    for (double partial : fanOut<double>([&](const DataManager &manager)
+                                         { return manager.getTotalIncome(monthYear); }))
+    {
+        total += partial;
+    }
+    return true;
+}
+
+bool AccountSet::getTotalExpense(const std::string &monthYear, double &total) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::string currency;
+    if (!sharedBaseCurrency(currency))
+    {
+        return false;
+    }
+
+    total = 0.0;
+    for (double partial : fanOut<double>([&](const DataManager &manager)
+                                         { return manager.getTotalExpense(monthYear); }))
+    {
+        total += partial;
+    }
+    return true;
+}
+
+bool AccountSet::getCategoryTotals(const std::string &monthYear, std::map<std::string, double> &totals) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::string currency;
+    if (!sharedBaseCurrency(currency))
+    {
+        return false;
+    }
+
+    // Category IDs are local to a shard, so each shard labels its totals by name
+    auto partials = fanOut<std::map<std::string, double>>([&](const DataManager &manager)
+                                                          {
+        std::unordered_map<int, std::string> names;
+        for (const auto &category : manager.getAllCategories())
+        {
+            names[category.getId()] = category.getName();
+        }
+
+        std::map<std::string, double> byName;
+        for (const auto &pair : manager.getCategoryTotals(monthYear))
+        {
+            auto name = names.find(pair.first);
+            byName[name != names.end() ? name->second : std::string()] += pair.second;
+        }
+        return byName; });
+
+    totals.clear();
+    for (const auto &partial : partials)
+    {
+        for (const auto &pair : partial)
+        {
+            totals[pair.first] += pair.second;
+        }
+    }
+    return true;
+}
+
+bool AccountSet::getMonthlyTotals(bool isIncome, std::map<std::string, double> &totals) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::string currency;
+    if (!sharedBaseCurrency(currency))
+    {
+        return false;
+    }
+
+    auto partials = fanOut<std::map<std::string, double>>([&](const DataManager &manager)
+                                                          { return manager.getMonthlyTotals(isIncome); });
+
+    totals.clear();
+    for (const auto &partial : partials)
+    {
+        for (const auto &pair : partial)
+        {
+            totals[pair.first] += pair.second;
+        }
+    }
+    return true;
+}
+
+std::vector<AccountSummary> AccountSet::getAccountSummaries(const std::string &monthYear) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto partials = fanOut<AccountSummary>([&](const DataManager &manager)
+                                           { return AccountSummary{0, "", manager.getBaseCurrency(), manager.getTotalIncome(monthYear), manager.getTotalExpense(monthYear)}; });
+
+    for (size_t i = 0; i < shards.size(); i++)
+    {
+        partials[i].accountId = shards[i].account.id;
+        partials[i].name = shards[i].account.name;
+    }
+    return partials;
+}
+
+bool AccountSet::sharedBaseCurrency(std::string &currency) const
+{
+    currency.clear();
+    for (size_t i = 0; i < shards.size(); i++)
+    {
+        std::string shardCurrency = shards[i].manager->getBaseCurrency();
+        if (i != 0 && shardCurrency != currency)
+        {
+            std::cerr << "Accounts have different base currencies: '" << currency << "' and '" << shardCurrency
+                      << "' (account " << shards[i].account.id << ")" << std::endl;
+            return false;
+        }
+        currency = shardCurrency;
+    }
+    return true;
+}
+
+std::string AccountSet::getManifestPath() const
+{
+    return rootPath + "/accounts.json";
+}
+
+std::string AccountSet::getAccountPath(int accountId) const
+{
+    return rootPath + "/account-" + std::to_string(accountId);
+}
+
+bool AccountSet::saveManifest() const
+{
+    nlohmann::json accounts = nlohmann::json::array();
+    for (const auto &shard : shards)
+    {
+        accounts.push_back({{"id", shard.account.id}, {"name", shard.account.name}});
+    }
+    nlohmann::json manifest;
+    manifest["nextAccountId"] = nextAccountId;
+    manifest["accounts"] = accounts;
+
+    try
+    {
+        // Write to a temporary file first so a failed save never leaves a half-written manifest behind
+        std::string tempPath = getManifestPath() + ".tmp";
+        {
+            std::ofstream file(tempPath);
+            if (!file.is_open())
+            {
+                std::cerr << "Failed to open file for writing: " << tempPath << std::endl;
+                return false;
+            }
+            file << std::setw(4) << manifest << std::endl;
+            if (!file)
+            {
+                std::cerr << "Failed to write file: " << tempPath << std::endl;
+                return false;
+            }
+        }
+        std::filesystem::rename(tempPath, getManifestPath());
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error saving accounts: " << e.what() << std::endl;
+        return false;
+    }
+}
@@ -0,0 +1,84 @@
+#include "../include/AsyncExecutor.h"
+#include <iostream>
+
+AsyncExecutor::AsyncExecutor()
+    : busy(false), stopping(false)
+{
+    thread = std::thread(&AsyncExecutor::run, this);
+}
+
+AsyncExecutor::~AsyncExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+}
+
+bool AsyncExecutor::post(Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping)
+        {
+            return false;
+        }
+        tasks.push_back(std::move(task));
+    }
+    wakeup.notify_one();
+    return true;
+}
+
+void AsyncExecutor::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this]
+              { return tasks.empty() && !busy; });
+}
+
+void AsyncExecutor::run()
+{
+    while (true)
+    {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeup.wait(lock, [this]
+                        { return stopping || !tasks.empty(); });
+
+            // Drain the queue before honouring a shutdown request
+            if (tasks.empty())
+            {
+                return;
+            }
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            busy = true;
+        }
+
+        try
+        {
+            task();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in async task: " << e.what() << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busy = false;
+            if (tasks.empty())
+            {
+                idle.notify_all();
+            }
+        }
+    }
+}
@@ -3,6 +3,7 @@
 
 #include <sstream>
 #include <iomanip>
+#include "../include/MemoryUsage.h"
 
 // Constructor implementation
 Budget::Budget(int categoryId, const std::string &monthYear, double allocatedAmount)
@@ -30,4 +31,9 @@ std::string Budget::toString() const
         << ", Month/Year: " << monthYear
         << ", Allocated Amount: " << std::fixed << std::setprecision(2) << allocatedAmount << "]";
     return oss.str();
-}
\ No newline at end of file
+}
+
+size_t Budget::getHeapSize() const
+{
+    return stringHeapSize(monthYear);
+}
@@ -1,9 +1,16 @@
 #include "../include/BudgetTrackerLib.h"
 #include "../include/DataManager.h"
+#include "../include/AccountSet.h"
+#include "../include/ThreadPool.h"
+#include "../include/AsyncExecutor.h"
+#include "../include/Tracer.h"
 #include <string>
 #include <nlohmann/json.hpp>
 #include <iostream>
 #include <mutex>
+#include <memory>
+#include <unordered_set>
+#include <limits>
 
 /*
  * This file contains the C API for the Budget Tracker application.
@@ -12,13 +19,199 @@
  */
 thread_local std::string g_returnBuffer;
 
+// Live manager handles; true for those DestroyDataManager frees, false for account shards owned by an AccountSet
 static std::unordered_map<void *, bool> g_managerMap;
+// Shared so a waiter keeps an executor alive while the handle is being destroyed
+static std::unordered_map<void *, std::shared_ptr<AsyncExecutor>> g_executors;
+static std::unordered_set<void *> g_accountSets;
 static std::mutex g_managerMapMutex;
 
+// Snapshot of category names, so rows can be labelled without holding pointers into the manager
+static std::unordered_map<int, std::string> getCategoryNames(DataManager *dm)
+{
+    std::unordered_map<int, std::string> names;
+    for (const auto &category : dm->getAllCategories())
+    {
+        names[category.getId()] = category.getName();
+    }
+    return names;
+}
+
+// Queues work on the handle's background executor, creating it on first use
+static bool postAsync(void *manager, AsyncExecutor::Task task)
+{
+    std::lock_guard<std::mutex> lock(g_managerMapMutex);
+    if (g_managerMap.find(manager) == g_managerMap.end())
+    {
+        return false; // Unknown or destroyed handle
+    }
+
+    auto &executor = g_executors[manager];
+    if (!executor)
+    {
+        executor = std::make_shared<AsyncExecutor>();
+    }
+    return executor->post(std::move(task));
+}
+
+// Marks a handle dead so postAsync rejects it, and hands back its executor for the caller to drain
+// outside the lock. Caller holds g_managerMapMutex.
+static std::shared_ptr<AsyncExecutor> retireHandle(void *manager)
+{
+    g_managerMap.erase(manager);
+    std::shared_ptr<AsyncExecutor> executor;
+    auto executorIt = g_executors.find(manager);
+    if (executorIt != g_executors.end())
+    {
+        executor = std::move(executorIt->second);
+        g_executors.erase(executorIt);
+    }
+    return executor;
+}
+
+// Finishes queued async work on an account shard and forgets its handle, before the set closes the shard
+static void releaseShardHandle(DataManager *manager)
+{
+    std::shared_ptr<AsyncExecutor> executor;
+    {
+        std::lock_guard<std::mutex> lock(g_managerMapMutex);
+        executor = retireHandle(manager);
+    }
+    if (executor)
+    {
+        executor->waitIdle();
+    }
+}
+
+// Stores a JSON result in the return buffer, counting the bytes produced
+static const char *returnJson(DataManager *dm, const nlohmann::json &result)
+{
+    g_returnBuffer = result.dump();
+    dm->getMetrics().add(MetricCounter::BytesSerialized, g_returnBuffer.size());
+    return g_returnBuffer.c_str();
+}
+
+// Maps the C API duplicate policy code (0 allow, 1 skip, 2 flag) to DuplicatePolicy
+static DuplicatePolicy toDuplicatePolicy(int policy)
+{
+    switch (policy)
+    {
+    case 1:
+        return DuplicatePolicy::Skip;
+    case 2:
+        return DuplicatePolicy::Flag;
+    default:
+        return DuplicatePolicy::Allow;
+    }
+}
+
+// Maps the C API date order code (0 detect, 1 month first, 2 day first) to DateOrder
+static DateOrder toDateOrder(int order)
+{
+    switch (order)
+    {
+    case 1:
+        return DateOrder::MonthFirst;
+    case 2:
+        return DateOrder::DayFirst;
+    default:
+        return DateOrder::Detect;
+    }
+}
+
+// Reads the optional "month", "categoryId", "from" and "to" keys of a filter object
+static TransactionFilter toTransactionFilter(const nlohmann::json &spec)
+{
+    TransactionFilter filter;
+    filter.monthYear = spec.value("month", "");
+    filter.categoryId = spec.value("categoryId", -1);
+    filter.fromDate = spec.value("from", "");
+    filter.toDate = spec.value("to", "");
+    return filter;
+}
+
+// Reads a query spec; keys that are absent leave the predicate unset
+static TransactionQuery toTransactionQuery(const nlohmann::json &spec)
+{
+    TransactionQuery query;
+    query.inMonth(spec.value("month", ""));
+    query.between(spec.value("from", ""), spec.value("to", ""));
+    if (spec.value("categoryId", -1) >= 0)
+    {
+        query.inCategory(spec["categoryId"].get<int>());
+    }
+    if (spec.contains("categoryIds"))
+    {
+        query.inCategories(spec["categoryIds"].get<std::vector<int>>());
+    }
+    if (spec.contains("minAmount"))
+    {
+        query.minAmount(spec["minAmount"].get<double>());
+    }
+    if (spec.contains("maxAmount"))
+    {
+        query.maxAmount(spec["maxAmount"].get<double>());
+    }
+    if (spec.contains("isIncome"))
+    {
+        query.income(spec["isIncome"].get<bool>());
+    }
+    if (spec.contains("text"))
+    {
+        query.containing(spec["text"].get<std::string>(), spec.value("prefix", false));
+    }
+    if (spec.contains("tags"))
+    {
+        for (const auto &tag : spec["tags"].get<std::vector<std::string>>())
+        {
+            query.withTag(tag);
+        }
+    }
+    if (spec.contains("excludeTags"))
+    {
+        for (const auto &tag : spec["excludeTags"].get<std::vector<std::string>>())
+        {
+            query.withoutTag(tag);
+        }
+    }
+    int limit = spec.value("limit", 0);
+    query.limit(limit > 0 ? limit : 0);
+    query.newestFirst(spec.value("newestFirst", false));
+    return query;
+}
+
+// Serializes a transaction the way every transaction-returning call reports it
+static nlohmann::json transactionToJson(const Transaction &transaction, const std::unordered_map<int, std::string> &categoryNames)
+{
+    nlohmann::json item;
+    item["id"] = transaction.getId();
+    item["date"] = transaction.getDate();
+    item["amount"] = transaction.getAmount();
+    item["description"] = transaction.getDescription();
+    item["categoryId"] = transaction.getCategoryId();
+    item["isIncome"] = transaction.getIsIncome();
+    item["tags"] = transaction.getTags();
+    item["currency"] = transaction.getCurrency();
+
+    // Add categoryName if available
+    auto category = categoryNames.find(transaction.getCategoryId());
+    if (category != categoryNames.end())
+    {
+        item["categoryName"] = category->second;
+    }
+    else
+    {
+        item["categoryName"] = "Uncategorized";
+    }
+
+    return item;
+}
+
 extern "C"
 {
     void *CreateDataManager(const char *dataPath)
     {
+        TraceSpan span("CreateDataManager", "api");
         try
         {
             std::lock_guard<std::mutex> lock(g_managerMapMutex);
@@ -35,23 +228,36 @@ extern "C"
 
     void DestroyDataManager(void *manager)
     {
+        TraceSpan span("DestroyDataManager", "api");
         if (manager == nullptr)
             return;
 
         try
         {
-            std::lock_guard<std::mutex> lock(g_managerMapMutex);
-            auto it = g_managerMap.find(manager);
-            if (it != g_managerMap.end() && it->second)
+            // Retire the handle in one step, so no task can be queued on it from here on
+            std::shared_ptr<AsyncExecutor> executor;
             {
-                delete static_cast<DataManager *>(manager);
-                g_managerMap[manager] = false;
-                g_managerMap.erase(it);
+                std::lock_guard<std::mutex> lock(g_managerMapMutex);
+                auto it = g_managerMap.find(manager);
+                if (it == g_managerMap.end())
+                {
+                    std::cerr << "Warning: Attempt to destroy already destroyed or invalid DataManager" << std::endl;
+                    return;
+                }
+                if (!it->second)
+                {
+                    std::cerr << "Warning: DataManager belongs to an account set; use RemoveAccount or DestroyAccountSet" << std::endl;
+                    return;
+                }
+                executor = retireHandle(manager);
             }
-            else
+
+            // Finish queued async work without holding the lock callbacks may need
+            if (executor)
             {
-                std::cerr << "Warning: Attempt to destroy already destroyed or invalid DataManager" << std::endl;
+                executor->waitIdle();
             }
+            delete static_cast<DataManager *>(manager);
         }
         catch (const std::exception &e)
         {
@@ -59,9 +265,261 @@ extern "C"
         }
     }
 
+    // Account operations
+    void *CreateAccountSet(const char *rootPath)
+    {
+        TraceSpan span("CreateAccountSet", "api");
+        try
+        {
+            AccountSet *accountSet = new AccountSet(rootPath);
+            std::lock_guard<std::mutex> lock(g_managerMapMutex);
+            g_accountSets.insert(accountSet);
+            return accountSet;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error creating AccountSet: " << e.what() << std::endl;
+            return nullptr;
+        }
+    }
+
+    void DestroyAccountSet(void *accountSet)
+    {
+        TraceSpan span("DestroyAccountSet", "api");
+        if (accountSet == nullptr)
+            return;
+
+        try
+        {
+            {
+                std::lock_guard<std::mutex> lock(g_managerMapMutex);
+                if (g_accountSets.erase(accountSet) == 0)
+                {
+                    std::cerr << "Warning: Attempt to destroy already destroyed or invalid AccountSet" << std::endl;
+                    return;
+                }
+            }
+
+            AccountSet *set = static_cast<AccountSet *>(accountSet);
+            for (const auto &account : set->getAccounts())
+            {
+                releaseShardHandle(set->getAccount(account.id));
+            }
+            delete set;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error destroying AccountSet: " << e.what() << std::endl;
+        }
+    }
+
+    int AddAccount(void *accountSet, const char *name)
+    {
+        TraceSpan span("AddAccount", "api");
+        AccountSet *set = static_cast<AccountSet *>(accountSet);
+        try
+        {
+            return set->addAccount(name ? name : "");
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in AddAccount: " << e.what() << std::endl;
+            return -1;
+        }
+    }
+
+    bool RenameAccount(void *accountSet, int accountId, const char *name)
+    {
+        TraceSpan span("RenameAccount", "api");
+        AccountSet *set = static_cast<AccountSet *>(accountSet);
+        return set->renameAccount(accountId, name ? name : "");
+    }
+
+    bool RemoveAccount(void *accountSet, int accountId)
+    {
+        TraceSpan span("RemoveAccount", "api");
+        AccountSet *set = static_cast<AccountSet *>(accountSet);
+
+        // Retire the handle only once the manifest no longer lists the account, and under the
+        // set's lock, so GetAccountManager cannot register it again in between
+        std::shared_ptr<AsyncExecutor> executor;
+        std::unique_ptr<DataManager> shard = set->detachAccount(accountId, [&](DataManager *manager)
+                                                                {
+            std::lock_guard<std::mutex> lock(g_managerMapMutex);
+            executor = retireHandle(manager); });
+        if (!shard)
+        {
+            return false;
+        }
+
+        // Queued work finishes before the shard closes, outside the set's lock callbacks may need
+        if (executor)
+        {
+            executor->waitIdle();
+        }
+        return true;
+    }
+
+    const char *GetAccounts(void *accountSet)
+    {
+        TraceSpan span("GetAccounts", "api");
+        AccountSet *set = static_cast<AccountSet *>(accountSet);
+        try
+        {
+            nlohmann::json jsonArray = nlohmann::json::array();
+            for (const auto &account : set->getAccounts())
+            {
+                jsonArray.push_back({{"id", account.id}, {"name", account.name}});
+            }
+            g_returnBuffer = jsonArray.dump();
+            return g_returnBuffer.c_str();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in GetAccounts: " << e.what() << std::endl;
+            g_returnBuffer = "[]";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    void *GetAccountManager(void *accountSet, int accountId)
+    {
+        TraceSpan span("GetAccountManager", "api");
+        AccountSet *set = static_cast<AccountSet *>(accountSet);
+        // Registered as borrowed, so async calls accept it and DestroyDataManager refuses it; the set's
+        // lock is held meanwhile, so RemoveAccount cannot retire the handle before it is registered
+        return set->getAccount(accountId, [](DataManager *shard)
+                               {
+            std::lock_guard<std::mutex> lock(g_managerMapMutex);
+            g_managerMap.emplace(shard, false); });
+    }
+
+    bool SetAccountsBaseCurrency(void *accountSet, const char *currency)
+    {
+        TraceSpan span("SetAccountsBaseCurrency", "api");
+        AccountSet *set = static_cast<AccountSet *>(accountSet);
+        return set->setBaseCurrency(currency ? currency : "");
+    }
+
+    double GetAccountsTotalIncome(void *accountSet, const char *monthYear)
+    {
+        TraceSpan span("GetAccountsTotalIncome", "api");
+        AccountSet *set = static_cast<AccountSet *>(accountSet);
+        double total = 0.0;
+        return set->getTotalIncome(monthYear ? monthYear : "", total) ? total : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    double GetAccountsTotalExpense(void *accountSet, const char *monthYear)
+    {
+        TraceSpan span("GetAccountsTotalExpense", "api");
+        AccountSet *set = static_cast<AccountSet *>(accountSet);
+        double total = 0.0;
+        return set->getTotalExpense(monthYear ? monthYear : "", total) ? total : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    const char *GetAccountsCategoryTotals(void *accountSet, const char *monthYear)
+    {
+        TraceSpan span("GetAccountsCategoryTotals", "api");
+        AccountSet *set = static_cast<AccountSet *>(accountSet);
+        try
+        {
+            std::map<std::string, double> totals;
+            if (!set->getCategoryTotals(monthYear ? monthYear : "", totals))
+            {
+                g_returnBuffer = "{}";
+                return g_returnBuffer.c_str();
+            }
+
+            nlohmann::json jsonObject = nlohmann::json::object();
+            for (const auto &pair : totals)
+            {
+                jsonObject[pair.first] = pair.second;
+            }
+            g_returnBuffer = jsonObject.dump();
+            return g_returnBuffer.c_str();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in GetAccountsCategoryTotals: " << e.what() << std::endl;
+            g_returnBuffer = "{}";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    const char *GetAccountsMonthlyTotals(void *accountSet, bool isIncome)
+    {
+        TraceSpan span("GetAccountsMonthlyTotals", "api");
+        AccountSet *set = static_cast<AccountSet *>(accountSet);
+        try
+        {
+            std::map<std::string, double> totals;
+            if (!set->getMonthlyTotals(isIncome, totals))
+            {
+                g_returnBuffer = "{}";
+                return g_returnBuffer.c_str();
+            }
+
+            nlohmann::json jsonObject = nlohmann::json::object();
+            for (const auto &pair : totals)
+            {
+                jsonObject[pair.first] = pair.second;
+            }
+            g_returnBuffer = jsonObject.dump();
+            return g_returnBuffer.c_str();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in GetAccountsMonthlyTotals: " << e.what() << std::endl;
+            g_returnBuffer = "{}";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    const char *GetAccountsSummary(void *accountSet, const char *monthYear)
+    {
+        TraceSpan span("GetAccountsSummary", "api");
+        AccountSet *set = static_cast<AccountSet *>(accountSet);
+        try
+        {
+            nlohmann::json jsonArray = nlohmann::json::array();
+            for (const auto &summary : set->getAccountSummaries(monthYear ? monthYear : ""))
+            {
+                nlohmann::json item;
+                item["accountId"] = summary.accountId;
+                item["name"] = summary.name;
+                item["baseCurrency"] = summary.baseCurrency;
+                item["income"] = summary.income;
+                item["expense"] = summary.expense;
+                item["balance"] = summary.income - summary.expense;
+                jsonArray.push_back(item);
+            }
+            g_returnBuffer = jsonArray.dump();
+            return g_returnBuffer.c_str();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in GetAccountsSummary: " << e.what() << std::endl;
+            g_returnBuffer = "[]";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    void SetAnalysisThreadCount(int threadCount)
+    {
+        TraceSpan span("SetAnalysisThreadCount", "api");
+        ThreadPool::shared().setThreadCount(threadCount > 0 ? threadCount : 0);
+    }
+
+    int GetAnalysisThreadCount()
+    {
+        TraceSpan span("GetAnalysisThreadCount", "api");
+        return static_cast<int>(ThreadPool::shared().getThreadCount());
+    }
+
     // Category operations
     int AddCategory(void *manager, const char *name, const char *description, const char *color)
     {
+        TraceSpan span("AddCategory", "api");
         DataManager *dm = static_cast<DataManager *>(manager);
         Category category(0, name, description, color);
         if (dm->addCategory(category))
@@ -73,23 +531,34 @@ extern "C"
 
     bool UpdateCategory(void *manager, int id, const char *name, const char *description, const char *color)
     {
+        TraceSpan span("UpdateCategory", "api");
         DataManager *dm = static_cast<DataManager *>(manager);
         Category category(id, name, description, color);
         return dm->updateCategory(category);
     }
 
+    bool SetCategoryParent(void *manager, int categoryId, int parentId)
+    {
+        TraceSpan span("SetCategoryParent", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        return dm->setCategoryParent(categoryId, parentId);
+    }
+
     bool DeleteCategory(void *manager, int categoryId)
     {
+        TraceSpan span("DeleteCategory", "api");
         DataManager *dm = static_cast<DataManager *>(manager);
         return dm->deleteCategory(categoryId);
     }
 
     const char *GetAllCategories(void *manager)
     {
+        TraceSpan span("GetAllCategories", "api");
         DataManager *dm = static_cast<DataManager *>(manager);
         try
         {
             auto categories = dm->getAllCategories();
+            Metrics::Timer timer(dm->getMetrics(), MetricOperation::SerializeResult);
 
             nlohmann::json jsonArray = nlohmann::json::array();
             for (const auto &category : categories)
@@ -99,11 +568,11 @@ extern "C"
                 item["name"] = category.getName();
                 item["description"] = category.getDescription();
                 item["color"] = category.getColor();
+                item["parentId"] = category.getParentId();
                 jsonArray.push_back(item);
             }
 
-            g_returnBuffer = jsonArray.dump();
-            return g_returnBuffer.c_str();
+            return returnJson(dm, jsonArray);
         }
         catch (const std::exception &e)
         {
@@ -116,6 +585,7 @@ extern "C"
     // Transaction operations
     int AddTransaction(void *manager, const char *date, double amount, const char *description, int categoryId, bool isIncome)
     {
+        TraceSpan span("AddTransaction", "api");
         DataManager *dm = static_cast<DataManager *>(manager);
         Transaction transaction(0, date, amount, description, categoryId, isIncome);
         if (dm->addTransaction(transaction))
@@ -127,110 +597,1392 @@ extern "C"
 
     bool UpdateTransaction(void *manager, int id, const char *date, double amount, const char *description, int categoryId, bool isIncome)
     {
+        TraceSpan span("UpdateTransaction", "api");
         DataManager *dm = static_cast<DataManager *>(manager);
         Transaction transaction(id, date, amount, description, categoryId, isIncome);
-        return dm->updateTransaction(transaction);
+        return dm->updateTransaction(transaction, true);
+    }
+
+    bool SetTransactionTags(void *manager, int transactionId, const char *tags)
+    {
+        TraceSpan span("SetTransactionTags", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            auto list = nlohmann::json::parse(tags != nullptr && tags[0] != '\0' ? tags : "[]").get<std::vector<std::string>>();
+            return dm->setTransactionTags(transactionId, list);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in SetTransactionTags: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    bool SetTransactionCurrency(void *manager, int transactionId, const char *currency)
+    {
+        TraceSpan span("SetTransactionCurrency", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        return dm->setTransactionCurrency(transactionId, currency != nullptr ? currency : "");
+    }
+
+    const char *GetAllTags(void *manager)
+    {
+        TraceSpan span("GetAllTags", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            auto counts = dm->getTagCounts();
+            Metrics::Timer timer(dm->getMetrics(), MetricOperation::SerializeResult);
+
+            nlohmann::json jsonArray = nlohmann::json::array();
+            for (const auto &entry : counts)
+            {
+                jsonArray.push_back({{"tag", entry.first}, {"count", entry.second}});
+            }
+
+            return returnJson(dm, jsonArray);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in GetAllTags: " << e.what() << std::endl;
+            g_returnBuffer = "[]";
+            return g_returnBuffer.c_str();
+        }
     }
 
     bool DeleteTransaction(void *manager, int transactionId)
     {
+        TraceSpan span("DeleteTransaction", "api");
         DataManager *dm = static_cast<DataManager *>(manager);
         return dm->deleteTransaction(transactionId);
     }
 
     const char *GetAllTransactions(void *manager)
     {
+        TraceSpan span("GetAllTransactions", "api");
         DataManager *dm = static_cast<DataManager *>(manager);
         auto transactions = dm->getAllTransactions();
+        Metrics::Timer timer(dm->getMetrics(), MetricOperation::SerializeResult);
+        auto categoryNames = getCategoryNames(dm);
 
         nlohmann::json jsonArray = nlohmann::json::array();
         for (const auto &transaction : transactions)
         {
-            nlohmann::json item;
-            item["id"] = transaction.getId();
-            item["date"] = transaction.getDate();
-            item["amount"] = transaction.getAmount();
-            item["description"] = transaction.getDescription();
-            item["categoryId"] = transaction.getCategoryId();
-            item["isIncome"] = transaction.getIsIncome();
-
-            // Add categoryName if available
-            auto category = dm->getCategoryById(transaction.getCategoryId());
-            if (category != nullptr)
-            {
-                item["categoryName"] = category->getName();
-            }
-            else
-            {
-                item["categoryName"] = "Uncategorized";
-            }
-
-            jsonArray.push_back(item);
+            jsonArray.push_back(transactionToJson(transaction, categoryNames));
         }
 
-        g_returnBuffer = jsonArray.dump();
-        return g_returnBuffer.c_str();
+        return returnJson(dm, jsonArray);
     }
 
     const char *GetTransactionsByMonth(void *manager, const char *monthYear)
     {
+        TraceSpan span("GetTransactionsByMonth", "api");
         DataManager *dm = static_cast<DataManager *>(manager);
         auto transactions = dm->getTransactionsByMonth(monthYear);
+        Metrics::Timer timer(dm->getMetrics(), MetricOperation::SerializeResult);
+        auto categoryNames = getCategoryNames(dm);
 
         nlohmann::json jsonArray = nlohmann::json::array();
         for (const auto &transaction : transactions)
         {
-            nlohmann::json item;
-            item["id"] = transaction.getId();
-            item["date"] = transaction.getDate();
-            item["amount"] = transaction.getAmount();
-            item["description"] = transaction.getDescription();
-            item["categoryId"] = transaction.getCategoryId();
-            item["isIncome"] = transaction.getIsIncome();
+            jsonArray.push_back(transactionToJson(transaction, categoryNames));
+        }
+
+        return returnJson(dm, jsonArray);
+    }
 
-            // Add categoryName if available
-            auto category = dm->getCategoryById(transaction.getCategoryId());
-            if (category != nullptr)
+    const char *SearchTransactions(void *manager, const char *query, int limit, const char *options)
+    {
+        TraceSpan span("SearchTransactions", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            TransactionFilter filter;
+            bool prefix = false;
+            if (options != nullptr && options[0] != '\0')
             {
-                item["categoryName"] = category->getName();
+                nlohmann::json spec = nlohmann::json::parse(options);
+                filter = toTransactionFilter(spec);
+                prefix = spec.value("prefix", false);
             }
-            else
+
+            auto transactions = dm->searchTransactions(query, prefix, filter, limit > 0 ? limit : 0);
+            Metrics::Timer timer(dm->getMetrics(), MetricOperation::SerializeResult);
+            auto categoryNames = getCategoryNames(dm);
+
+            nlohmann::json jsonArray = nlohmann::json::array();
+            for (const auto &transaction : transactions)
             {
-                item["categoryName"] = "Uncategorized";
+                jsonArray.push_back(transactionToJson(transaction, categoryNames));
             }
 
-            jsonArray.push_back(item);
+            return returnJson(dm, jsonArray);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in SearchTransactions: " << e.what() << std::endl;
+            g_returnBuffer = "[]";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    const char *SuggestDescriptions(void *manager, const char *prefix, int k)
+    {
+        TraceSpan span("SuggestDescriptions", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            auto suggestions = dm->suggestDescriptions(prefix, k > 0 ? k : 0);
+            Metrics::Timer timer(dm->getMetrics(), MetricOperation::SerializeResult);
+
+            nlohmann::json jsonArray = nlohmann::json::array();
+            for (const auto &suggestion : suggestions)
+            {
+                nlohmann::json item;
+                item["text"] = suggestion.text;
+                item["kind"] = suggestion.isCategory ? "category" : "description";
+                item["categoryId"] = suggestion.categoryId;
+                item["count"] = suggestion.count;
+                jsonArray.push_back(item);
+            }
+
+            return returnJson(dm, jsonArray);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in SuggestDescriptions: " << e.what() << std::endl;
+            g_returnBuffer = "[]";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    const char *QueryTransactions(void *manager, const char *spec)
+    {
+        TraceSpan span("QueryTransactions", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            TransactionQuery query;
+            if (spec != nullptr && spec[0] != '\0')
+            {
+                query = toTransactionQuery(nlohmann::json::parse(spec));
+            }
+
+            auto transactions = dm->queryTransactions(query);
+            Metrics::Timer timer(dm->getMetrics(), MetricOperation::SerializeResult);
+            auto categoryNames = getCategoryNames(dm);
+
+            nlohmann::json jsonArray = nlohmann::json::array();
+            for (const auto &transaction : transactions)
+            {
+                jsonArray.push_back(transactionToJson(transaction, categoryNames));
+            }
+
+            return returnJson(dm, jsonArray);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in QueryTransactions: " << e.what() << std::endl;
+            g_returnBuffer = "[]";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    const char *ExplainQuery(void *manager, const char *spec)
+    {
+        TraceSpan span("ExplainQuery", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            TransactionQuery query;
+            if (spec != nullptr && spec[0] != '\0')
+            {
+                query = toTransactionQuery(nlohmann::json::parse(spec));
+            }
+
+            QueryPlan plan = dm->explainQuery(query);
+            nlohmann::json result;
+            result["access"] = queryAccessName(plan.access);
+            result["estimatedRows"] = plan.estimatedRows;
+            return returnJson(dm, result);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in ExplainQuery: " << e.what() << std::endl;
+            g_returnBuffer = "{}";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    // Change tracking
+    unsigned long long GetDataVersion(void *manager)
+    {
+        TraceSpan span("GetDataVersion", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        return dm->getDataVersion();
+    }
+
+    const char *GetChangesSince(void *manager, unsigned long long version)
+    {
+        TraceSpan span("GetChangesSince", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            ChangeSet changes = dm->getChangesSince(version);
+            Metrics::Timer timer(dm->getMetrics(), MetricOperation::SerializeResult);
+            auto categoryNames = getCategoryNames(dm);
+
+            nlohmann::json transactions;
+            transactions["inserted"] = nlohmann::json::array();
+            transactions["updated"] = nlohmann::json::array();
+            for (const auto &transaction : changes.insertedTransactions)
+            {
+                transactions["inserted"].push_back(transactionToJson(transaction, categoryNames));
+            }
+            for (const auto &transaction : changes.updatedTransactions)
+            {
+                transactions["updated"].push_back(transactionToJson(transaction, categoryNames));
+            }
+            transactions["deleted"] = changes.deletedTransactionIds;
+
+            nlohmann::json categories;
+            categories["inserted"] = changes.insertedCategories;
+            categories["updated"] = changes.updatedCategories;
+            categories["deleted"] = changes.deletedCategoryIds;
+
+            nlohmann::json deletedBudgets = nlohmann::json::array();
+            for (const auto &budget : changes.deletedBudgets)
+            {
+                deletedBudgets.push_back({{"categoryId", budget.getCategoryId()}, {"monthYear", budget.getMonthYear()}});
+            }
+
+            nlohmann::json budgets;
+            budgets["inserted"] = changes.insertedBudgets;
+            budgets["updated"] = changes.updatedBudgets;
+            budgets["deleted"] = deletedBudgets;
+
+            nlohmann::json result;
+            result["version"] = changes.version;
+            result["fullResync"] = changes.fullResync;
+            result["transactions"] = transactions;
+            result["categories"] = categories;
+            result["budgets"] = budgets;
+
+            return returnJson(dm, result);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in GetChangesSince: " << e.what() << std::endl;
+            g_returnBuffer = "{}";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    // Batch operations
+    int AddTransactionsBatch(void *manager, int count, const char **dates, const double *amounts, const char **descriptions, const int *categoryIds, const bool *isIncome, int *outIds)
+    {
+        TraceSpan span("AddTransactionsBatch", "api");
+        span.addArg("count", count);
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            std::vector<Transaction> transactions;
+            transactions.reserve(count);
+            for (int i = 0; i < count; i++)
+            {
+                transactions.emplace_back(0, dates[i], amounts[i], descriptions[i], categoryIds[i], isIncome[i]);
+            }
+
+            if (!dm->addTransactionsBatch(transactions))
+            {
+                return -1;
+            }
+
+            if (outIds != nullptr)
+            {
+                for (int i = 0; i < count; i++)
+                {
+                    outIds[i] = transactions[i].getId();
+                }
+            }
+            return count;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in AddTransactionsBatch: " << e.what() << std::endl;
+            return -1;
+        }
+    }
+
+    int AddTransactionsBatchChecked(void *manager, int count, const char **dates, const double *amounts, const char **descriptions, const int *categoryIds, const bool *isIncome, int duplicatePolicy, int *outIds, int *outDuplicateOf)
+    {
+        TraceSpan span("AddTransactionsBatchChecked", "api");
+        span.addArg("count", count);
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            std::vector<Transaction> transactions;
+            transactions.reserve(count);
+            for (int i = 0; i < count; i++)
+            {
+                transactions.emplace_back(0, dates[i], amounts[i], descriptions[i], categoryIds[i], isIncome[i]);
+            }
+
+            std::vector<DuplicateMatch> duplicates;
+            if (!dm->addTransactionsBatch(transactions, toDuplicatePolicy(duplicatePolicy), duplicates))
+            {
+                return -1;
+            }
+
+            int added = 0;
+            for (int i = 0; i < count; i++)
+            {
+                if (transactions[i].getId() != 0)
+                {
+                    added++;
+                }
+                if (outIds != nullptr)
+                {
+                    outIds[i] = transactions[i].getId() != 0 ? transactions[i].getId() : -1;
+                }
+                if (outDuplicateOf != nullptr)
+                {
+                    outDuplicateOf[i] = 0;
+                }
+            }
+
+            if (outDuplicateOf != nullptr)
+            {
+                for (const auto &match : duplicates)
+                {
+                    outDuplicateOf[match.index] = match.existingId;
+                }
+            }
+            return added;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in AddTransactionsBatchChecked: " << e.what() << std::endl;
+            return -1;
+        }
+    }
+
+    const char *GetDuplicateTransactions(void *manager)
+    {
+        TraceSpan span("GetDuplicateTransactions", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            auto groups = dm->findDuplicateTransactions();
+            Metrics::Timer timer(dm->getMetrics(), MetricOperation::SerializeResult);
+            return returnJson(dm, groups);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in GetDuplicateTransactions: " << e.what() << std::endl;
+            g_returnBuffer = "[]";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    bool UpdateTransactionsBatch(void *manager, int count, const int *ids, const char **dates, const double *amounts, const char **descriptions, const int *categoryIds, const bool *isIncome)
+    {
+        TraceSpan span("UpdateTransactionsBatch", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            std::vector<Transaction> transactions;
+            transactions.reserve(count);
+            for (int i = 0; i < count; i++)
+            {
+                transactions.emplace_back(ids[i], dates[i], amounts[i], descriptions[i], categoryIds[i], isIncome[i]);
+            }
+            return dm->updateTransactionsBatch(transactions, true);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in UpdateTransactionsBatch: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    bool DeleteTransactionsBatch(void *manager, int count, const int *transactionIds)
+    {
+        TraceSpan span("DeleteTransactionsBatch", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        std::vector<int> ids(transactionIds, transactionIds + count);
+        return dm->deleteTransactionsBatch(ids);
+    }
+
+    bool BeginBatch(void *manager)
+    {
+        TraceSpan span("BeginBatch", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        return dm->beginBatch();
+    }
+
+    bool CommitBatch(void *manager)
+    {
+        TraceSpan span("CommitBatch", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        return dm->commitBatch();
+    }
+
+    bool RollbackBatch(void *manager)
+    {
+        TraceSpan span("RollbackBatch", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        return dm->rollbackBatch();
+    }
+
+    // Statement import
+    const char *ImportFile(void *manager, const char *filePath, const char *format, int duplicatePolicy, int dateOrder)
+    {
+        TraceSpan span("ImportFile", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            nlohmann::json result;
+            ImportFormat importFormat;
+            if (!StatementImporter::resolveFormat(format != nullptr ? format : "", filePath, importFormat))
+            {
+                result["success"] = false;
+                result["imported"] = 0;
+                result["errorCount"] = 1;
+                result["errors"] = nlohmann::json::array({{{"line", 0}, {"message", "Unknown import format"}}});
+                result["duplicateCount"] = 0;
+                result["duplicates"] = nlohmann::json::array();
+                g_returnBuffer = result.dump();
+                return g_returnBuffer.c_str();
+            }
+
+            ImportResult imported;
+            bool success = dm->importFile(filePath, importFormat, imported, toDuplicatePolicy(duplicatePolicy), toDateOrder(dateOrder));
+
+            // Report at most this many rows per list; the counts have the full numbers
+            const size_t maxReportedRows = 1000;
+            nlohmann::json errors = nlohmann::json::array();
+            for (size_t i = 0; i < imported.errors.size() && i < maxReportedRows; i++)
+            {
+                errors.push_back({{"line", imported.errors[i].line}, {"message", imported.errors[i].message}});
+            }
+
+            auto categoryNames = getCategoryNames(dm);
+            nlohmann::json duplicates = nlohmann::json::array();
+            for (size_t i = 0; i < imported.duplicates.size() && i < maxReportedRows; i++)
+            {
+                const DuplicateMatch &match = imported.duplicates[i];
+                nlohmann::json item = transactionToJson(imported.transactions[match.index], categoryNames);
+                item["line"] = imported.lines[match.index];
+                item["existingId"] = match.existingId;
+                duplicates.push_back(item);
+            }
+
+            // Skipped duplicates keep ID 0
+            size_t importedCount = 0;
+            int firstId = 0, lastId = 0;
+            for (const auto &transaction : imported.transactions)
+            {
+                if (success && transaction.getId() != 0)
+                {
+                    firstId = importedCount == 0 ? transaction.getId() : firstId;
+                    lastId = transaction.getId();
+                    importedCount++;
+                }
+            }
+
+            result["success"] = success;
+            result["imported"] = importedCount;
+            result["errorCount"] = imported.errors.size();
+            result["errors"] = errors;
+            result["duplicateCount"] = imported.duplicates.size();
+            result["duplicates"] = duplicates;
+            if (importedCount != 0)
+            {
+                result["firstId"] = firstId;
+                result["lastId"] = lastId;
+            }
+
+            return returnJson(dm, result);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in ImportFile: " << e.what() << std::endl;
+            g_returnBuffer = "{\"success\":false,\"imported\":0,\"errorCount\":0,\"errors\":[],\"duplicateCount\":0,\"duplicates\":[]}";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    // Export
+    long long ExportTransactions(void *manager, const char *filePath, const char *format, const char *filter)
+    {
+        TraceSpan span("ExportTransactions", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            ExportFormat exportFormat;
+            if (!TransactionExporter::resolveFormat(format != nullptr ? format : "", filePath, exportFormat))
+            {
+                std::cerr << "Unknown export format for " << filePath << std::endl;
+                return -1;
+            }
+
+            TransactionFilter rowFilter;
+            if (filter != nullptr && filter[0] != '\0')
+            {
+                rowFilter = toTransactionFilter(nlohmann::json::parse(filter));
+            }
+
+            size_t rowsWritten = 0;
+            if (!dm->exportTransactions(filePath, exportFormat, rowFilter, rowsWritten))
+            {
+                return -1;
+            }
+            return static_cast<long long>(rowsWritten);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in ExportTransactions: " << e.what() << std::endl;
+            return -1;
+        }
+    }
+
+    // Budget operations
+    bool AddBudget(void *manager, int categoryId, const char *monthYear, double allocatedAmount)
+    {
+        TraceSpan span("AddBudget", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        Budget budget(categoryId, monthYear, allocatedAmount);
+        return dm->addBudget(budget);
+    }
+
+    bool UpdateBudget(void *manager, int categoryId, const char *monthYear, double allocatedAmount)
+    {
+        TraceSpan span("UpdateBudget", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        Budget budget(categoryId, monthYear, allocatedAmount);
+        return dm->updateBudget(budget);
+    }
+
+    bool DeleteBudget(void *manager, int categoryId, const char *monthYear)
+    {
+        TraceSpan span("DeleteBudget", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        return dm->deleteBudget(categoryId, monthYear);
+    }
+
+    const char *GetAllBudgets(void *manager)
+    {
+        TraceSpan span("GetAllBudgets", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            auto budgets = dm->getAllBudgets();
+            Metrics::Timer timer(dm->getMetrics(), MetricOperation::SerializeResult);
+
+            nlohmann::json jsonArray = nlohmann::json::array();
+            for (const auto &budget : budgets)
+            {
+                nlohmann::json item;
+                item["categoryId"] = budget.getCategoryId();
+                item["monthYear"] = budget.getMonthYear();
+                item["allocatedAmount"] = budget.getAllocatedAmount();
+                jsonArray.push_back(item);
+            }
+
+            return returnJson(dm, jsonArray);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in GetAllBudgets: " << e.what() << std::endl;
+            g_returnBuffer = "[]";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    const char *GetBudgetVariance(void *manager, const char *fromMonth, const char *toMonth)
+    {
+        TraceSpan span("GetBudgetVariance", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            auto variances = dm->getBudgetVariance(fromMonth != nullptr ? fromMonth : "", toMonth != nullptr ? toMonth : "");
+            Metrics::Timer timer(dm->getMetrics(), MetricOperation::SerializeResult);
+
+            nlohmann::json jsonArray = nlohmann::json::array();
+            for (const auto &variance : variances)
+            {
+                nlohmann::json item;
+                item["categoryId"] = variance.categoryId;
+                item["monthYear"] = variance.monthYear;
+                item["allocated"] = variance.allocated;
+                item["spent"] = variance.spent;
+                item["remaining"] = variance.remaining;
+                item["percentUsed"] = variance.percentUsed;
+                item["overBudget"] = variance.remaining < 0.0;
+                jsonArray.push_back(item);
+            }
+
+            return returnJson(dm, jsonArray);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in GetBudgetVariance: " << e.what() << std::endl;
+            g_returnBuffer = "[]";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    const char *GetBudgetAlerts(void *manager)
+    {
+        TraceSpan span("GetBudgetAlerts", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            auto alerts = dm->takeBudgetAlerts();
+
+            nlohmann::json jsonArray = nlohmann::json::array();
+            for (const auto &alert : alerts)
+            {
+                nlohmann::json item;
+                item["categoryId"] = alert.categoryId;
+                item["monthYear"] = alert.monthYear;
+                item["allocated"] = alert.allocated;
+                item["spent"] = alert.spent;
+                item["transactionId"] = alert.transactionId;
+                jsonArray.push_back(item);
+            }
+
+            return returnJson(dm, jsonArray);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in GetBudgetAlerts: " << e.what() << std::endl;
+            g_returnBuffer = "[]";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    // Currency operations
+    bool SetBaseCurrency(void *manager, const char *currency)
+    {
+        TraceSpan span("SetBaseCurrency", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        return dm->setBaseCurrency(currency != nullptr ? currency : "");
+    }
+
+    bool SetExchangeRate(void *manager, const char *currency, const char *date, double rate)
+    {
+        TraceSpan span("SetExchangeRate", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        return dm->setExchangeRate(currency, date, rate);
+    }
+
+    bool RemoveExchangeRate(void *manager, const char *currency, const char *date)
+    {
+        TraceSpan span("RemoveExchangeRate", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        return dm->removeExchangeRate(currency, date);
+    }
+
+    const char *GetExchangeRates(void *manager)
+    {
+        TraceSpan span("GetExchangeRates", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            nlohmann::json rates = nlohmann::json::array();
+            for (const auto &rate : dm->getExchangeRates())
+            {
+                rates.push_back({{"currency", rate.currency}, {"date", rate.date}, {"rate", rate.rate}});
+            }
+
+            nlohmann::json result;
+            result["baseCurrency"] = dm->getBaseCurrency();
+            result["rates"] = rates;
+            result["unconverted"] = nlohmann::json::object();
+            for (const auto &entry : dm->getUnconvertedCurrencies())
+            {
+                result["unconverted"][entry.first] = entry.second;
+            }
+            return returnJson(dm, result);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in GetExchangeRates: " << e.what() << std::endl;
+            g_returnBuffer = "{}";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    // Analysis functions
+    double GetTotalIncome(void *manager, const char *monthYear)
+    {
+        TraceSpan span("GetTotalIncome", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        return dm->getTotalIncome(monthYear);
+    }
+
+    double GetTotalExpense(void *manager, const char *monthYear)
+    {
+        TraceSpan span("GetTotalExpense", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        return dm->getTotalExpense(monthYear);
+    }
+
+    const char *GetCategoryTotals(void *manager, const char *monthYear)
+    {
+        TraceSpan span("GetCategoryTotals", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        auto totals = dm->getCategoryTotals(monthYear);
+        Metrics::Timer timer(dm->getMetrics(), MetricOperation::SerializeResult);
+
+        nlohmann::json jsonObject;
+        for (const auto &pair : totals)
+        {
+            jsonObject[std::to_string(pair.first)] = pair.second;
+        }
+
+        return returnJson(dm, jsonObject);
+    }
+
+    const char *GetCategoryRollups(void *manager, const char *monthYear)
+    {
+        TraceSpan span("GetCategoryRollups", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            auto rollups = dm->getCategoryRollups(monthYear ? monthYear : "");
+            Metrics::Timer timer(dm->getMetrics(), MetricOperation::SerializeResult);
+
+            nlohmann::json jsonArray = nlohmann::json::array();
+            for (const auto &rollup : rollups)
+            {
+                nlohmann::json item;
+                item["id"] = rollup.categoryId;
+                item["parentId"] = rollup.parentId;
+                item["depth"] = rollup.depth;
+                item["total"] = rollup.total;
+                item["spent"] = rollup.spent;
+                item["subtreeTotal"] = rollup.subtreeTotal;
+                item["subtreeSpent"] = rollup.subtreeSpent;
+                jsonArray.push_back(item);
+            }
+
+            return returnJson(dm, jsonArray);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in GetCategoryRollups: " << e.what() << std::endl;
+            g_returnBuffer = "[]";
+            return g_returnBuffer.c_str();
         }
-
-        g_returnBuffer = jsonArray.dump();
-        return g_returnBuffer.c_str();
     }
 
-    // Analysis functions
-    double GetTotalIncome(void *manager, const char *monthYear)
+    const char *GetReportBundle(void *manager, const char *fromMonth, const char *toMonth)
     {
+        TraceSpan span("GetReportBundle", "api");
         DataManager *dm = static_cast<DataManager *>(manager);
-        return dm->getTotalIncome(monthYear);
+        try
+        {
+            ReportBundle bundle;
+            if (!dm->getReportBundle(fromMonth, toMonth, bundle))
+            {
+                g_returnBuffer = "{}";
+                return g_returnBuffer.c_str();
+            }
+            Metrics::Timer timer(dm->getMetrics(), MetricOperation::SerializeResult);
+
+            nlohmann::json months = nlohmann::json::array();
+            for (const auto &month : bundle.months)
+            {
+                nlohmann::json categories = nlohmann::json::array();
+                for (const auto &category : month.categories)
+                {
+                    nlohmann::json item;
+                    item["id"] = category.categoryId;
+                    item["total"] = category.total;
+                    item["spent"] = category.spent;
+                    if (category.hasBudget)
+                    {
+                        item["budget"] = category.allocated;
+                        item["utilization"] = category.utilization;
+                    }
+                    categories.push_back(item);
+                }
+
+                nlohmann::json item;
+                item["month"] = month.monthYear;
+                item["income"] = month.income;
+                item["expense"] = month.expense;
+                item["net"] = month.net;
+                item["categories"] = categories;
+                months.push_back(item);
+            }
+
+            nlohmann::json result;
+            result["from"] = bundle.fromMonth;
+            result["to"] = bundle.toMonth;
+            result["income"] = bundle.income;
+            result["expense"] = bundle.expense;
+            result["net"] = bundle.net;
+            result["months"] = months;
+            return returnJson(dm, result);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in GetReportBundle: " << e.what() << std::endl;
+            g_returnBuffer = "{}";
+            return g_returnBuffer.c_str();
+        }
     }
 
-    double GetTotalExpense(void *manager, const char *monthYear)
+    const char *GetTimeSeries(void *manager, const char *fromDate, const char *toDate, const char *interval, int windowDays)
     {
+        TraceSpan span("GetTimeSeries", "api");
         DataManager *dm = static_cast<DataManager *>(manager);
-        return dm->getTotalExpense(monthYear);
+        try
+        {
+            std::string intervalName = interval ? interval : "";
+            SeriesInterval seriesInterval;
+            if (intervalName == "day")
+            {
+                seriesInterval = SeriesInterval::Day;
+            }
+            else if (intervalName == "week")
+            {
+                seriesInterval = SeriesInterval::Week;
+            }
+            else if (intervalName == "month")
+            {
+                seriesInterval = SeriesInterval::Month;
+            }
+            else
+            {
+                std::cerr << "Invalid time series interval: " << intervalName << std::endl;
+                g_returnBuffer = "{}";
+                return g_returnBuffer.c_str();
+            }
+
+            std::vector<SeriesPoint> series;
+            if (windowDays < 0 || !dm->getTimeSeries(fromDate, toDate, seriesInterval, windowDays, series))
+            {
+                g_returnBuffer = "{}";
+                return g_returnBuffer.c_str();
+            }
+            Metrics::Timer timer(dm->getMetrics(), MetricOperation::SerializeResult);
+
+            nlohmann::json points = nlohmann::json::array();
+            for (const auto &point : series)
+            {
+                nlohmann::json item;
+                item["start"] = point.startDate;
+                item["end"] = point.endDate;
+                item["income"] = point.income;
+                item["expense"] = point.expense;
+                item["net"] = point.net;
+                item["balance"] = point.balance;
+                item["averageIncome"] = point.averageIncome;
+                item["averageExpense"] = point.averageExpense;
+                points.push_back(item);
+            }
+
+            nlohmann::json result;
+            result["from"] = fromDate;
+            result["to"] = toDate;
+            result["interval"] = intervalName;
+            result["window"] = windowDays;
+            result["points"] = points;
+            return returnJson(dm, result);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in GetTimeSeries: " << e.what() << std::endl;
+            g_returnBuffer = "{}";
+            return g_returnBuffer.c_str();
+        }
     }
 
-    const char *GetCategoryTotals(void *manager, const char *monthYear)
+    const char *GetTopTransactions(void *manager, const char *spec, int k)
     {
+        TraceSpan span("GetTopTransactions", "api");
         DataManager *dm = static_cast<DataManager *>(manager);
-        auto totals = dm->getCategoryTotals(monthYear);
+        try
+        {
+            TransactionQuery scope;
+            if (spec != nullptr && spec[0] != '\0')
+            {
+                scope = toTransactionQuery(nlohmann::json::parse(spec));
+            }
 
-        nlohmann::json jsonObject;
-        for (const auto &pair : totals)
+            auto transactions = dm->getTopTransactions(scope, k > 0 ? k : 0);
+            Metrics::Timer timer(dm->getMetrics(), MetricOperation::SerializeResult);
+            auto categoryNames = getCategoryNames(dm);
+
+            nlohmann::json jsonArray = nlohmann::json::array();
+            for (const auto &transaction : transactions)
+            {
+                jsonArray.push_back(transactionToJson(transaction, categoryNames));
+            }
+
+            return returnJson(dm, jsonArray);
+        }
+        catch (const std::exception &e)
         {
-            jsonObject[std::to_string(pair.first)] = pair.second;
+            std::cerr << "Error in GetTopTransactions: " << e.what() << std::endl;
+            g_returnBuffer = "[]";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    const char *GetAmountStatistics(void *manager, const char *spec, const char *percentiles, bool byCategory)
+    {
+        TraceSpan span("GetAmountStatistics", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            TransactionQuery scope;
+            if (spec != nullptr && spec[0] != '\0')
+            {
+                scope = toTransactionQuery(nlohmann::json::parse(spec));
+            }
+            std::vector<double> requested = {50.0, 90.0};
+            if (percentiles != nullptr && percentiles[0] != '\0')
+            {
+                requested = nlohmann::json::parse(percentiles).get<std::vector<double>>();
+            }
+
+            auto statistics = dm->getAmountStatistics(scope, requested, byCategory);
+            Metrics::Timer timer(dm->getMetrics(), MetricOperation::SerializeResult);
+
+            nlohmann::json jsonArray = nlohmann::json::array();
+            for (const auto &group : statistics)
+            {
+                nlohmann::json values = nlohmann::json::array();
+                for (size_t i = 0; i < requested.size(); i++)
+                {
+                    values.push_back({{"p", requested[i]}, {"value", group.percentiles[i]}});
+                }
+
+                nlohmann::json item;
+                if (byCategory)
+                {
+                    item["categoryId"] = group.categoryId;
+                }
+                item["count"] = group.count;
+                item["min"] = group.min;
+                item["max"] = group.max;
+                item["mean"] = group.mean;
+                item["percentiles"] = values;
+                jsonArray.push_back(item);
+            }
+
+            return returnJson(dm, jsonArray);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in GetAmountStatistics: " << e.what() << std::endl;
+            g_returnBuffer = "[]";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    const char *FindRecurringTransactions(void *manager, double amountTolerance, int minOccurrences)
+    {
+        TraceSpan span("FindRecurringTransactions", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            auto series = dm->findRecurringTransactions(amountTolerance, minOccurrences > 0 ? static_cast<size_t>(minOccurrences) : 0);
+            Metrics::Timer timer(dm->getMetrics(), MetricOperation::SerializeResult);
+
+            nlohmann::json jsonArray = nlohmann::json::array();
+            for (const auto &entry : series)
+            {
+                nlohmann::json item;
+                item["description"] = entry.description;
+                item["categoryId"] = entry.categoryId;
+                item["isIncome"] = entry.isIncome;
+                item["period"] = recurrencePeriodName(entry.period);
+                item["amount"] = entry.amount;
+                item["meanInterval"] = entry.meanInterval;
+                item["intervalDeviation"] = entry.intervalDeviation;
+                item["regularity"] = entry.regularity;
+                item["occurrences"] = entry.transactionIds.size();
+                item["firstDate"] = entry.firstDate;
+                item["lastDate"] = entry.lastDate;
+                item["nextDate"] = entry.nextDate;
+                item["transactionIds"] = entry.transactionIds;
+                jsonArray.push_back(item);
+            }
+
+            return returnJson(dm, jsonArray);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in FindRecurringTransactions: " << e.what() << std::endl;
+            g_returnBuffer = "[]";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    // Metrics
+    const char *GetMetrics(void *manager)
+    {
+        TraceSpan span("GetMetrics", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            const Metrics &metrics = dm->getMetrics();
+
+            nlohmann::json operations = nlohmann::json::object();
+            for (size_t i = 0; i < static_cast<size_t>(MetricOperation::Count); i++)
+            {
+                MetricOperation operation = static_cast<MetricOperation>(i);
+                LatencyHistogram histogram = metrics.getHistogram(operation);
+
+                nlohmann::json item;
+                item["count"] = histogram.getCount();
+                item["meanUs"] = histogram.getMean() / 1000.0;
+                item["p50Us"] = histogram.getPercentile(50) / 1000.0;
+                item["p90Us"] = histogram.getPercentile(90) / 1000.0;
+                item["p99Us"] = histogram.getPercentile(99) / 1000.0;
+                item["p999Us"] = histogram.getPercentile(99.9) / 1000.0;
+                item["maxUs"] = histogram.getMax() / 1000.0;
+                operations[Metrics::operationName(operation)] = item;
+            }
+
+            nlohmann::json counters = nlohmann::json::object();
+            for (size_t i = 0; i < static_cast<size_t>(MetricCounter::Count); i++)
+            {
+                MetricCounter counter = static_cast<MetricCounter>(i);
+                counters[Metrics::counterName(counter)] = metrics.getCounter(counter);
+            }
+
+            nlohmann::json result;
+            result["operations"] = operations;
+            result["counters"] = counters;
+
+            g_returnBuffer = result.dump();
+            return g_returnBuffer.c_str();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in GetMetrics: " << e.what() << std::endl;
+            g_returnBuffer = "{}";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    void ResetMetrics(void *manager)
+    {
+        TraceSpan span("ResetMetrics", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        dm->getMetrics().reset();
+    }
+
+    // Memory accounting
+    const char *GetMemoryStats(void *manager)
+    {
+        TraceSpan span("GetMemoryStats", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            MemoryStats stats = dm->getMemoryStats();
+
+            nlohmann::json result;
+            result["transactionRecords"] = stats.transactionRecords;
+            result["categoryRecords"] = stats.categoryRecords;
+            result["budgetRecords"] = stats.budgetRecords;
+            result["stringPayloads"] = stats.stringPayloads;
+            result["indexes"] = stats.indexes;
+            result["changeLog"] = stats.changeLog;
+            result["undoLog"] = stats.undoLog;
+            result["returnBuffer"] = g_returnBuffer.capacity();
+            result["total"] = stats.total + g_returnBuffer.capacity();
+            result["peakLoadTransient"] = stats.peakLoadTransient;
+            result["peakSaveTransient"] = stats.peakSaveTransient;
+
+            g_returnBuffer = result.dump();
+            return g_returnBuffer.c_str();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in GetMemoryStats: " << e.what() << std::endl;
+            g_returnBuffer = "{}";
+            return g_returnBuffer.c_str();
+        }
+    }
+
+    long long Compact(void *manager)
+    {
+        TraceSpan span("Compact", "api");
+        DataManager *dm = static_cast<DataManager *>(manager);
+        try
+        {
+            size_t before = dm->getMemoryStats().total + g_returnBuffer.capacity();
+
+            dm->compact();
+            std::string().swap(g_returnBuffer);
+
+            size_t after = dm->getMemoryStats().total + g_returnBuffer.capacity();
+            return before > after ? static_cast<long long>(before - after) : 0;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in Compact: " << e.what() << std::endl;
+            return -1;
+        }
+    }
+
+    // Tracing
+    bool StartTracing(const char *filePath)
+    {
+        if (filePath == nullptr || filePath[0] == '\0')
+        {
+            return false;
+        }
+        return Tracer::instance().start(filePath);
+    }
+
+    bool StopTracing()
+    {
+        return Tracer::instance().stop();
+    }
+
+    // Asynchronous operations
+    bool AddCategoryAsync(void *manager, const char *name, const char *description, const char *color, BudgetTrackerCallback callback, void *userData)
+    {
+        TraceSpan span("AddCategoryAsync", "api");
+        return postAsync(manager, [=, name = std::string(name), description = std::string(description), color = std::string(color)]()
+                         {
+            int id = AddCategory(manager, name.c_str(), description.c_str(), color.c_str());
+            if (callback != nullptr)
+            {
+                callback(userData, id >= 0, id, nullptr);
+            } });
+    }
+
+    bool UpdateCategoryAsync(void *manager, int id, const char *name, const char *description, const char *color, BudgetTrackerCallback callback, void *userData)
+    {
+        TraceSpan span("UpdateCategoryAsync", "api");
+        return postAsync(manager, [=, name = std::string(name), description = std::string(description), color = std::string(color)]()
+                         {
+            bool success = UpdateCategory(manager, id, name.c_str(), description.c_str(), color.c_str());
+            if (callback != nullptr)
+            {
+                callback(userData, success, 0, nullptr);
+            } });
+    }
+
+    bool DeleteCategoryAsync(void *manager, int categoryId, BudgetTrackerCallback callback, void *userData)
+    {
+        TraceSpan span("DeleteCategoryAsync", "api");
+        return postAsync(manager, [=]()
+                         {
+            bool success = DeleteCategory(manager, categoryId);
+            if (callback != nullptr)
+            {
+                callback(userData, success, 0, nullptr);
+            } });
+    }
+
+    bool AddTransactionAsync(void *manager, const char *date, double amount, const char *description, int categoryId, bool isIncome, BudgetTrackerCallback callback, void *userData)
+    {
+        TraceSpan span("AddTransactionAsync", "api");
+        return postAsync(manager, [=, date = std::string(date), description = std::string(description)]()
+                         {
+            int id = AddTransaction(manager, date.c_str(), amount, description.c_str(), categoryId, isIncome);
+            if (callback != nullptr)
+            {
+                callback(userData, id >= 0, id, nullptr);
+            } });
+    }
+
+    bool UpdateTransactionAsync(void *manager, int id, const char *date, double amount, const char *description, int categoryId, bool isIncome, BudgetTrackerCallback callback, void *userData)
+    {
+        TraceSpan span("UpdateTransactionAsync", "api");
+        return postAsync(manager, [=, date = std::string(date), description = std::string(description)]()
+                         {
+            bool success = UpdateTransaction(manager, id, date.c_str(), amount, description.c_str(), categoryId, isIncome);
+            if (callback != nullptr)
+            {
+                callback(userData, success, 0, nullptr);
+            } });
+    }
+
+    bool DeleteTransactionAsync(void *manager, int transactionId, BudgetTrackerCallback callback, void *userData)
+    {
+        TraceSpan span("DeleteTransactionAsync", "api");
+        return postAsync(manager, [=]()
+                         {
+            bool success = DeleteTransaction(manager, transactionId);
+            if (callback != nullptr)
+            {
+                callback(userData, success, 0, nullptr);
+            } });
+    }
+
+    bool AddTransactionsBatchAsync(void *manager, int count, const char **dates, const double *amounts, const char **descriptions, const int *categoryIds, const bool *isIncome, BudgetTrackerCallback callback, void *userData)
+    {
+        TraceSpan span("AddTransactionsBatchAsync", "api");
+        if (count <= 0 || dates == nullptr || amounts == nullptr || descriptions == nullptr || categoryIds == nullptr || isIncome == nullptr)
+        {
+            std::cerr << "Invalid arguments to AddTransactionsBatchAsync" << std::endl;
+            return false;
+        }
+
+        // Copy the caller's arrays, they may be freed as soon as we return
+        auto transactions = std::make_shared<std::vector<Transaction>>();
+        try
+        {
+            transactions->reserve(count);
+            for (int i = 0; i < count; i++)
+            {
+                transactions->emplace_back(0, dates[i], amounts[i], descriptions[i], categoryIds[i], isIncome[i]);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error in AddTransactionsBatchAsync: " << e.what() << std::endl;
+            return false;
+        }
+
+        return postAsync(manager, [=]()
+                         {
+            DataManager *dm = static_cast<DataManager *>(manager);
+            bool success = dm->addTransactionsBatch(*transactions);
+
+            nlohmann::json ids = nlohmann::json::array();
+            if (success)
+            {
+                for (const auto &transaction : *transactions)
+                {
+                    ids.push_back(transaction.getId());
+                }
+            }
+
+            if (callback != nullptr)
+            {
+                std::string result = ids.dump();
+                callback(userData, success, success ? count : 0, result.c_str());
+            } });
+    }
+
+    bool AddBudgetAsync(void *manager, int categoryId, const char *monthYear, double allocatedAmount, BudgetTrackerCallback callback, void *userData)
+    {
+        TraceSpan span("AddBudgetAsync", "api");
+        return postAsync(manager, [=, monthYear = std::string(monthYear)]()
+                         {
+            bool success = AddBudget(manager, categoryId, monthYear.c_str(), allocatedAmount);
+            if (callback != nullptr)
+            {
+                callback(userData, success, 0, nullptr);
+            } });
+    }
+
+    bool UpdateBudgetAsync(void *manager, int categoryId, const char *monthYear, double allocatedAmount, BudgetTrackerCallback callback, void *userData)
+    {
+        TraceSpan span("UpdateBudgetAsync", "api");
+        return postAsync(manager, [=, monthYear = std::string(monthYear)]()
+                         {
+            bool success = UpdateBudget(manager, categoryId, monthYear.c_str(), allocatedAmount);
+            if (callback != nullptr)
+            {
+                callback(userData, success, 0, nullptr);
+            } });
+    }
+
+    bool DeleteBudgetAsync(void *manager, int categoryId, const char *monthYear, BudgetTrackerCallback callback, void *userData)
+    {
+        TraceSpan span("DeleteBudgetAsync", "api");
+        return postAsync(manager, [=, monthYear = std::string(monthYear)]()
+                         {
+            bool success = DeleteBudget(manager, categoryId, monthYear.c_str());
+            if (callback != nullptr)
+            {
+                callback(userData, success, 0, nullptr);
+            } });
+    }
+
+    bool GetAllTransactionsAsync(void *manager, BudgetTrackerCallback callback, void *userData)
+    {
+        TraceSpan span("GetAllTransactionsAsync", "api");
+        return postAsync(manager, [=]()
+                         {
+            const char *result = GetAllTransactions(manager);
+            if (callback != nullptr)
+            {
+                callback(userData, true, 0, result);
+            } });
+    }
+
+    bool GetTransactionsByMonthAsync(void *manager, const char *monthYear, BudgetTrackerCallback callback, void *userData)
+    {
+        TraceSpan span("GetTransactionsByMonthAsync", "api");
+        return postAsync(manager, [=, monthYear = std::string(monthYear)]()
+                         {
+            const char *result = GetTransactionsByMonth(manager, monthYear.c_str());
+            if (callback != nullptr)
+            {
+                callback(userData, true, 0, result);
+            } });
+    }
+
+    bool GetTotalIncomeAsync(void *manager, const char *monthYear, BudgetTrackerCallback callback, void *userData)
+    {
+        TraceSpan span("GetTotalIncomeAsync", "api");
+        return postAsync(manager, [=, monthYear = std::string(monthYear)]()
+                         {
+            double total = GetTotalIncome(manager, monthYear.c_str());
+            if (callback != nullptr)
+            {
+                callback(userData, true, total, nullptr);
+            } });
+    }
+
+    bool GetTotalExpenseAsync(void *manager, const char *monthYear, BudgetTrackerCallback callback, void *userData)
+    {
+        TraceSpan span("GetTotalExpenseAsync", "api");
+        return postAsync(manager, [=, monthYear = std::string(monthYear)]()
+                         {
+            double total = GetTotalExpense(manager, monthYear.c_str());
+            if (callback != nullptr)
+            {
+                callback(userData, true, total, nullptr);
+            } });
+    }
+
+    bool GetCategoryTotalsAsync(void *manager, const char *monthYear, BudgetTrackerCallback callback, void *userData)
+    {
+        TraceSpan span("GetCategoryTotalsAsync", "api");
+        return postAsync(manager, [=, monthYear = std::string(monthYear)]()
+                         {
+            const char *result = GetCategoryTotals(manager, monthYear.c_str());
+            if (callback != nullptr)
+            {
+                callback(userData, true, 0, result);
+            } });
+    }
+
+    void WaitForAsyncOperations(void *manager)
+    {
+        TraceSpan span("WaitForAsyncOperations", "api");
+        // Holding a reference keeps the executor alive if the handle is destroyed meanwhile
+        std::shared_ptr<AsyncExecutor> executor;
+        {
+            std::lock_guard<std::mutex> lock(g_managerMapMutex);
+            auto it = g_executors.find(manager);
+            if (it != g_executors.end())
+            {
+                executor = it->second;
+            }
         }
 
-        g_returnBuffer = jsonObject.dump();
-        return g_returnBuffer.c_str();
+        if (executor)
+        {
+            executor->waitIdle();
+        }
     }
-}
\ No newline at end of file
+}
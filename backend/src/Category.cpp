@@ -1,27 +1,30 @@
 
 #include "../include/Category.h"
 #include <sstream>
+#include "../include/MemoryUsage.h"
 
 // Constructor implementation
 Category::Category(int id, const std::string &name,
-                   const std::string &description, const std::string &color)
-    : id(id), name(name), description(description), color(color) {}
+                   const std::string &description, const std::string &color, int parentId)
+    : id(id), name(name), description(description), color(color), parentId(parentId) {}
 
 // Default constructor
 Category::Category()
-    : id(0), name(""), description(""), color("#000000") {}
+    : id(0), name(""), description(""), color("#000000"), parentId(0) {}
 
 // Getters implementation
 int Category::getId() const { return id; }
 std::string Category::getName() const { return name; }
 std::string Category::getDescription() const { return description; }
 std::string Category::getColor() const { return color; }
+int Category::getParentId() const { return parentId; }
 
 // Setters implementation
 void Category::setId(int id) { this->id = id; }
 void Category::setName(const std::string &name) { this->name = name; }
 void Category::setDescription(const std::string &description) { this->description = description; }
 void Category::setColor(const std::string &color) { this->color = color; }
+void Category::setParentId(int parentId) { this->parentId = parentId; }
 
 // Utility function implementation
 std::string Category::toString() const
@@ -30,6 +33,12 @@ std::string Category::toString() const
     oss << "Category [ID: " << id
         << ", Name: " << name
         << ", Description: " << description
-        << ", Color: " << color << "]";
+        << ", Color: " << color
+        << ", Parent ID: " << parentId << "]";
     return oss.str();
-}
\ No newline at end of file
+}
+
+size_t Category::getHeapSize() const
+{
+    return stringHeapSize(name) + stringHeapSize(description) + stringHeapSize(color);
+}
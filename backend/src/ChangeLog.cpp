@@ -0,0 +1,109 @@
+#include "../include/ChangeLog.h"
+#include <algorithm>
+#include <map>
+#include "../include/MemoryUsage.h"
+
+ChangeLog::ChangeLog(size_t capacity)
+    : capacity(capacity), version(0), floorVersion(0) {}
+
+unsigned long long ChangeLog::record(ChangeCollection collection, ChangeType type, const ChangeKey &key)
+{
+    entries.push_back({++version, collection, type, key});
+
+    // Drop the oldest change; clients that haven't seen it must resync
+    if (entries.size() > capacity)
+    {
+        floorVersion = entries.front().version;
+        entries.pop_front();
+    }
+    return version;
+}
+
+void ChangeLog::reset()
+{
+    entries.clear();
+    floorVersion = ++version;
+}
+
+unsigned long long ChangeLog::getVersion() const
+{
+    return version;
+}
+
+bool ChangeLog::covers(unsigned long long sinceVersion) const
+{
+    return sinceVersion >= floorVersion && sinceVersion <= version;
+}
+
+void ChangeLog::collect(unsigned long long sinceVersion, ChangeCollection collection,
+                        std::vector<ChangeKey> &inserted, std::vector<ChangeKey> &updated,
+                        std::vector<ChangeKey> &deleted) const
+{
+    // First and last change per record, in order of first appearance
+    struct History
+    {
+        ChangeType first;
+        ChangeType last;
+        size_t order;
+    };
+    std::map<std::pair<int, std::string>, History> histories;
+    std::vector<std::pair<int, std::string>> order;
+
+    auto start = std::upper_bound(entries.begin(), entries.end(), sinceVersion,
+                                  [](unsigned long long v, const Entry &entry)
+                                  { return v < entry.version; });
+    for (auto it = start; it != entries.end(); ++it)
+    {
+        if (it->collection != collection)
+        {
+            continue;
+        }
+
+        auto key = std::make_pair(it->key.id, it->key.monthYear);
+        auto found = histories.find(key);
+        if (found == histories.end())
+        {
+            histories.emplace(key, History{it->type, it->type, order.size()});
+            order.push_back(key);
+        }
+        else
+        {
+            found->second.last = it->type;
+        }
+    }
+
+    for (const auto &key : order)
+    {
+        const History &history = histories.at(key);
+        bool existedBefore = history.first != ChangeType::Inserted;
+        bool existsNow = history.last != ChangeType::Deleted;
+
+        if (!existedBefore && existsNow)
+        {
+            inserted.push_back({key.first, key.second});
+        }
+        else if (existedBefore && existsNow)
+        {
+            updated.push_back({key.first, key.second});
+        }
+        else if (existedBefore && !existsNow)
+        {
+            deleted.push_back({key.first, key.second});
+        }
+    }
+}
+
+size_t ChangeLog::getMemoryUsage() const
+{
+    size_t bytes = entries.size() * sizeof(Entry);
+    for (const auto &entry : entries)
+    {
+        bytes += stringHeapSize(entry.key.monthYear);
+    }
+    return bytes;
+}
+
+void ChangeLog::shrinkToFit()
+{
+    entries.shrink_to_fit();
+}
@@ -0,0 +1,261 @@
+#include "../include/DailyLedger.h"
+#include <algorithm>
+#include <cstdio>
+
+// Days from 1970-01-01 to a civil date, valid for any proleptic Gregorian date
+static int daysFromCivil(int year, int month, int day)
+{
+    year -= month <= 2 ? 1 : 0;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+// Inverse of daysFromCivil
+static void civilFromDays(int days, int &year, int &month, int &day)
+{
+    days += 719468;
+    int era = (days >= 0 ? days : days - 146096) / 146097;
+    int dayOfEra = days - era * 146097;
+    int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int shiftedMonth = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+    month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+    year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+static int daysInMonth(int year, int month)
+{
+    static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : days[month - 1];
+}
+
+const int DailyLedger::kFirstDay;
+
+DailyLedger::DailyLedger() : firstDay(0), validPrefix(1)
+{
+    prefixIncome.assign(1, 0.0);
+    prefixExpense.assign(1, 0.0);
+}
+
+bool DailyLedger::toDayNumber(const std::string &date, int &day)
+{
+    if (date.size() < 10 || date[4] != '-' || date[7] != '-')
+    {
+        return false;
+    }
+
+    int fields[3] = {0, 0, 0};
+    const int starts[3] = {0, 5, 8};
+    const int lengths[3] = {4, 2, 2};
+    for (int field = 0; field < 3; field++)
+    {
+        for (int i = starts[field]; i < starts[field] + lengths[field]; i++)
+        {
+            if (date[i] < '0' || date[i] > '9')
+            {
+                return false;
+            }
+            fields[field] = fields[field] * 10 + (date[i] - '0');
+        }
+    }
+
+    int year = fields[0];
+    int month = fields[1];
+    if (year < kFirstYear || year > kLastYear || month < 1 || month > 12 || fields[2] < 1 ||
+        fields[2] > daysInMonth(year, month))
+    {
+        return false;
+    }
+    day = daysFromCivil(year, month, fields[2]);
+    return true;
+}
+
+std::string DailyLedger::fromDayNumber(int day)
+{
+    int year, month, dayOfMonth;
+    civilFromDays(day, year, month, dayOfMonth);
+    // Sized for any three ints, so no field can be cut off
+    char buffer[36];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", year, month, dayOfMonth);
+    return buffer;
+}
+
+int DailyLedger::bucketEnd(int day, SeriesInterval interval)
+{
+    switch (interval)
+    {
+    case SeriesInterval::Week:
+    {
+        // 1970-01-01 was a Thursday; weekday 0 is Monday
+        int weekday = ((day + 3) % 7 + 7) % 7;
+        return day + 6 - weekday;
+    }
+    case SeriesInterval::Month:
+    {
+        int year, month, dayOfMonth;
+        civilFromDays(day, year, month, dayOfMonth);
+        return day + daysInMonth(year, month) - dayOfMonth;
+    }
+    default:
+        return day;
+    }
+}
+
+int DailyLedger::addMonths(int day, int months)
+{
+    int year, month, dayOfMonth;
+    civilFromDays(day, year, month, dayOfMonth);
+    int ordinal = year * 12 + month - 1 + months;
+    year = (ordinal >= 0 ? ordinal : ordinal - 11) / 12;
+    month = ordinal - year * 12 + 1;
+    return daysFromCivil(year, month, std::min(dayOfMonth, daysInMonth(year, month)));
+}
+
+void DailyLedger::add(const Transaction &transaction, double amount)
+{
+    apply(transaction, amount, 1);
+}
+
+void DailyLedger::remove(const Transaction &transaction, double amount)
+{
+    apply(transaction, amount, -1);
+}
+
+void DailyLedger::clear()
+{
+    firstDay = 0;
+    income.clear();
+    expense.clear();
+    counts.clear();
+    prefixIncome.assign(1, 0.0);
+    prefixExpense.assign(1, 0.0);
+    validPrefix = 1;
+}
+
+double DailyLedger::sumIncome(int first, int last) const
+{
+    return sumRange(prefixIncome, first, last);
+}
+
+double DailyLedger::sumExpense(int first, int last) const
+{
+    return sumRange(prefixExpense, first, last);
+}
+
+void DailyLedger::shrinkToFit()
+{
+    income.shrink_to_fit();
+    expense.shrink_to_fit();
+    counts.shrink_to_fit();
+    prefixIncome.shrink_to_fit();
+    prefixExpense.shrink_to_fit();
+}
+
+size_t DailyLedger::getMemoryUsage() const
+{
+    return (income.capacity() + expense.capacity() + prefixIncome.capacity() + prefixExpense.capacity()) * sizeof(double) +
+           counts.capacity() * sizeof(uint32_t);
+}
+
+void DailyLedger::apply(const Transaction &transaction, double amount, int sign)
+{
+    int day;
+    if (!toDayNumber(transaction.getDate(), day))
+    {
+        return;
+    }
+    if (sign < 0 && (day < firstDay || day >= firstDay + static_cast<int>(counts.size())))
+    {
+        return;
+    }
+
+    size_t index = cover(day);
+    std::vector<double> &totals = transaction.getIsIncome() ? income : expense;
+    if (sign > 0)
+    {
+        counts[index]++;
+        totals[index] += amount;
+    }
+    else if (counts[index] > 0 && --counts[index] == 0)
+    {
+        income[index] = expense[index] = 0.0;
+    }
+    else
+    {
+        totals[index] -= amount;
+    }
+
+    // Prefix entries up to and including this day's own entry are unaffected
+    if (validPrefix > index + 1)
+    {
+        validPrefix = index + 1;
+    }
+}
+
+size_t DailyLedger::cover(int day)
+{
+    if (counts.empty())
+    {
+        firstDay = day;
+    }
+    else if (day < firstDay)
+    {
+        // Earlier dates are rare, so shifting the arrays is acceptable
+        size_t shift = static_cast<size_t>(firstDay - day);
+        income.insert(income.begin(), shift, 0.0);
+        expense.insert(expense.begin(), shift, 0.0);
+        counts.insert(counts.begin(), shift, 0);
+        firstDay = day;
+        validPrefix = 1;
+    }
+
+    size_t index = static_cast<size_t>(day - firstDay);
+    if (index >= counts.size())
+    {
+        income.resize(index + 1, 0.0);
+        expense.resize(index + 1, 0.0);
+        counts.resize(index + 1, 0);
+    }
+    return index;
+}
+
+void DailyLedger::refresh() const
+{
+    if (validPrefix.load(std::memory_order_acquire) == counts.size() + 1)
+    {
+        return;
+    }
+
+    // Readers share the DataManager lock, so only one of them brings the sums up to date
+    std::lock_guard<std::mutex> lock(refreshMutex);
+    size_t valid = validPrefix.load(std::memory_order_relaxed);
+    if (valid == counts.size() + 1)
+    {
+        return;
+    }
+    prefixIncome.resize(counts.size() + 1);
+    prefixExpense.resize(counts.size() + 1);
+    for (size_t i = std::max<size_t>(valid, 1); i <= counts.size(); i++)
+    {
+        prefixIncome[i] = prefixIncome[i - 1] + income[i - 1];
+        prefixExpense[i] = prefixExpense[i - 1] + expense[i - 1];
+    }
+    validPrefix.store(counts.size() + 1, std::memory_order_release);
+}
+
+double DailyLedger::sumRange(const std::vector<double> &prefix, int first, int last) const
+{
+    refresh();
+    long long begin = std::max<long long>(static_cast<long long>(first) - firstDay, 0);
+    long long end = std::min<long long>(static_cast<long long>(last) - firstDay + 1, static_cast<long long>(counts.size()));
+    if (begin >= end)
+    {
+        return 0.0;
+    }
+    return prefix[static_cast<size_t>(end)] - prefix[static_cast<size_t>(begin)];
+}
@@ -1,8 +1,106 @@
 
 #include "../include/DataManager.h"
+#include <algorithm>
 #include <iostream>
 #include <filesystem>
 #include <map>
+#include <unordered_set>
+#include <mutex>
+#include <cstdio>
+#include <limits>
+#include "../include/ThreadPool.h"
+#include "../include/MemoryUsage.h"
+
+// Rows per chunk for parallel scans; ledgers up to one chunk are scanned serially
+static const size_t kScanGrainSize = 16384;
+
+// Rows a query filters together, each predicate passing over the whole block before the next
+static const size_t kQueryBlockSize = 1024;
+
+// Reading a row through an index costs about this many rows of sequential scan
+static const size_t kIndexCostFactor = 4;
+
+// Longest range a report bundle covers, which bounds its per-month arrays
+static const int kMaxReportMonths = 1200;
+
+// Over-budget alerts kept for takeBudgetAlerts() before the oldest are dropped
+static const size_t kMaxBudgetAlerts = 1024;
+
+// Largest category ID a query tests against a flag array rather than by binary search
+static const int kDenseCategoryLimit = 1 << 16;
+
+// Hash partitions of recurring-series candidates, merged and analyzed in parallel
+static const size_t kRecurringShards = 64;
+
+// Runs scan(partial, begin, end) over [0, count) in parallel chunks and returns
+// the per-chunk partials in chunk order, so merging them is deterministic
+template <typename Partial, typename Scan>
+static std::vector<Partial> scanInChunks(size_t count, Scan scan)
+{
+    std::vector<Partial> partials(ThreadPool::chunkCount(count, kScanGrainSize));
+    ThreadPool::shared().parallelFor(count, kScanGrainSize, [&](size_t chunk, size_t begin, size_t end)
+                                     { scan(partials[chunk], begin, end); });
+    return partials;
+}
+
+// Approximate heap footprint of an unordered_map: bucket array plus one node per entry
+template <typename Map>
+static size_t hashIndexBytes(const Map &map)
+{
+    return map.bucket_count() * sizeof(void *) +
+           map.size() * (sizeof(void *) + sizeof(size_t) + sizeof(typename Map::value_type));
+}
+
+// Approximate heap memory of a JSON DOM dumped to or parsed from a file of the given size.
+// Walking the DOM costs as much as building it, so the estimate scales the file size instead;
+// ledgers in the indented form saveToFile() writes come to about 3.4 DOM bytes per file byte.
+static size_t estimateJsonDomBytes(size_t fileBytes)
+{
+    return sizeof(json) + fileBytes / 5 * 17;
+}
+
+// Raises a peak counter to at least the given value
+static void raisePeak(std::atomic<size_t> &peak, size_t value)
+{
+    size_t current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+// Months since January of year 0 for a month key, -1 if the key is not a calendar month
+static int monthOrdinal(int monthKey)
+{
+    int month = monthKey % 100;
+    return monthKey >= 0 && month >= 1 && month <= 12 ? monthKey / 100 * 12 + month - 1 : -1;
+}
+
+// Joins per-chunk result lists in chunk order
+static std::vector<Transaction> concatenate(std::vector<std::vector<Transaction>> &partials)
+{
+    size_t total = 0;
+    for (const auto &partial : partials)
+    {
+        total += partial.size();
+    }
+
+    std::vector<Transaction> result;
+    result.reserve(total);
+    for (auto &partial : partials)
+    {
+        std::move(partial.begin(), partial.end(), std::back_inserter(result));
+    }
+    return result;
+}
+
+// An update that leaves the stored transaction's tags and currency as they are
+static Transaction withStoredTagsAndCurrency(const Transaction &update, const Transaction &stored)
+{
+    Transaction result = update;
+    result.setTags(stored.getTags());
+    result.setCurrency(stored.getCurrency());
+    return result;
+}
 
 // JSON serialization for Transaction
 void to_json(json &j, const Transaction &transaction)
@@ -14,6 +112,14 @@ void to_json(json &j, const Transaction &transaction)
         {"description", transaction.getDescription()},
         {"categoryId", transaction.getCategoryId()},
         {"isIncome", transaction.getIsIncome()}};
+    if (!transaction.getTags().empty())
+    {
+        j["tags"] = transaction.getTags();
+    }
+    if (!transaction.getCurrency().empty())
+    {
+        j["currency"] = transaction.getCurrency();
+    }
 }
 
 void from_json(const json &j, Transaction &transaction)
@@ -24,6 +130,8 @@ void from_json(const json &j, Transaction &transaction)
     transaction.setDescription(j.at("description").get<std::string>());
     transaction.setCategoryId(j.at("categoryId").get<int>());
     transaction.setIsIncome(j.at("isIncome").get<bool>());
+    transaction.setTags(j.value("tags", std::vector<std::string>()));
+    transaction.setCurrency(j.value("currency", ""));
 }
 
 // JSON serialization for Category
@@ -33,7 +141,8 @@ void to_json(json &j, const Category &category)
         {"id", category.getId()},
         {"name", category.getName()},
         {"description", category.getDescription()},
-        {"color", category.getColor()}};
+        {"color", category.getColor()},
+        {"parentId", category.getParentId()}};
 }
 
 void from_json(const json &j, Category &category)
@@ -42,6 +151,7 @@ void from_json(const json &j, Category &category)
     category.setName(j.at("name").get<std::string>());
     category.setDescription(j.at("description").get<std::string>());
     category.setColor(j.at("color").get<std::string>());
+    category.setParentId(j.value("parentId", 0)); // Files written before hierarchies have no parents
 }
 
 // JSON serialization for Budget
@@ -62,7 +172,9 @@ void from_json(const json &j, Budget &budget)
 
 // DataManager implementation
 DataManager::DataManager(const std::string &dataPath)
-    : dataPath(dataPath), nextTransactionId(1), nextCategoryId(1)
+    : dataPath(dataPath), nextTransactionId(1), nextCategoryId(1),
+      peakLoadBytes(0), peakSaveBytes(0), transactionsDirty(false), categoriesDirty(false), budgetsDirty(false),
+      ratesDirty(false), batchActive(false), batchNextTransactionId(1), batchNextCategoryId(1), batchAlertCount(0)
 {
 
     // Create data directory if it doesn't exist
@@ -87,18 +199,48 @@ std::string DataManager::getBudgetsFilePath() const
     return dataPath + "/budgets.json";
 }
 
-bool DataManager::saveToFile(const std::string &filePath, const json &jsonData) const
+std::string DataManager::getRatesFilePath() const
+{
+    return dataPath + "/rates.json";
+}
+
+bool DataManager::saveToFile(const std::string &filePath, const json &jsonData, size_t *fileBytes) const
 {
+    Metrics::Timer timer(metrics, MetricOperation::WriteFile);
+    timer.trace().addArg("file", filePath);
     try
     {
-        std::ofstream file(filePath);
-        if (!file.is_open())
+        // Write to a temporary file first so a failed save never leaves a half-written file behind
+        std::string tempPath = filePath + ".tmp";
         {
-            std::cerr << "Failed to open file for writing: " << filePath << std::endl;
-            return false;
+            std::ofstream file(tempPath);
+            if (!file.is_open())
+            {
+                std::cerr << "Failed to open file for writing: " << tempPath << std::endl;
+                return false;
+            }
+
+            {
+                TraceSpan span("json.dump", "json");
+                file << std::setw(4) << jsonData << std::endl;
+            }
+            if (!file)
+            {
+                std::cerr << "Failed to write file: " << tempPath << std::endl;
+                return false;
+            }
+
+            uint64_t written = static_cast<uint64_t>(file.tellp());
+            metrics.add(MetricCounter::BytesSerialized, written);
+            metrics.add(MetricCounter::BytesWritten, written);
+            timer.trace().addArg("bytes", written);
+            if (fileBytes != nullptr)
+            {
+                *fileBytes = static_cast<size_t>(written);
+            }
         }
 
-        file << std::setw(4) << jsonData << std::endl;
+        std::filesystem::rename(tempPath, filePath);
         return true;
     }
     catch (const std::exception &e)
@@ -108,8 +250,10 @@ bool DataManager::saveToFile(const std::string &filePath, const json &jsonData)
     }
 }
 
-bool DataManager::loadFromFile(const std::string &filePath, json &jsonData) const
+bool DataManager::loadFromFile(const std::string &filePath, json &jsonData, size_t *fileBytes) const
 {
+    Metrics::Timer timer(metrics, MetricOperation::ReadFile);
+    timer.trace().addArg("file", filePath);
     try
     {
         std::ifstream file(filePath);
@@ -129,10 +273,18 @@ bool DataManager::loadFromFile(const std::string &filePath, json &jsonData) cons
             return true;
         }
 
+        metrics.add(MetricCounter::BytesRead, static_cast<uint64_t>(file.tellg()));
+        if (fileBytes != nullptr)
+        {
+            *fileBytes = static_cast<size_t>(file.tellg());
+        }
+        timer.trace().addArg("bytes", static_cast<long long>(file.tellg()));
+
         // Reset to start of file
         file.seekg(0, std::ios::beg);
 
         // Parse JSON
+        TraceSpan span("json.parse", "json");
         file >> jsonData;
         return true;
     }
@@ -144,385 +296,2602 @@ bool DataManager::loadFromFile(const std::string &filePath, json &jsonData) cons
     }
 }
 
-// Category operations
-bool DataManager::addCategory(Category &category)
+// Index maintenance
+std::string DataManager::budgetKey(int categoryId, const std::string &monthYear)
+{
+    return monthYear + "#" + std::to_string(categoryId);
+}
+
+int DataManager::toMonthKey(const std::string &date)
 {
-    // Assign a new ID if the category doesn't have one
-    if (category.getId() == 0)
+    if (date.size() < 7 || date[4] != '-')
     {
-        category.setId(nextCategoryId++);
+        return -1;
     }
 
-    // Check if a category with this ID already exists
-    for (size_t i = 0; i < categories.size(); i++)
+    int key = 0;
+    for (int i : {0, 1, 2, 3, 5, 6})
     {
-        if (categories[i].getId() == category.getId())
+        if (date[i] < '0' || date[i] > '9')
         {
-            return false; // Category ID already exists
+            return -1;
         }
+        key = key * 10 + (date[i] - '0');
     }
-
-    categories.push_back(category);
-    return saveAllData();
+    return key;
 }
 
-bool DataManager::updateCategory(const Category &category)
+int DataManager::toQueryMonthKey(const std::string &monthYear)
 {
-    for (size_t i = 0; i < categories.size(); i++)
-    {
-        if (categories[i].getId() == category.getId())
-        {
-            categories[i] = category;
-            return saveAllData();
-        }
-    }
-    return false; // Category not found
+    // Only an exact "YYYY-MM" can match the 7-character prefix of a date
+    return monthYear.size() == 7 ? toMonthKey(monthYear) : -1;
 }
 
-bool DataManager::deleteCategory(int categoryId)
+std::string DataManager::fromMonthKey(int monthKey)
 {
-    for (size_t i = 0; i < categories.size(); i++)
-    {
-        if (categories[i].getId() == categoryId)
-        {
-            categories.erase(categories.begin() + i);
-            return saveAllData();
-        }
-    }
-    return false; // Category not found
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d", monthKey / 100, monthKey % 100);
+    return buffer;
 }
 
-Category *DataManager::getCategoryById(int categoryId)
+bool DataManager::matchesMonth(size_t slot, int monthKey, const std::string &monthYear) const
 {
-    for (size_t i = 0; i < categories.size(); i++)
+    if (monthKey >= 0)
     {
-        if (categories[i].getId() == categoryId)
-        {
-            return &categories[i];
-        }
+        return transactionMonths[slot] == monthKey;
     }
-    return nullptr; // Category not found
+    return transactionMonths[slot] < 0 && transactions[slot].getDate().substr(0, 7) == monthYear;
 }
 
-std::vector<Category> DataManager::getAllCategories() const
+DataManager::FilterBounds DataManager::toFilterBounds(const TransactionFilter &filter)
 {
-    return categories;
+    FilterBounds bounds;
+    bounds.monthKey = filter.monthYear.empty() ? -1 : toQueryMonthKey(filter.monthYear);
+    bounds.fromMonth = filter.fromDate.empty() ? -1 : toMonthKey(filter.fromDate);
+    bounds.toMonth = filter.toDate.empty() ? -1 : toMonthKey(filter.toDate);
+    return bounds;
 }
 
-// Transaction operations
-bool DataManager::addTransaction(Transaction &transaction)
+bool DataManager::matchesFilter(size_t slot, const TransactionFilter &filter, const FilterBounds &bounds) const
 {
-    // Assign a new ID if the transaction doesn't have one
-    if (transaction.getId() == 0)
+    int month = transactionMonths[slot];
+    if (!filter.monthYear.empty() && !matchesMonth(slot, bounds.monthKey, filter.monthYear))
+    {
+        return false;
+    }
+    if (month >= 0 && ((bounds.fromMonth >= 0 && month < bounds.fromMonth) || (bounds.toMonth >= 0 && month > bounds.toMonth)))
     {
-        transaction.setId(nextTransactionId++);
+        return false;
     }
 
-    // Check if a transaction with this ID already exists
-    for (size_t i = 0; i < transactions.size(); i++)
+    const Transaction &transaction = transactions[slot];
+    if (filter.categoryId >= 0 && transaction.getCategoryId() != filter.categoryId)
     {
-        if (transactions[i].getId() == transaction.getId())
-        {
-            return false; // Transaction ID already exists
-        }
+        return false;
     }
 
-    transactions.push_back(transaction);
-    return saveAllData();
+    // Rows strictly inside the month range need no date comparison
+    bool checkFrom = !filter.fromDate.empty() && (month < 0 || bounds.fromMonth < 0 || month == bounds.fromMonth);
+    bool checkTo = !filter.toDate.empty() && (month < 0 || bounds.toMonth < 0 || month == bounds.toMonth);
+    return !(checkFrom && transaction.getDate() < filter.fromDate) &&
+           !(checkTo && transaction.getDate().compare(0, filter.toDate.size(), filter.toDate) > 0);
 }
 
-bool DataManager::updateTransaction(const Transaction &transaction)
+DataManager::PreparedQuery DataManager::prepareQuery(const TransactionQuery &query) const
 {
-    for (size_t i = 0; i < transactions.size(); i++)
+    const TransactionFilter &filter = query.getDateFilter();
+    PreparedQuery prepared;
+    prepared.query = &query;
+    prepared.bounds = toFilterBounds(filter);
+    prepared.hasDatePredicate = !filter.monthYear.empty() || !filter.fromDate.empty() || !filter.toDate.empty();
+    prepared.lowMonth = prepared.bounds.fromMonth >= 0 ? prepared.bounds.fromMonth : 0;
+    prepared.highMonth = prepared.bounds.toMonth >= 0 ? prepared.bounds.toMonth : std::numeric_limits<int>::max();
+    prepared.keepIrregular = true;
+    if (!filter.monthYear.empty() && prepared.bounds.monthKey >= 0)
     {
-        if (transactions[i].getId() == transaction.getId())
-        {
-            transactions[i] = transaction;
-            return saveAllData();
-        }
+        // Dates starting with a regular month always have a month key
+        prepared.lowMonth = std::max(prepared.lowMonth, prepared.bounds.monthKey);
+        prepared.highMonth = std::min(prepared.highMonth, prepared.bounds.monthKey);
+        prepared.keepIrregular = false;
+    }
+    else if (!filter.monthYear.empty())
+    {
+        // An irregular month can only match dates that have no month key
+        prepared.lowMonth = 1;
+        prepared.highMonth = 0;
     }
-    return false; // Transaction not found
-}
 
-bool DataManager::deleteTransaction(int transactionId)
-{
-    for (size_t i = 0; i < transactions.size(); i++)
+    const std::vector<int> &categoryIds = query.getCategoryIds();
+    if (!categoryIds.empty() && categoryIds.front() >= 0 && categoryIds.back() < kDenseCategoryLimit)
     {
-        if (transactions[i].getId() == transactionId)
+        prepared.categoryMask.assign(categoryIds.back() + 1, 0);
+        for (int categoryId : categoryIds)
         {
-            transactions.erase(transactions.begin() + i);
-            return saveAllData();
+            prepared.categoryMask[categoryId] = 1;
         }
     }
-    return false; // Transaction not found
-}
 
-Transaction *DataManager::getTransactionById(int transactionId)
-{
-    for (size_t i = 0; i < transactions.size(); i++)
+    if (!query.hasTagPredicate())
     {
-        if (transactions[i].getId() == transactionId)
+        return prepared;
+    }
+
+    // Without a required tag, excluded tags are tested per row so the other indexes can still drive the plan
+    const std::vector<std::string> &tags = query.getTags();
+    if (tags.empty())
+    {
+        for (const auto &tag : query.getExcludedTags())
         {
-            return &transactions[i];
+            const RoaringBitmap *bitmap = tagIndex.find(tag);
+            if (bitmap != nullptr)
+            {
+                prepared.excludedTags.push_back(bitmap);
+            }
         }
+        return prepared;
     }
-    return nullptr; // Transaction not found
-}
-
-std::vector<Transaction> DataManager::getAllTransactions() const
-{
-    return transactions;
-}
 
-std::vector<Transaction> DataManager::getTransactionsByCategory(int categoryId) const
-{
-    std::vector<Transaction> result;
-    for (const auto &transaction : transactions)
+    // Only the tag bitmaps are combined; row tests check the survivors' month and category
+    const RoaringBitmap *first = tagIndex.find(tags.front());
+    if (first == nullptr)
+    {
+        return prepared;
+    }
+    RoaringBitmap candidates = *first;
+    for (size_t i = 1; i < tags.size() && !candidates.empty(); i++)
     {
-        if (transaction.getCategoryId() == categoryId)
+        const RoaringBitmap *bitmap = tagIndex.find(tags[i]);
+        if (bitmap == nullptr)
         {
-            result.push_back(transaction);
+            return prepared;
         }
+        candidates.intersectWith(*bitmap);
     }
-    return result;
-}
-
-std::vector<Transaction> DataManager::getTransactionsByMonth(const std::string &monthYear) const
-{
-    std::vector<Transaction> result;
-    for (const auto &transaction : transactions)
+    for (const auto &tag : query.getExcludedTags())
     {
-        // Extract month-year from transaction date (format: YYYY-MM-DD)
-        if (transaction.getDate().substr(0, 7) == monthYear)
+        const RoaringBitmap *bitmap = tagIndex.find(tag);
+        if (bitmap != nullptr)
         {
-            result.push_back(transaction);
+            candidates.subtract(*bitmap);
         }
     }
-    return result;
+    candidates.toVector(prepared.tagIds);
+    return prepared;
 }
 
-// Budget operations
-bool DataManager::addBudget(Budget &budget)
+QueryPlan DataManager::planQuery(const PreparedQuery &prepared, std::vector<const std::vector<int> *> &lists) const
 {
-    // Check if a budget for this category and month already exists
-    for (size_t i = 0; i < budgets.size(); i++)
+    const TransactionQuery &query = *prepared.query;
+    QueryPlan plan = {QueryAccess::Scan, transactions.size()};
+    size_t bestCost = transactions.size();
+    lists.clear();
+
+    size_t estimate = 0;
+    if (!query.getTags().empty())
     {
-        if (budgets[i].getCategoryId() == budget.getCategoryId() &&
-            budgets[i].getMonthYear() == budget.getMonthYear())
-        {
-            return false; // Budget already exists
-        }
+        // The IDs already satisfy the tag predicates
+        lists.push_back(&prepared.tagIds);
+        return {QueryAccess::Tag, prepared.tagIds.size()};
     }
 
-    budgets.push_back(budget);
-    return saveAllData();
-}
+    if (!query.getPattern().empty() && textIndex.estimateCandidates(query.getPattern(), estimate) &&
+        estimate * kIndexCostFactor < bestCost)
+    {
+        plan = {QueryAccess::Text, estimate};
+        bestCost = estimate * kIndexCostFactor;
+    }
 
-bool DataManager::updateBudget(const Budget &budget)
-{
-    for (size_t i = 0; i < budgets.size(); i++)
+    if (prepared.hasDatePredicate)
     {
-        if (budgets[i].getCategoryId() == budget.getCategoryId() &&
-            budgets[i].getMonthYear() == budget.getMonthYear())
+        std::vector<const std::vector<int> *> monthLists;
+        estimate = 0;
+        if (prepared.lowMonth <= prepared.highMonth)
+        {
+            estimate += monthIndex.findRange(prepared.lowMonth, prepared.highMonth, monthLists);
+        }
+        const std::vector<int> *irregular = prepared.keepIrregular ? monthIndex.find(-1) : nullptr;
+        if (irregular != nullptr)
+        {
+            monthLists.push_back(irregular);
+            estimate += irregular->size();
+        }
+        if (estimate * kIndexCostFactor < bestCost)
         {
-            budgets[i] = budget;
-            return saveAllData();
+            plan = {QueryAccess::Month, estimate};
+            bestCost = estimate * kIndexCostFactor;
+            lists = std::move(monthLists);
         }
     }
-    return false; // Budget not found
-}
 
-bool DataManager::deleteBudget(int categoryId, const std::string &monthYear)
-{
-    for (size_t i = 0; i < budgets.size(); i++)
+    if (!query.getCategoryIds().empty())
     {
-        if (budgets[i].getCategoryId() == categoryId &&
-            budgets[i].getMonthYear() == monthYear)
+        std::vector<const std::vector<int> *> categoryLists;
+        estimate = 0;
+        for (int categoryId : query.getCategoryIds())
+        {
+            const std::vector<int> *ids = categoryIndex.find(categoryId);
+            if (ids != nullptr)
+            {
+                categoryLists.push_back(ids);
+                estimate += ids->size();
+            }
+        }
+        if (estimate * kIndexCostFactor < bestCost)
         {
-            budgets.erase(budgets.begin() + i);
-            return saveAllData();
+            plan = {QueryAccess::Category, estimate};
+            lists = std::move(categoryLists);
         }
     }
-    return false; // Budget not found
-}
 
-Budget *DataManager::getBudget(int categoryId, const std::string &monthYear)
-{
-    for (size_t i = 0; i < budgets.size(); i++)
+    if (plan.access != QueryAccess::Month && plan.access != QueryAccess::Category)
     {
-        if (budgets[i].getCategoryId() == categoryId &&
-            budgets[i].getMonthYear() == monthYear)
-        {
-            return &budgets[i];
-        }
+        lists.clear();
     }
-    return nullptr; // Budget not found
+    return plan;
 }
 
-std::vector<Budget> DataManager::getAllBudgets() const
+size_t DataManager::refineSlots(const PreparedQuery &prepared, size_t *slots, size_t count) const
 {
-    return budgets;
-}
+    const TransactionQuery &query = *prepared.query;
+    const TransactionFilter &filter = query.getDateFilter();
 
-std::vector<Budget> DataManager::getBudgetsByMonth(const std::string &monthYear) const
-{
-    std::vector<Budget> result;
-    for (const auto &budget : budgets)
+    // Every slot is written and the output advances only past those that pass,
+    // so the loops have no data-dependent branches
+    auto keep = [&](auto passes)
     {
-        if (budget.getMonthYear() == monthYear)
+        size_t kept = 0;
+        for (size_t i = 0; i < count; i++)
         {
-            result.push_back(budget);
+            size_t slot = slots[i];
+            slots[kept] = slot;
+            kept += passes(slot) ? 1 : 0;
         }
+        count = kept;
+    };
+
+    if (prepared.hasDatePredicate)
+    {
+        int low = prepared.lowMonth;
+        int high = prepared.highMonth;
+        bool keepIrregular = prepared.keepIrregular;
+        keep([&](size_t slot)
+             {
+            int month = transactionMonths[slot];
+            return ((month >= low) & (month <= high)) | ((month < 0) & keepIrregular); });
     }
-    return result;
-}
 
-// File operations
-bool DataManager::saveAllData()
-{
-    bool success = true;
+    const std::vector<int> &categoryIds = query.getCategoryIds();
+    if (!prepared.categoryMask.empty())
+    {
+        const std::vector<char> &mask = prepared.categoryMask;
+        keep([&](size_t slot)
+             {
+            auto categoryId = static_cast<size_t>(static_cast<unsigned>(transactions[slot].getCategoryId()));
+            return categoryId < mask.size() && mask[categoryId] != 0; });
+    }
+    else if (!categoryIds.empty())
+    {
+        keep([&](size_t slot)
+             { return std::binary_search(categoryIds.begin(), categoryIds.end(), transactions[slot].getCategoryId()); });
+    }
 
-    // Save transactions
-    json transactionsJson = json::array();
-    for (const auto &transaction : transactions)
+    if (query.hasMinAmount() || query.hasMaxAmount() || query.hasIncomeFlag())
     {
-        transactionsJson.push_back(transaction);
+        double low = query.hasMinAmount() ? query.getMinAmount() : -std::numeric_limits<double>::infinity();
+        double high = query.hasMaxAmount() ? query.getMaxAmount() : std::numeric_limits<double>::infinity();
+        bool anyAmount = !query.hasMinAmount() && !query.hasMaxAmount();
+        bool anyFlag = !query.hasIncomeFlag();
+        bool isIncome = query.getIsIncome();
+
+        // Bounds compare base currency amounts, which rows without a rate don't have
+        keep([&](size_t slot)
+             {
+            double amount = baseAmounts[slot];
+            bool priced = anyAmount || exchangeRates.isConvertible(transactionCurrencies[slot]);
+            return priced & (amount >= low) & (amount <= high) & (anyFlag | (transactions[slot].getIsIncome() == isIncome)); });
     }
-    success &= saveToFile(getTransactionsFilePath(), transactionsJson);
 
-    // Save categories
-    json categoriesJson = json::array();
-    for (const auto &category : categories)
+    if (!prepared.excludedTags.empty())
     {
-        categoriesJson.push_back(category);
+        keep([&](size_t slot)
+             {
+            auto id = static_cast<uint32_t>(transactions[slot].getId());
+            return std::none_of(prepared.excludedTags.begin(), prepared.excludedTags.end(), [id](const RoaringBitmap *bitmap)
+                                { return bitmap->contains(id); }); });
     }
-    success &= saveToFile(getCategoriesFilePath(), categoriesJson);
 
-    // Save budgets
-    json budgetsJson = json::array();
-    for (const auto &budget : budgets)
+    // Only rows in the boundary months, or without a month key, compare date strings
+    if (!filter.fromDate.empty() || !filter.toDate.empty() || (!filter.monthYear.empty() && prepared.bounds.monthKey < 0))
     {
-        budgetsJson.push_back(budget);
+        keep([&](size_t slot)
+             { return matchesFilter(slot, filter, prepared.bounds); });
     }
-    success &= saveToFile(getBudgetsFilePath(), budgetsJson);
 
-    return success;
+    if (!query.getPattern().empty())
+    {
+        const std::string &pattern = query.getPattern();
+        keep([&](size_t slot)
+             { return TextIndex::normalize(transactions[slot].getDescription()).find(pattern) != std::string::npos; });
+    }
+    return count;
 }
 
-bool DataManager::loadAllData()
+uint64_t DataManager::spendingKey(int categoryId, int monthKey)
 {
-    json transactionsJson, categoriesJson, budgetsJson;
-    bool anyLoaded = false;
+    return (static_cast<uint64_t>(static_cast<uint32_t>(categoryId)) << 32) | static_cast<uint32_t>(monthKey);
+}
 
-    // Load transactions
-    if (loadFromFile(getTransactionsFilePath(), transactionsJson))
+void DataManager::applySpending(const Transaction &transaction, double amount, int monthKey, bool add)
+{
+    monthKey = std::max(monthKey, -1);
+    uint64_t key = spendingKey(transaction.getCategoryId(), monthKey);
+    if (!add)
     {
-        transactions.clear();
-        nextTransactionId = 1;
-
-        for (const auto &item : transactionsJson)
+        auto entry = categorySpending.find(key);
+        if (entry == categorySpending.end())
         {
-            Transaction transaction;
-            from_json(item, transaction);
-            transactions.push_back(transaction);
+            return;
+        }
 
-            // Update next ID
-            if (transaction.getId() >= nextTransactionId)
-            {
-                nextTransactionId = transaction.getId() + 1;
-            }
+        // Totals reset to exactly zero when their last transaction leaves, so no rounding residue stays behind
+        Spending &spending = entry->second;
+        if (transaction.getIsIncome() && spending.incomeCount > 0)
+        {
+            spending.income = --spending.incomeCount == 0 ? 0.0 : spending.income - amount;
         }
-        anyLoaded = true;
+        else if (!transaction.getIsIncome() && spending.count > 0)
+        {
+            spending.amount = --spending.count == 0 ? 0.0 : spending.amount - amount;
+        }
+        if (spending.count == 0 && spending.incomeCount == 0)
+        {
+            categorySpending.erase(entry);
+        }
+        return;
     }
 
-    // Load categories
-    if (loadFromFile(getCategoriesFilePath(), categoriesJson))
+    Spending &spending = categorySpending.emplace(key, Spending{0.0, 0, 0.0, 0}).first->second;
+    if (transaction.getIsIncome())
     {
-        categories.clear();
-        nextCategoryId = 1;
-
-        for (const auto &item : categoriesJson)
-        {
-            Category category;
-            from_json(item, category);
-            categories.push_back(category);
-
-            // Update next ID
-            if (category.getId() >= nextCategoryId)
-            {
-                nextCategoryId = category.getId() + 1;
-            }
-        }
-        anyLoaded = true;
+        spending.income += amount;
+        spending.incomeCount++;
+        return;
     }
 
-    // Load budgets
-    if (loadFromFile(getBudgetsFilePath(), budgetsJson))
+    double before = spending.amount;
+    spending.amount += amount;
+    spending.count++;
+    if (budgets.empty() || monthKey < 0)
     {
-        budgets.clear();
+        return;
+    }
 
-        for (const auto &item : budgetsJson)
+    std::string monthYear = fromMonthKey(monthKey);
+    auto budget = budgetSlots.find(budgetKey(transaction.getCategoryId(), monthYear));
+    if (budget != budgetSlots.end())
+    {
+        double allocated = budgets[budget->second].getAllocatedAmount();
+        if (before <= allocated && spending.amount > allocated)
         {
-            Budget budget;
-            from_json(item, budget);
-            budgets.push_back(budget);
+            queueBudgetAlert({transaction.getCategoryId(), monthYear, allocated, spending.amount, transaction.getId()});
         }
-        anyLoaded = true;
     }
-
-    return anyLoaded;
 }
 
-// Analysis functions
-double DataManager::getTotalIncome(const std::string &monthYear) const
+void DataManager::applyTotals(size_t slot, bool add)
 {
-    double total = 0.0;
+    if (!exchangeRates.isConvertible(transactionCurrencies[slot]))
+    {
+        return;
+    }
+
+    applySpending(transactions[slot], baseAmounts[slot], transactionMonths[slot], add);
+    if (add)
+    {
+        dailyLedger.add(transactions[slot], baseAmounts[slot]);
+    }
+    else
+    {
+        dailyLedger.remove(transactions[slot], baseAmounts[slot]);
+    }
+}
+
+void DataManager::rebuildTotals()
+{
+    dailyLedger.clear();
+    categorySpending.clear();
+    for (size_t i = 0; i < transactions.size(); i++)
+    {
+        if (!exchangeRates.isConvertible(transactionCurrencies[i]))
+        {
+            continue;
+        }
+
+        dailyLedger.add(transactions[i], baseAmounts[i]);
+        Spending &spending = categorySpending.emplace(spendingKey(transactions[i].getCategoryId(), std::max(transactionMonths[i], -1)), Spending{0.0, 0, 0.0, 0}).first->second;
+        if (transactions[i].getIsIncome())
+        {
+            spending.income += baseAmounts[i];
+            spending.incomeCount++;
+        }
+        else
+        {
+            spending.amount += baseAmounts[i];
+            spending.count++;
+        }
+    }
+}
+
+void DataManager::queueBudgetAlert(const BudgetAlert &alert)
+{
+    if (budgetAlerts.size() == kMaxBudgetAlerts)
+    {
+        budgetAlerts.pop_front();
+        batchAlertCount -= batchAlertCount > 0 ? 1 : 0;
+    }
+    budgetAlerts.push_back(alert);
+}
+
+void DataManager::checkBudgetChange(const Budget &budget, double previousAllocated)
+{
+    int monthKey = toQueryMonthKey(budget.getMonthYear());
+    if (monthKey < 0)
+    {
+        return;
+    }
+
+    auto entry = categorySpending.find(spendingKey(budget.getCategoryId(), monthKey));
+    double spent = entry != categorySpending.end() ? entry->second.amount : 0.0;
+    bool wasOver = previousAllocated >= 0.0 && spent > previousAllocated;
+    if (!wasOver && spent > budget.getAllocatedAmount())
+    {
+        queueBudgetAlert({budget.getCategoryId(), budget.getMonthYear(), budget.getAllocatedAmount(), spent, -1});
+    }
+}
+
+bool DataManager::isValidParent(int categoryId, int parentId) const
+{
+    // Walking up from the parent must end at the top without meeting the category
+    for (size_t steps = 0; parentId != 0; steps++)
+    {
+        auto it = categorySlots.find(parentId);
+        if (parentId == categoryId || it == categorySlots.end() || steps > categories.size())
+        {
+            return false;
+        }
+        parentId = categories[it->second].getParentId();
+    }
+    return true;
+}
+
+template <typename Partial, typename Fold>
+std::vector<Partial> DataManager::collectMatches(const PreparedQuery &prepared, const QueryPlan &plan,
+                                                 const std::vector<const std::vector<int> *> &lists, Fold fold) const
+{
+    if (plan.access == QueryAccess::Scan)
+    {
+        return scanInChunks<Partial>(transactions.size(), [&](Partial &partial, size_t begin, size_t end)
+                                     {
+            size_t slots[kQueryBlockSize];
+            for (size_t block = begin; block < end; block += kQueryBlockSize)
+            {
+                size_t count = std::min(kQueryBlockSize, end - block);
+                for (size_t i = 0; i < count; i++)
+                {
+                    slots[i] = block + i;
+                }
+                fold(partial, slots, refineSlots(prepared, slots, count));
+            } });
+    }
+
+    std::vector<Partial> partials(1);
+    size_t slots[kQueryBlockSize];
+    size_t count = 0;
+    auto flush = [&]()
+    {
+        fold(partials[0], slots, refineSlots(prepared, slots, count));
+        count = 0;
+    };
+    auto add = [&](int id)
+    {
+        slots[count++] = transactionSlots.at(id);
+        if (count == kQueryBlockSize)
+        {
+            flush();
+        }
+        return true;
+    };
+
+    if (plan.access == QueryAccess::Text)
+    {
+        textIndex.visitCandidates(prepared.query->getPattern(), add);
+    }
+    else
+    {
+        for (const auto *ids : lists)
+        {
+            for (int id : *ids)
+            {
+                add(id);
+            }
+        }
+    }
+    flush();
+    return partials;
+}
+
+void DataManager::rebuildIndexes()
+{
+    transactionSlots.clear();
+    transactionSlots.reserve(transactions.size());
+    transactionMonths.resize(transactions.size());
+    transactionCurrencies.resize(transactions.size());
+    for (size_t i = 0; i < transactions.size(); i++)
+    {
+        transactionSlots[transactions[i].getId()] = i;
+        transactionMonths[i] = toMonthKey(transactions[i].getDate());
+        transactionCurrencies[i] = exchangeRates.intern(transactions[i].getCurrency());
+    }
+    convertAllAmounts();
+
+    // Fingerprinting normalizes every description, so it runs in parallel
+    std::vector<uint64_t> fingerprints(transactions.size());
+    ThreadPool::shared().parallelFor(transactions.size(), kScanGrainSize, [&](size_t, size_t begin, size_t end)
+                                     {
+        for (size_t i = begin; i < end; i++)
+        {
+            fingerprints[i] = DuplicateIndex::fingerprint(transactions[i]);
+        } });
+
+    duplicateIndex.reset(transactions.size());
+    for (size_t i = 0; i < transactions.size(); i++)
+    {
+        duplicateIndex.add(fingerprints[i], transactions[i].getId());
+    }
+
+    // Adding in ID order lets every posting list grow by appending
+    std::vector<std::pair<int, size_t>> idOrder;
+    idOrder.reserve(transactions.size());
+    for (size_t i = 0; i < transactions.size(); i++)
+    {
+        idOrder.emplace_back(transactions[i].getId(), i);
+    }
+    std::sort(idOrder.begin(), idOrder.end());
+    textIndex.clear();
+    monthIndex.clear();
+    categoryIndex.clear();
+    tagIndex.clear();
+    for (const auto &entry : idOrder)
+    {
+        textIndex.add(entry.first, transactions[entry.second].getDescription());
+        monthIndex.add(transactionMonths[entry.second], entry.first);
+        categoryIndex.add(transactions[entry.second].getCategoryId(), entry.first);
+        tagIndex.add(entry.first, transactions[entry.second].getTags());
+    }
+    suggestionIndex.rebuild(transactions, categories);
+
+    categorySlots.clear();
+    for (size_t i = 0; i < categories.size(); i++)
+    {
+        categorySlots[categories[i].getId()] = i;
+    }
+
+    budgetSlots.clear();
+    for (size_t i = 0; i < budgets.size(); i++)
+    {
+        budgetSlots[budgetKey(budgets[i].getCategoryId(), budgets[i].getMonthYear())] = i;
+    }
+}
+
+void DataManager::insertTransactionRecord(const Transaction &transaction)
+{
+    insertTransactionRecord(transaction, DuplicateIndex::fingerprint(transaction));
+}
+
+void DataManager::insertTransactionRecord(const Transaction &transaction, uint64_t fingerprint)
+{
+    if (batchActive)
+    {
+        undoLog.push_back({UndoRecord::Op::InsertTransaction, transaction, Category(), Budget()});
+    }
+
+    changeLog.record(ChangeCollection::Transactions, ChangeType::Inserted, {transaction.getId(), ""});
+    transactionSlots[transaction.getId()] = transactions.size();
+    transactions.push_back(transaction);
+    transactionMonths.push_back(toMonthKey(transaction.getDate()));
+    transactionCurrencies.push_back(exchangeRates.intern(transaction.getCurrency()));
+    baseAmounts.push_back(toBaseAmount(transactions.size() - 1));
+    duplicateIndex.add(fingerprint, transaction.getId());
+    textIndex.add(transaction.getId(), transaction.getDescription());
+    suggestionIndex.addTransaction(transaction);
+    monthIndex.add(transactionMonths.back(), transaction.getId());
+    categoryIndex.add(transaction.getCategoryId(), transaction.getId());
+    tagIndex.add(transaction.getId(), transaction.getTags());
+    applyTotals(transactions.size() - 1, true);
+    transactionsDirty = true;
+}
+
+void DataManager::replaceTransactionAt(size_t slot, const Transaction &transaction)
+{
+    if (batchActive)
+    {
+        undoLog.push_back({UndoRecord::Op::UpdateTransaction, transactions[slot], Category(), Budget()});
+    }
+
+    changeLog.record(ChangeCollection::Transactions, ChangeType::Updated, {transaction.getId(), ""});
+    duplicateIndex.remove(DuplicateIndex::fingerprint(transactions[slot]), transactions[slot].getId());
+    duplicateIndex.add(DuplicateIndex::fingerprint(transaction), transaction.getId());
+    if (transactions[slot].getDescription() != transaction.getDescription())
+    {
+        textIndex.remove(transactions[slot].getId(), transactions[slot].getDescription());
+        textIndex.add(transaction.getId(), transaction.getDescription());
+    }
+    if (transactions[slot].getDescription() != transaction.getDescription() ||
+        transactions[slot].getDate() != transaction.getDate() ||
+        transactions[slot].getCategoryId() != transaction.getCategoryId())
+    {
+        suggestionIndex.removeTransaction(transactions[slot]);
+        suggestionIndex.addTransaction(transaction);
+    }
+    int monthKey = toMonthKey(transaction.getDate());
+    bool totalsChange = transactions[slot].getDate() != transaction.getDate() ||
+                        transactions[slot].getAmount() != transaction.getAmount() ||
+                        transactions[slot].getCurrency() != transaction.getCurrency() ||
+                        transactions[slot].getIsIncome() != transaction.getIsIncome() ||
+                        transactions[slot].getCategoryId() != transaction.getCategoryId();
+    if (totalsChange)
+    {
+        applyTotals(slot, false);
+    }
+    if (transactionMonths[slot] != monthKey)
+    {
+        monthIndex.remove(transactionMonths[slot], transaction.getId());
+        monthIndex.add(monthKey, transaction.getId());
+    }
+    if (transactions[slot].getCategoryId() != transaction.getCategoryId())
+    {
+        categoryIndex.remove(transactions[slot].getCategoryId(), transaction.getId());
+        categoryIndex.add(transaction.getCategoryId(), transaction.getId());
+    }
+    if (transactions[slot].getTags() != transaction.getTags())
+    {
+        tagIndex.remove(transactions[slot].getId(), transactions[slot].getTags());
+        tagIndex.add(transaction.getId(), transaction.getTags());
+    }
+    transactions[slot] = transaction;
+    transactionMonths[slot] = monthKey;
+    transactionCurrencies[slot] = exchangeRates.intern(transaction.getCurrency());
+    baseAmounts[slot] = toBaseAmount(slot);
+    if (totalsChange)
+    {
+        applyTotals(slot, true);
+    }
+    transactionsDirty = true;
+}
+
+void DataManager::removeTransactionAt(size_t slot)
+{
+    if (batchActive)
+    {
+        undoLog.push_back({UndoRecord::Op::DeleteTransaction, transactions[slot], Category(), Budget()});
+    }
+
+    changeLog.record(ChangeCollection::Transactions, ChangeType::Deleted, {transactions[slot].getId(), ""});
+
+    // Move the last record into the freed slot so deletes don't shift the whole vector
+    duplicateIndex.remove(DuplicateIndex::fingerprint(transactions[slot]), transactions[slot].getId());
+    textIndex.remove(transactions[slot].getId(), transactions[slot].getDescription());
+    suggestionIndex.removeTransaction(transactions[slot]);
+    monthIndex.remove(transactionMonths[slot], transactions[slot].getId());
+    categoryIndex.remove(transactions[slot].getCategoryId(), transactions[slot].getId());
+    tagIndex.remove(transactions[slot].getId(), transactions[slot].getTags());
+    applyTotals(slot, false);
+    transactionSlots.erase(transactions[slot].getId());
+    size_t last = transactions.size() - 1;
+    if (slot != last)
+    {
+        transactions[slot] = std::move(transactions[last]);
+        transactionMonths[slot] = transactionMonths[last];
+        transactionCurrencies[slot] = transactionCurrencies[last];
+        baseAmounts[slot] = baseAmounts[last];
+        transactionSlots[transactions[slot].getId()] = slot;
+    }
+    transactions.pop_back();
+    transactionMonths.pop_back();
+    transactionCurrencies.pop_back();
+    baseAmounts.pop_back();
+    transactionsDirty = true;
+}
+
+void DataManager::insertCategoryRecord(const Category &category)
+{
+    if (batchActive)
+    {
+        undoLog.push_back({UndoRecord::Op::InsertCategory, Transaction(), category, Budget()});
+    }
+
+    changeLog.record(ChangeCollection::Categories, ChangeType::Inserted, {category.getId(), ""});
+    categorySlots[category.getId()] = categories.size();
+    categories.push_back(category);
+    suggestionIndex.addCategory(category);
+    categoriesDirty = true;
+}
+
+void DataManager::replaceCategoryAt(size_t slot, const Category &category)
+{
+    if (batchActive)
+    {
+        undoLog.push_back({UndoRecord::Op::UpdateCategory, Transaction(), categories[slot], Budget()});
+    }
+
+    changeLog.record(ChangeCollection::Categories, ChangeType::Updated, {category.getId(), ""});
+    if (categories[slot].getName() != category.getName())
+    {
+        suggestionIndex.updateCategory(category);
+    }
+    categories[slot] = category;
+    categoriesDirty = true;
+}
+
+void DataManager::removeCategoryAt(size_t slot)
+{
+    if (batchActive)
+    {
+        undoLog.push_back({UndoRecord::Op::DeleteCategory, Transaction(), categories[slot], Budget()});
+    }
+
+    changeLog.record(ChangeCollection::Categories, ChangeType::Deleted, {categories[slot].getId(), ""});
+    categorySlots.erase(categories[slot].getId());
+    suggestionIndex.removeCategory(categories[slot].getId());
+    categories.erase(categories.begin() + slot);
+    for (size_t i = slot; i < categories.size(); i++)
+    {
+        categorySlots[categories[i].getId()] = i;
+    }
+    categoriesDirty = true;
+}
+
+void DataManager::insertBudgetRecord(const Budget &budget)
+{
+    if (batchActive)
+    {
+        undoLog.push_back({UndoRecord::Op::InsertBudget, Transaction(), Category(), budget});
+    }
+
+    changeLog.record(ChangeCollection::Budgets, ChangeType::Inserted, {budget.getCategoryId(), budget.getMonthYear()});
+    budgetSlots[budgetKey(budget.getCategoryId(), budget.getMonthYear())] = budgets.size();
+    budgets.push_back(budget);
+    checkBudgetChange(budget, -1.0);
+    budgetsDirty = true;
+}
+
+void DataManager::replaceBudgetAt(size_t slot, const Budget &budget)
+{
+    if (batchActive)
+    {
+        undoLog.push_back({UndoRecord::Op::UpdateBudget, Transaction(), Category(), budgets[slot]});
+    }
+
+    changeLog.record(ChangeCollection::Budgets, ChangeType::Updated, {budget.getCategoryId(), budget.getMonthYear()});
+    checkBudgetChange(budget, budgets[slot].getAllocatedAmount());
+    budgets[slot] = budget;
+    budgetsDirty = true;
+}
+
+void DataManager::removeBudgetAt(size_t slot)
+{
+    if (batchActive)
+    {
+        undoLog.push_back({UndoRecord::Op::DeleteBudget, Transaction(), Category(), budgets[slot]});
+    }
+
+    changeLog.record(ChangeCollection::Budgets, ChangeType::Deleted, {budgets[slot].getCategoryId(), budgets[slot].getMonthYear()});
+    budgetSlots.erase(budgetKey(budgets[slot].getCategoryId(), budgets[slot].getMonthYear()));
+    budgets.erase(budgets.begin() + slot);
+    for (size_t i = slot; i < budgets.size(); i++)
+    {
+        budgetSlots[budgetKey(budgets[i].getCategoryId(), budgets[i].getMonthYear())] = i;
+    }
+    budgetsDirty = true;
+}
+
+void DataManager::applyUndoLog()
+{
+    // Replaying must not record new undo steps
+    batchActive = false;
+
+    for (auto it = undoLog.rbegin(); it != undoLog.rend(); ++it)
+    {
+        switch (it->op)
+        {
+        case UndoRecord::Op::InsertTransaction:
+            removeTransactionAt(transactionSlots.at(it->transaction.getId()));
+            break;
+        case UndoRecord::Op::UpdateTransaction:
+            replaceTransactionAt(transactionSlots.at(it->transaction.getId()), it->transaction);
+            break;
+        case UndoRecord::Op::DeleteTransaction:
+            insertTransactionRecord(it->transaction);
+            break;
+        case UndoRecord::Op::InsertCategory:
+            removeCategoryAt(categorySlots.at(it->category.getId()));
+            break;
+        case UndoRecord::Op::UpdateCategory:
+            replaceCategoryAt(categorySlots.at(it->category.getId()), it->category);
+            break;
+        case UndoRecord::Op::DeleteCategory:
+            insertCategoryRecord(it->category);
+            break;
+        case UndoRecord::Op::InsertBudget:
+            removeBudgetAt(budgetSlots.at(budgetKey(it->budget.getCategoryId(), it->budget.getMonthYear())));
+            break;
+        case UndoRecord::Op::UpdateBudget:
+            replaceBudgetAt(budgetSlots.at(budgetKey(it->budget.getCategoryId(), it->budget.getMonthYear())), it->budget);
+            break;
+        case UndoRecord::Op::DeleteBudget:
+            insertBudgetRecord(it->budget);
+            break;
+        }
+    }
+
+    undoLog.clear();
+    nextTransactionId = batchNextTransactionId;
+    nextCategoryId = batchNextCategoryId;
+
+    // Alerts raised inside the batch, or by replaying it, describe changes that never happened
+    if (budgetAlerts.size() > batchAlertCount)
+    {
+        budgetAlerts.resize(batchAlertCount);
+    }
+}
+
+bool DataManager::openBatch()
+{
+    if (batchActive)
+    {
+        return false; // Batches don't nest
+    }
+
+    batchActive = true;
+    batchOwner = std::this_thread::get_id();
+    undoLog.clear();
+    batchNextTransactionId = nextTransactionId;
+    batchNextCategoryId = nextCategoryId;
+    batchAlertCount = budgetAlerts.size();
+    return true;
+}
+
+bool DataManager::closeBatch(bool commit)
+{
+    if (!commit)
+    {
+        applyUndoLog();
+        return true;
+    }
+
+    batchActive = false;
+    if (persist())
+    {
+        undoLog.clear();
+        return true;
+    }
+
+    // Keep memory consistent with what is on disk
+    std::cerr << "Failed to save batch, rolling back" << std::endl;
+    applyUndoLog();
+    persist();
+    return false;
+}
+
+bool DataManager::isBatchWriter() const
+{
+    if (!batchActive || batchOwner == std::this_thread::get_id())
+    {
+        return true;
+    }
+    std::cerr << "A batch opened by another thread is in progress" << std::endl;
+    return false;
+}
+
+bool DataManager::persistShared()
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::lock_guard<std::mutex> saveLock(saveMutex);
+    return persist();
+}
+
+bool DataManager::persistRates()
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::lock_guard<std::mutex> saveLock(saveMutex);
+    return saveRates();
+}
+
+bool DataManager::persist()
+{
+    Metrics::Timer timer(metrics, MetricOperation::Persist);
+    if (batchActive)
+    {
+        return true; // Written once when the batch is committed
+    }
+
+    bool success = true;
+    if (transactionsDirty)
+    {
+        success &= saveTransactions();
+    }
+    if (categoriesDirty)
+    {
+        success &= saveCategories();
+    }
+    if (budgetsDirty)
+    {
+        success &= saveBudgets();
+    }
+    if (ratesDirty)
+    {
+        success &= saveRates();
+    }
+    return success;
+}
+
+// Category operations
+bool DataManager::addCategory(Category &category)
+{
+    Metrics::Timer timer(metrics, MetricOperation::AddCategory);
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (!isBatchWriter())
+        {
+            return false;
+        }
+
+        // Assign a new ID if the category doesn't have one
+        if (category.getId() == 0)
+        {
+            category.setId(nextCategoryId++);
+        }
+
+        // Check if a category with this ID already exists
+        if (categorySlots.count(category.getId()) != 0)
+        {
+            return false; // Category ID already exists
+        }
+        if (!isValidParent(category.getId(), category.getParentId()))
+        {
+            std::cerr << "Invalid parent category " << category.getParentId() << " for category " << category.getId() << std::endl;
+            return false;
+        }
+
+        insertCategoryRecord(category);
+    }
+    return persistShared();
+}
+
+bool DataManager::updateCategory(const Category &category)
+{
+    Metrics::Timer timer(metrics, MetricOperation::UpdateCategory);
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (!isBatchWriter())
+        {
+            return false;
+        }
+
+        auto it = categorySlots.find(category.getId());
+        if (it == categorySlots.end())
+        {
+            return false; // Category not found
+        }
+
+        Category updated = category;
+        updated.setParentId(categories[it->second].getParentId());
+        replaceCategoryAt(it->second, updated);
+    }
+    return persistShared();
+}
+
+bool DataManager::setCategoryParent(int categoryId, int parentId)
+{
+    Metrics::Timer timer(metrics, MetricOperation::UpdateCategory);
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (!isBatchWriter())
+        {
+            return false;
+        }
+
+        auto it = categorySlots.find(categoryId);
+        if (it == categorySlots.end())
+        {
+            return false; // Category not found
+        }
+        if (!isValidParent(categoryId, parentId))
+        {
+            std::cerr << "Invalid parent category " << parentId << " for category " << categoryId << std::endl;
+            return false;
+        }
+
+        Category category = categories[it->second];
+        category.setParentId(parentId);
+        replaceCategoryAt(it->second, category);
+    }
+    return persistShared();
+}
+
+bool DataManager::deleteCategory(int categoryId)
+{
+    Metrics::Timer timer(metrics, MetricOperation::DeleteCategory);
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (!isBatchWriter())
+        {
+            return false;
+        }
+
+        auto it = categorySlots.find(categoryId);
+        if (it == categorySlots.end())
+        {
+            return false; // Category not found
+        }
+
+        // Children move up to the deleted category's parent
+        int parentId = categories[it->second].getParentId();
+        for (size_t i = 0; i < categories.size(); i++)
+        {
+            if (categories[i].getParentId() == categoryId)
+            {
+                Category child = categories[i];
+                child.setParentId(parentId);
+                replaceCategoryAt(i, child);
+            }
+        }
+        removeCategoryAt(categorySlots.at(categoryId));
+    }
+    return persistShared();
+}
+
+Category *DataManager::getCategoryById(int categoryId)
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = categorySlots.find(categoryId);
+    if (it == categorySlots.end())
+    {
+        return nullptr; // Category not found
+    }
+    return &categories[it->second];
+}
+
+std::vector<Category> DataManager::getAllCategories() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return categories;
+}
+
+// Transaction operations
+bool DataManager::addTransaction(Transaction &transaction)
+{
+    Metrics::Timer timer(metrics, MetricOperation::AddTransaction);
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (!isBatchWriter())
+        {
+            return false;
+        }
+
+        // Assign a new ID if the transaction doesn't have one
+        if (transaction.getId() == 0)
+        {
+            transaction.setId(nextTransactionId++);
+        }
+
+        // Check if a transaction with this ID already exists
+        if (transactionSlots.count(transaction.getId()) != 0)
+        {
+            return false; // Transaction ID already exists
+        }
+
+        insertTransactionRecord(transaction);
+        if (transaction.getId() >= nextTransactionId)
+        {
+            nextTransactionId = transaction.getId() + 1;
+        }
+    }
+    return persistShared();
+}
+
+bool DataManager::updateTransaction(const Transaction &transaction, bool keepTagsAndCurrency)
+{
+    Metrics::Timer timer(metrics, MetricOperation::UpdateTransaction);
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (!isBatchWriter())
+        {
+            return false;
+        }
+
+        auto it = transactionSlots.find(transaction.getId());
+        if (it == transactionSlots.end())
+        {
+            return false; // Transaction not found
+        }
+
+        if (keepTagsAndCurrency)
+        {
+            replaceTransactionAt(it->second, withStoredTagsAndCurrency(transaction, transactions[it->second]));
+        }
+        else
+        {
+            replaceTransactionAt(it->second, transaction);
+        }
+    }
+    return persistShared();
+}
+
+bool DataManager::deleteTransaction(int transactionId)
+{
+    Metrics::Timer timer(metrics, MetricOperation::DeleteTransaction);
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (!isBatchWriter())
+        {
+            return false;
+        }
+
+        auto it = transactionSlots.find(transactionId);
+        if (it == transactionSlots.end())
+        {
+            return false; // Transaction not found
+        }
+
+        removeTransactionAt(it->second);
+    }
+    return persistShared();
+}
+
+Transaction *DataManager::getTransactionById(int transactionId)
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = transactionSlots.find(transactionId);
+    if (it == transactionSlots.end())
+    {
+        return nullptr; // Transaction not found
+    }
+    return &transactions[it->second];
+}
+
+bool DataManager::setTransactionTags(int transactionId, const std::vector<std::string> &tags)
+{
+    Metrics::Timer timer(metrics, MetricOperation::UpdateTransaction);
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (!isBatchWriter())
+        {
+            return false;
+        }
+
+        auto it = transactionSlots.find(transactionId);
+        if (it == transactionSlots.end())
+        {
+            return false; // Transaction not found
+        }
+
+        Transaction transaction = transactions[it->second];
+        transaction.setTags(tags);
+        replaceTransactionAt(it->second, transaction);
+    }
+    return persistShared();
+}
+
+bool DataManager::setTransactionCurrency(int transactionId, const std::string &currency)
+{
+    Metrics::Timer timer(metrics, MetricOperation::UpdateTransaction);
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (!isBatchWriter())
+        {
+            return false;
+        }
+
+        auto it = transactionSlots.find(transactionId);
+        if (it == transactionSlots.end())
+        {
+            return false; // Transaction not found
+        }
+
+        Transaction transaction = transactions[it->second];
+        transaction.setCurrency(currency);
+        replaceTransactionAt(it->second, transaction);
+    }
+    return persistShared();
+}
+
+std::vector<std::pair<std::string, size_t>> DataManager::getTagCounts() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::vector<std::pair<std::string, size_t>> counts;
+    tagIndex.getTagCounts(counts);
+    return counts;
+}
+
+std::vector<Transaction> DataManager::getAllTransactions() const
+{
+    Metrics::Timer timer(metrics, MetricOperation::GetAllTransactions);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    metrics.add(MetricCounter::RowsReturned, transactions.size());
+    return transactions;
+}
+
+std::vector<Transaction> DataManager::getTransactionsByCategory(int categoryId) const
+{
+    Metrics::Timer timer(metrics, MetricOperation::GetTransactionsByCategory);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    metrics.add(MetricCounter::RowsScanned, transactions.size());
+    timer.trace().addArg("rows", transactions.size());
+
+    auto partials = scanInChunks<std::vector<Transaction>>(transactions.size(), [&](std::vector<Transaction> &matches, size_t begin, size_t end)
+                                                           {
+        for (size_t i = begin; i < end; i++)
+        {
+            if (transactions[i].getCategoryId() == categoryId)
+            {
+                matches.push_back(transactions[i]);
+            }
+        } });
+
+    std::vector<Transaction> result = concatenate(partials);
+    metrics.add(MetricCounter::RowsReturned, result.size());
+    timer.trace().addArg("returned", result.size());
+    return result;
+}
+
+std::vector<Transaction> DataManager::getTransactionsByMonth(const std::string &monthYear) const
+{
+    Metrics::Timer timer(metrics, MetricOperation::GetTransactionsByMonth);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    metrics.add(MetricCounter::RowsScanned, transactions.size());
+    timer.trace().addArg("rows", transactions.size());
+    int monthKey = toQueryMonthKey(monthYear);
+
+    auto partials = scanInChunks<std::vector<Transaction>>(transactions.size(), [&](std::vector<Transaction> &matches, size_t begin, size_t end)
+                                                           {
+        for (size_t i = begin; i < end; i++)
+        {
+            if (matchesMonth(i, monthKey, monthYear))
+            {
+                matches.push_back(transactions[i]);
+            }
+        } });
+
+    std::vector<Transaction> result = concatenate(partials);
+    metrics.add(MetricCounter::RowsReturned, result.size());
+    timer.trace().addArg("returned", result.size());
+    return result;
+}
+
+// Batch operations
+bool DataManager::addTransactionsBatch(std::vector<Transaction> &newTransactions)
+{
+    std::vector<DuplicateMatch> duplicates;
+    return addTransactionsBatch(newTransactions, DuplicatePolicy::Allow, duplicates);
+}
+
+bool DataManager::addTransactionsBatch(std::vector<Transaction> &newTransactions, DuplicatePolicy policy,
+                                       std::vector<DuplicateMatch> &duplicates)
+{
+    Metrics::Timer timer(metrics, MetricOperation::TransactionsBatch);
+    duplicates.clear();
+
+    // Fingerprints only depend on the submitted rows, so compute them before locking
+    std::vector<uint64_t> fingerprints(newTransactions.size());
+    ThreadPool::shared().parallelFor(newTransactions.size(), kScanGrainSize, [&](size_t, size_t begin, size_t end)
+                                     {
+        for (size_t i = begin; i < end; i++)
+        {
+            fingerprints[i] = DuplicateIndex::fingerprint(newTransactions[i]);
+        } });
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (!isBatchWriter())
+    {
+        return false;
+    }
+
+    // Validate the whole batch before touching any state
+    int nextId = nextTransactionId;
+    std::unordered_set<int> batchIds;
+    batchIds.reserve(newTransactions.size());
+    for (size_t i = 0; i < newTransactions.size(); i++)
+    {
+        int id = newTransactions[i].getId();
+        if (id == 0)
+        {
+            continue;
+        }
+        if (transactionSlots.count(id) != 0 || !batchIds.insert(id).second)
+        {
+            return false; // Transaction ID already exists
+        }
+        if (id >= nextId)
+        {
+            nextId = id + 1;
+        }
+    }
+
+    bool ownsBatch = openBatch();
+    transactionSlots.reserve(transactions.size() + newTransactions.size());
+    transactions.reserve(transactions.size() + newTransactions.size());
+    transactionMonths.reserve(transactions.size() + newTransactions.size());
+    transactionCurrencies.reserve(transactions.size() + newTransactions.size());
+    baseAmounts.reserve(transactions.size() + newTransactions.size());
+
+    for (size_t i = 0; i < newTransactions.size(); i++)
+    {
+        Transaction &transaction = newTransactions[i];
+        if (policy != DuplicatePolicy::Allow)
+        {
+            // Rows inserted earlier in this batch are already indexed, so repeats within the batch are caught too
+            int existingId = duplicateIndex.find(fingerprints[i]);
+            if (existingId != 0)
+            {
+                duplicates.push_back({i, existingId, transaction});
+                if (policy == DuplicatePolicy::Skip)
+                {
+                    continue;
+                }
+            }
+        }
+
+        if (transaction.getId() == 0)
+        {
+            transaction.setId(nextId++);
+        }
+        insertTransactionRecord(transaction, fingerprints[i]);
+    }
+    nextTransactionId = nextId;
+    timer.trace().addArg("rows", newTransactions.size());
+    timer.trace().addArg("duplicates", duplicates.size());
+
+    return ownsBatch ? closeBatch(true) : true;
+}
+
+bool DataManager::updateTransactionsBatch(const std::vector<Transaction> &transactions, bool keepTagsAndCurrency)
+{
+    Metrics::Timer timer(metrics, MetricOperation::TransactionsBatch);
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (!isBatchWriter())
+    {
+        return false;
+    }
+
+    for (const auto &transaction : transactions)
+    {
+        if (transactionSlots.count(transaction.getId()) == 0)
+        {
+            return false; // Transaction not found
+        }
+    }
+
+    bool ownsBatch = openBatch();
+    for (const auto &transaction : transactions)
+    {
+        size_t slot = transactionSlots[transaction.getId()];
+        if (keepTagsAndCurrency)
+        {
+            replaceTransactionAt(slot, withStoredTagsAndCurrency(transaction, this->transactions[slot]));
+        }
+        else
+        {
+            replaceTransactionAt(slot, transaction);
+        }
+    }
+
+    return ownsBatch ? closeBatch(true) : true;
+}
+
+bool DataManager::deleteTransactionsBatch(const std::vector<int> &transactionIds)
+{
+    Metrics::Timer timer(metrics, MetricOperation::TransactionsBatch);
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (!isBatchWriter())
+    {
+        return false;
+    }
+
+    std::unordered_set<int> seen;
+    seen.reserve(transactionIds.size());
+    for (int id : transactionIds)
+    {
+        if (transactionSlots.count(id) == 0 || !seen.insert(id).second)
+        {
+            return false; // Transaction not found or listed twice
+        }
+    }
+
+    bool ownsBatch = openBatch();
+    for (int id : transactionIds)
+    {
+        removeTransactionAt(transactionSlots[id]);
+    }
+
+    return ownsBatch ? closeBatch(true) : true;
+}
+
+bool DataManager::importFile(const std::string &filePath, ImportFormat format, ImportResult &result,
+                             DuplicatePolicy policy, DateOrder dateOrder)
+{
+    Metrics::Timer timer(metrics, MetricOperation::ImportFile);
+    timer.trace().addArg("file", filePath);
+
+    StatementImporter importer(getAllCategories(), dateOrder);
+    if (!importer.parseFile(filePath, format, result))
+    {
+        std::cerr << "Failed to open import file: " << filePath << std::endl;
+        return false;
+    }
+
+    timer.trace().addArg("rows", result.transactions.size());
+    timer.trace().addArg("errors", result.errors.size());
+    return result.transactions.empty() || addTransactionsBatch(result.transactions, policy, result.duplicates);
+}
+
+bool DataManager::exportTransactions(const std::string &filePath, ExportFormat format, const TransactionFilter &filter,
+                                     size_t &rowsWritten) const
+{
+    Metrics::Timer timer(metrics, MetricOperation::ExportTransactions);
+    timer.trace().addArg("file", filePath);
+    rowsWritten = 0;
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    TransactionExporter exporter(format, categories);
+    if (!exporter.open(filePath))
+    {
+        return false;
+    }
+
+    FilterBounds bounds = toFilterBounds(filter);
+    for (size_t i = 0; i < transactions.size(); i++)
+    {
+        if (matchesFilter(i, filter, bounds))
+        {
+            exporter.write(transactions[i]);
+        }
+    }
+
+    bool success = exporter.close();
+    rowsWritten = success ? exporter.getRowCount() : 0;
+    metrics.add(MetricCounter::RowsScanned, transactions.size());
+    metrics.add(MetricCounter::RowsReturned, rowsWritten);
+    metrics.add(MetricCounter::BytesWritten, exporter.getBytesWritten());
+    timer.trace().addArg("rows", rowsWritten);
+    timer.trace().addArg("bytes", exporter.getBytesWritten());
+    return success;
+}
+
+bool DataManager::beginBatch()
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    return openBatch();
+}
+
+bool DataManager::commitBatch()
+{
+    Metrics::Timer timer(metrics, MetricOperation::CommitBatch);
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    return batchActive && isBatchWriter() && closeBatch(true);
+}
+
+bool DataManager::rollbackBatch()
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    return batchActive && isBatchWriter() && closeBatch(false);
+}
+
+bool DataManager::isBatchActive() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return batchActive;
+}
+
+// Change tracking
+unsigned long long DataManager::getDataVersion() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return changeLog.getVersion();
+}
+
+ChangeSet DataManager::getChangesSince(unsigned long long sinceVersion) const
+{
+    Metrics::Timer timer(metrics, MetricOperation::GetChangesSince);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+
+    ChangeSet changes;
+    changes.version = changeLog.getVersion();
+    changes.fullResync = !changeLog.covers(sinceVersion);
+
+    if (changes.fullResync)
+    {
+        changes.insertedTransactions = transactions;
+        changes.insertedCategories = categories;
+        changes.insertedBudgets = budgets;
+        return changes;
+    }
+
+    std::vector<ChangeKey> inserted, updated, deleted;
+    changeLog.collect(sinceVersion, ChangeCollection::Transactions, inserted, updated, deleted);
+    for (const auto &key : inserted)
+    {
+        changes.insertedTransactions.push_back(transactions[transactionSlots.at(key.id)]);
+    }
+    for (const auto &key : updated)
+    {
+        changes.updatedTransactions.push_back(transactions[transactionSlots.at(key.id)]);
+    }
+    for (const auto &key : deleted)
+    {
+        changes.deletedTransactionIds.push_back(key.id);
+    }
+
+    inserted.clear();
+    updated.clear();
+    deleted.clear();
+    changeLog.collect(sinceVersion, ChangeCollection::Categories, inserted, updated, deleted);
+    for (const auto &key : inserted)
+    {
+        changes.insertedCategories.push_back(categories[categorySlots.at(key.id)]);
+    }
+    for (const auto &key : updated)
+    {
+        changes.updatedCategories.push_back(categories[categorySlots.at(key.id)]);
+    }
+    for (const auto &key : deleted)
+    {
+        changes.deletedCategoryIds.push_back(key.id);
+    }
+
+    inserted.clear();
+    updated.clear();
+    deleted.clear();
+    changeLog.collect(sinceVersion, ChangeCollection::Budgets, inserted, updated, deleted);
+    for (const auto &key : inserted)
+    {
+        changes.insertedBudgets.push_back(budgets[budgetSlots.at(budgetKey(key.id, key.monthYear))]);
+    }
+    for (const auto &key : updated)
+    {
+        changes.updatedBudgets.push_back(budgets[budgetSlots.at(budgetKey(key.id, key.monthYear))]);
+    }
+    for (const auto &key : deleted)
+    {
+        changes.deletedBudgets.emplace_back(key.id, key.monthYear, 0.0);
+    }
+
+    return changes;
+}
+
+Metrics &DataManager::getMetrics() const
+{
+    return metrics;
+}
+
+std::vector<std::vector<int>> DataManager::findDuplicateTransactions() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return duplicateIndex.findGroups();
+}
+
+std::vector<Transaction> DataManager::searchTransactions(const std::string &query, bool prefix,
+                                                     const TransactionFilter &filter, size_t limit) const
+{
+    Metrics::Timer timer(metrics, MetricOperation::SearchTransactions);
+    timer.trace().addArg("query", query);
+
+    // A leading space anchors the pattern to the start of a word
+    std::string pattern = TextIndex::normalize(query);
+    if (!prefix && !pattern.empty())
+    {
+        pattern.erase(0, 1);
+    }
+    if (pattern.empty())
+    {
+        return {};
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    FilterBounds bounds = toFilterBounds(filter);
+    auto matches = [&](size_t slot)
+    {
+        return matchesFilter(slot, filter, bounds) &&
+               TextIndex::normalize(transactions[slot].getDescription()).find(pattern) != std::string::npos;
+    };
+
+    std::vector<Transaction> result;
+    size_t checked = 0;
+    bool indexed = textIndex.visitCandidates(pattern, [&](int id)
+                                             {
+        size_t slot = transactionSlots.at(id);
+        checked++;
+        if (matches(slot))
+        {
+            result.push_back(transactions[slot]);
+        }
+        return limit == 0 || result.size() < limit; });
+
+    if (indexed)
+    {
+        metrics.add(MetricCounter::RowsScanned, checked);
+        timer.trace().addArg("candidates", checked);
+    }
+    else
+    {
+        metrics.add(MetricCounter::RowsScanned, transactions.size());
+        auto partials = scanInChunks<std::vector<Transaction>>(transactions.size(), [&](std::vector<Transaction> &found, size_t begin, size_t end)
+                                                               {
+            for (size_t i = begin; i < end; i++)
+            {
+                if (matches(i))
+                {
+                    found.push_back(transactions[i]);
+                }
+            } });
+        result = concatenate(partials);
+        std::sort(result.begin(), result.end(), [](const Transaction &a, const Transaction &b)
+                  { return a.getId() > b.getId(); });
+        if (limit != 0 && result.size() > limit)
+        {
+            result.resize(limit);
+        }
+    }
+
+    metrics.add(MetricCounter::RowsReturned, result.size());
+    timer.trace().addArg("returned", result.size());
+    return result;
+}
+
+std::vector<Suggestion> DataManager::suggestDescriptions(const std::string &prefix, size_t limit) const
+{
+    Metrics::Timer timer(metrics, MetricOperation::SuggestDescriptions);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::vector<Suggestion> result = suggestionIndex.suggest(prefix, limit);
+    metrics.add(MetricCounter::RowsReturned, result.size());
+    timer.trace().addArg("returned", result.size());
+    return result;
+}
+
+std::vector<Transaction> DataManager::queryTransactions(const TransactionQuery &query) const
+{
+    Metrics::Timer timer(metrics, MetricOperation::QueryTransactions);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    PreparedQuery prepared = prepareQuery(query);
+    std::vector<const std::vector<int> *> lists;
+    QueryPlan plan = planQuery(prepared, lists);
+    timer.trace().addArg("access", queryAccessName(plan.access));
+    timer.trace().addArg("estimated", plan.estimatedRows);
+
+    size_t limit = query.getLimit();
+    bool descending = query.isNewestFirst();
+    std::vector<Transaction> result;
+    size_t checked = 0;
+
+    if (plan.access == QueryAccess::Scan)
+    {
+        checked = transactions.size();
+        auto partials = collectMatches<std::vector<Transaction>>(prepared, plan, lists, [&](std::vector<Transaction> &found, const size_t *slots, size_t count)
+                                                                 {
+            for (size_t i = 0; i < count; i++)
+            {
+                found.push_back(transactions[slots[i]]);
+            } });
+        result = concatenate(partials);
+
+        auto inOrder = [descending](const Transaction &a, const Transaction &b)
+        { return descending ? a.getId() > b.getId() : a.getId() < b.getId(); };
+        if (limit != 0 && result.size() > limit)
+        {
+            std::partial_sort(result.begin(), result.begin() + limit, result.end(), inOrder);
+            result.resize(limit);
+        }
+        else
+        {
+            std::sort(result.begin(), result.end(), inOrder);
+        }
+    }
+    else
+    {
+        // Candidate IDs in result order, so a limit stops the scan early
+        std::vector<int> ids;
+        if (plan.access == QueryAccess::Text)
+        {
+            ids.reserve(plan.estimatedRows);
+            textIndex.visitCandidates(query.getPattern(), [&](int id)
+                                      {
+                ids.push_back(id);
+                return true; });
+            if (!descending)
+            {
+                std::reverse(ids.begin(), ids.end());
+            }
+        }
+        else
+        {
+            ids.reserve(plan.estimatedRows);
+            for (const auto *list : lists)
+            {
+                ids.insert(ids.end(), list->begin(), list->end());
+            }
+            if (lists.size() > 1)
+            {
+                std::sort(ids.begin(), ids.end());
+            }
+            if (descending)
+            {
+                std::reverse(ids.begin(), ids.end());
+            }
+        }
+
+        size_t slots[kQueryBlockSize];
+        for (size_t block = 0; block < ids.size() && (limit == 0 || result.size() < limit); block += kQueryBlockSize)
+        {
+            size_t count = std::min(kQueryBlockSize, ids.size() - block);
+            for (size_t i = 0; i < count; i++)
+            {
+                slots[i] = transactionSlots.at(ids[block + i]);
+            }
+            checked += count;
+            count = refineSlots(prepared, slots, count);
+            for (size_t i = 0; i < count && (limit == 0 || result.size() < limit); i++)
+            {
+                result.push_back(transactions[slots[i]]);
+            }
+        }
+    }
+
+    metrics.add(MetricCounter::RowsScanned, checked);
+    metrics.add(MetricCounter::RowsReturned, result.size());
+    timer.trace().addArg("checked", checked);
+    timer.trace().addArg("returned", result.size());
+    return result;
+}
+
+QueryPlan DataManager::explainQuery(const TransactionQuery &query) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    PreparedQuery prepared = prepareQuery(query);
+    std::vector<const std::vector<int> *> lists;
+    return planQuery(prepared, lists);
+}
+
+std::vector<Transaction> DataManager::getTopTransactions(const TransactionQuery &scope, size_t k) const
+{
+    Metrics::Timer timer(metrics, MetricOperation::GetTopTransactions);
+    if (k == 0)
+    {
+        return {};
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    PreparedQuery prepared = prepareQuery(scope);
+    std::vector<const std::vector<int> *> lists;
+    QueryPlan plan = planQuery(prepared, lists);
+    timer.trace().addArg("access", queryAccessName(plan.access));
+    metrics.add(MetricCounter::RowsScanned, plan.estimatedRows);
+
+    // Larger amounts rank first, then older IDs, so results don't depend on the partitioning
+    typedef std::pair<double, int> Ranked;
+    auto ranksAbove = [](const Ranked &a, const Ranked &b)
+    { return a.first != b.first ? a.first > b.first : a.second < b.second; };
+
+    // Each partition keeps a min-heap of its best k; the root is the one to evict
+    auto partials = collectMatches<std::vector<Ranked>>(prepared, plan, lists, [&](std::vector<Ranked> &heap, const size_t *slots, size_t count)
+                                                        {
+        for (size_t i = 0; i < count; i++)
+        {
+            size_t slot = slots[i];
+            if (!exchangeRates.isConvertible(transactionCurrencies[slot]))
+            {
+                continue;
+            }
+            Ranked entry(baseAmounts[slot], transactions[slot].getId());
+            if (heap.size() < k)
+            {
+                heap.push_back(entry);
+                std::push_heap(heap.begin(), heap.end(), ranksAbove);
+            }
+            else if (ranksAbove(entry, heap.front()))
+            {
+                std::pop_heap(heap.begin(), heap.end(), ranksAbove);
+                heap.back() = entry;
+                std::push_heap(heap.begin(), heap.end(), ranksAbove);
+            }
+        } });
+
+    std::vector<Ranked> best;
+    for (const auto &heap : partials)
+    {
+        best.insert(best.end(), heap.begin(), heap.end());
+    }
+    size_t kept = std::min(k, best.size());
+    std::partial_sort(best.begin(), best.begin() + kept, best.end(), ranksAbove);
+
+    std::vector<Transaction> result;
+    result.reserve(kept);
+    for (size_t i = 0; i < kept; i++)
+    {
+        result.push_back(transactions[transactionSlots.at(best[i].second)]);
+    }
+    metrics.add(MetricCounter::RowsReturned, result.size());
+    timer.trace().addArg("returned", result.size());
+    return result;
+}
+
+// Selects percentiles of amounts in place; values interpolate between the closest ranks
+static std::vector<double> selectPercentiles(std::vector<double> &amounts, const std::vector<double> &percentiles)
+{
+    std::vector<double> values(percentiles.size(), 0.0);
+    if (amounts.empty())
+    {
+        return values;
+    }
+
+    // Serve the percentiles in ascending order, each selection searching only above the last
+    std::vector<size_t> order(percentiles.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+              { return percentiles[a] < percentiles[b]; });
+
+    auto searched = amounts.begin();
+    for (size_t index : order)
+    {
+        double percentile = std::min(100.0, std::max(0.0, percentiles[index]));
+        double position = percentile / 100.0 * static_cast<double>(amounts.size() - 1);
+        size_t rank = static_cast<size_t>(position);
+        auto lower = amounts.begin() + rank;
+        if (lower >= searched)
+        {
+            std::nth_element(searched, lower, amounts.end());
+            searched = lower;
+        }
+
+        // Everything above the selected rank is at least as large, so the next rank is their minimum
+        double value = *lower;
+        if (rank + 1 < amounts.size() && position > static_cast<double>(rank))
+        {
+            double upper = *std::min_element(lower + 1, amounts.end());
+            value += (upper - value) * (position - static_cast<double>(rank));
+        }
+        values[index] = value;
+    }
+    return values;
+}
+
+std::vector<AmountStatistics> DataManager::getAmountStatistics(const TransactionQuery &scope, const std::vector<double> &percentiles,
+                                                               bool byCategory) const
+{
+    Metrics::Timer timer(metrics, MetricOperation::GetAmountStatistics);
+    std::unordered_map<int, std::vector<double>> groups;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        PreparedQuery prepared = prepareQuery(scope);
+        std::vector<const std::vector<int> *> lists;
+        QueryPlan plan = planQuery(prepared, lists);
+        timer.trace().addArg("access", queryAccessName(plan.access));
+        metrics.add(MetricCounter::RowsScanned, plan.estimatedRows);
+
+        auto partials = collectMatches<std::unordered_map<int, std::vector<double>>>(prepared, plan, lists, [&](std::unordered_map<int, std::vector<double>> &amounts, const size_t *slots, size_t count)
+                                                                                     {
+            for (size_t i = 0; i < count; i++)
+            {
+                size_t slot = slots[i];
+                if (exchangeRates.isConvertible(transactionCurrencies[slot]))
+                {
+                    amounts[byCategory ? transactions[slot].getCategoryId() : -1].push_back(baseAmounts[slot]);
+                }
+            } });
+
+        for (auto &partial : partials)
+        {
+            for (auto &pair : partial)
+            {
+                std::vector<double> &amounts = groups[pair.first];
+                amounts.insert(amounts.end(), pair.second.begin(), pair.second.end());
+            }
+        }
+    }
+
+    // Selection reorders the gathered copies, so it runs without the lock
+    std::vector<AmountStatistics> result;
+    for (auto &pair : groups)
+    {
+        std::vector<double> &amounts = pair.second;
+        AmountStatistics statistics;
+        statistics.categoryId = pair.first;
+        statistics.count = amounts.size();
+        statistics.min = *std::min_element(amounts.begin(), amounts.end());
+        statistics.max = *std::max_element(amounts.begin(), amounts.end());
+        double sum = 0.0;
+        for (double amount : amounts)
+        {
+            sum += amount;
+        }
+        statistics.mean = sum / static_cast<double>(amounts.size());
+        statistics.percentiles = selectPercentiles(amounts, percentiles);
+        result.push_back(statistics);
+    }
+
+    std::sort(result.begin(), result.end(), [](const AmountStatistics &a, const AmountStatistics &b)
+              { return a.categoryId < b.categoryId; });
+    metrics.add(MetricCounter::RowsReturned, result.size());
+    return result;
+}
+
+std::vector<RecurringSeries> DataManager::findRecurringTransactions(double amountTolerance, size_t minOccurrences) const
+{
+    Metrics::Timer timer(metrics, MetricOperation::FindRecurringTransactions);
+    using Groups = std::unordered_map<uint64_t, std::vector<RecurringOccurrence>>;
+    amountTolerance = std::max(amountTolerance, 0.0);
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    metrics.add(MetricCounter::RowsScanned, transactions.size());
+
+    // Each chunk groups its rows into hash shards, so every shard can then be merged on its own
+    auto partials = scanInChunks<std::vector<Groups>>(transactions.size(), [&](std::vector<Groups> &shards, size_t begin, size_t end)
+                                                      {
+        shards.resize(kRecurringShards);
+        for (size_t slot = begin; slot < end; slot++)
+        {
+            const Transaction &transaction = transactions[slot];
+            int day;
+            if (!DailyLedger::toDayNumber(transaction.getDate(), day))
+            {
+                continue;
+            }
+            std::string key = RecurringDetector::seriesKey(transaction.getDescription());
+            if (key.empty())
+            {
+                continue;
+            }
+            uint64_t hash = RecurringDetector::groupHash(key, transaction.getIsIncome());
+            shards[hash % kRecurringShards][hash].push_back({slot, day, transaction.getAmount()});
+        } });
+
+    std::vector<std::vector<RecurringSeries>> found(kRecurringShards);
+    ThreadPool::shared().parallelFor(kRecurringShards, 1, [&](size_t, size_t first, size_t last)
+                                     {
+        for (size_t shard = first; shard < last; shard++)
+        {
+            Groups groups;
+            for (auto &partial : partials)
+            {
+                for (auto &pair : partial[shard])
+                {
+                    std::vector<RecurringOccurrence> &occurrences = groups[pair.first];
+                    occurrences.insert(occurrences.end(), pair.second.begin(), pair.second.end());
+                }
+            }
+
+            std::vector<RecurringSeries> series;
+            std::vector<std::vector<size_t>> slots;
+            for (auto &pair : groups)
+            {
+                RecurringDetector::detect(pair.second, amountTolerance, minOccurrences, series, slots);
+            }
+
+            // The latest occurrence names the series, since descriptions and categories drift over the years
+            for (size_t i = 0; i < series.size(); i++)
+            {
+                const Transaction &latest = transactions[slots[i].back()];
+                series[i].description = latest.getDescription();
+                series[i].categoryId = latest.getCategoryId();
+                series[i].isIncome = latest.getIsIncome();
+                series[i].transactionIds.reserve(slots[i].size());
+                for (size_t slot : slots[i])
+                {
+                    series[i].transactionIds.push_back(transactions[slot].getId());
+                }
+            }
+            found[shard] = std::move(series);
+        } });
+    lock.unlock();
+
+    std::vector<RecurringSeries> result;
+    for (auto &series : found)
+    {
+        std::move(series.begin(), series.end(), std::back_inserter(result));
+    }
+    std::sort(result.begin(), result.end(), [](const RecurringSeries &a, const RecurringSeries &b)
+              { return a.nextDate != b.nextDate ? a.nextDate < b.nextDate : a.transactionIds.front() < b.transactionIds.front(); });
+    timer.trace().addArg("series", result.size());
+    metrics.add(MetricCounter::RowsReturned, result.size());
+    return result;
+}
+
+std::vector<BudgetVariance> DataManager::getBudgetVariance(const std::string &fromMonth, const std::string &toMonth) const
+{
+    Metrics::Timer timer(metrics, MetricOperation::GetBudgetVariance);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    timer.trace().addArg("budgets", budgets.size());
+
+    // Budgets probe the running spending totals, which act as the prebuilt side of the join
+    std::vector<BudgetVariance> result;
+    for (const auto &budget : budgets)
+    {
+        const std::string &monthYear = budget.getMonthYear();
+        if ((!fromMonth.empty() && monthYear < fromMonth) || (!toMonth.empty() && monthYear > toMonth))
+        {
+            continue;
+        }
+
+        int monthKey = toQueryMonthKey(monthYear);
+        auto entry = monthKey >= 0 ? categorySpending.find(spendingKey(budget.getCategoryId(), monthKey)) : categorySpending.end();
+        double spent = entry != categorySpending.end() ? entry->second.amount : 0.0;
+        double allocated = budget.getAllocatedAmount();
+        result.push_back({budget.getCategoryId(), monthYear, allocated, spent, allocated - spent,
+                          allocated != 0.0 ? spent / allocated * 100.0 : 0.0});
+    }
+
+    std::sort(result.begin(), result.end(), [](const BudgetVariance &a, const BudgetVariance &b)
+              { return a.monthYear != b.monthYear ? a.monthYear < b.monthYear : a.categoryId < b.categoryId; });
+    metrics.add(MetricCounter::RowsReturned, result.size());
+    return result;
+}
+
+std::vector<BudgetAlert> DataManager::takeBudgetAlerts()
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    // Alerts of an open batch stay queued until it commits or rolls back
+    size_t ready = batchActive ? batchAlertCount : budgetAlerts.size();
+    std::vector<BudgetAlert> result(budgetAlerts.begin(), budgetAlerts.begin() + ready);
+    budgetAlerts.erase(budgetAlerts.begin(), budgetAlerts.begin() + ready);
+    batchAlertCount -= batchActive ? ready : 0;
+    return result;
+}
+
+// Memory accounting
+MemoryStats DataManager::getMemoryStats() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+
+    MemoryStats stats = {};
+    stats.transactionRecords = transactions.capacity() * sizeof(Transaction);
+    stats.categoryRecords = categories.capacity() * sizeof(Category);
+    stats.budgetRecords = budgets.capacity() * sizeof(Budget);
+
+    for (const auto &transaction : transactions)
+    {
+        stats.stringPayloads += transaction.getHeapSize();
+    }
+    for (const auto &category : categories)
+    {
+        stats.stringPayloads += category.getHeapSize();
+    }
+    for (const auto &budget : budgets)
+    {
+        stats.stringPayloads += budget.getHeapSize();
+    }
+
+    stats.indexes = transactionMonths.capacity() * sizeof(int) + transactionCurrencies.capacity() * sizeof(uint16_t) +
+                    baseAmounts.capacity() * sizeof(double) + exchangeRates.getMemoryUsage() + hashIndexBytes(transactionSlots) +
+                    hashIndexBytes(categorySlots) + hashIndexBytes(budgetSlots) + duplicateIndex.getMemoryUsage() +
+                    textIndex.getMemoryUsage() + suggestionIndex.getMemoryUsage() + monthIndex.getMemoryUsage() +
+                    categoryIndex.getMemoryUsage() + tagIndex.getMemoryUsage() + hashIndexBytes(categorySpending) +
+                    dailyLedger.getMemoryUsage();
+    for (const auto &pair : budgetSlots)
+    {
+        stats.indexes += stringHeapSize(pair.first);
+    }
+
+    stats.changeLog = changeLog.getMemoryUsage();
+    stats.undoLog = undoLog.capacity() * sizeof(UndoRecord);
+    for (const auto &record : undoLog)
+    {
+        stats.undoLog += record.transaction.getHeapSize() + record.category.getHeapSize() + record.budget.getHeapSize();
+    }
+
+    stats.total = stats.transactionRecords + stats.categoryRecords + stats.budgetRecords + stats.stringPayloads +
+                  stats.indexes + stats.changeLog + stats.undoLog;
+    stats.peakLoadTransient = peakLoadBytes.load(std::memory_order_relaxed);
+    stats.peakSaveTransient = peakSaveBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void DataManager::compact()
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    transactions.shrink_to_fit();
+    transactionMonths.shrink_to_fit();
+    transactionCurrencies.shrink_to_fit();
+    baseAmounts.shrink_to_fit();
+    categories.shrink_to_fit();
+    budgets.shrink_to_fit();
+
+    transactionSlots.rehash(0);
+    categorySlots.rehash(0);
+    budgetSlots.rehash(0);
+    categorySpending.rehash(0);
+    textIndex.shrinkToFit();
+    monthIndex.shrinkToFit();
+    categoryIndex.shrinkToFit();
+    tagIndex.shrinkToFit();
+    dailyLedger.shrinkToFit();
+    suggestionIndex.rebuild(transactions, categories); // Drops nodes left behind by removed entries
+
+    changeLog.shrinkToFit();
+    if (!batchActive)
+    {
+        undoLog.clear();
+        undoLog.shrink_to_fit();
+    }
+}
+
+// Budget operations
+bool DataManager::addBudget(Budget &budget)
+{
+    Metrics::Timer timer(metrics, MetricOperation::AddBudget);
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (!isBatchWriter())
+        {
+            return false;
+        }
+
+        // Check if a budget for this category and month already exists
+        if (budgetSlots.count(budgetKey(budget.getCategoryId(), budget.getMonthYear())) != 0)
+        {
+            return false; // Budget already exists
+        }
+
+        insertBudgetRecord(budget);
+    }
+    return persistShared();
+}
+
+bool DataManager::updateBudget(const Budget &budget)
+{
+    Metrics::Timer timer(metrics, MetricOperation::UpdateBudget);
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (!isBatchWriter())
+        {
+            return false;
+        }
+
+        auto it = budgetSlots.find(budgetKey(budget.getCategoryId(), budget.getMonthYear()));
+        if (it == budgetSlots.end())
+        {
+            return false; // Budget not found
+        }
+
+        replaceBudgetAt(it->second, budget);
+    }
+    return persistShared();
+}
+
+bool DataManager::deleteBudget(int categoryId, const std::string &monthYear)
+{
+    Metrics::Timer timer(metrics, MetricOperation::DeleteBudget);
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (!isBatchWriter())
+        {
+            return false;
+        }
+
+        auto it = budgetSlots.find(budgetKey(categoryId, monthYear));
+        if (it == budgetSlots.end())
+        {
+            return false; // Budget not found
+        }
+
+        removeBudgetAt(it->second);
+    }
+    return persistShared();
+}
+
+Budget *DataManager::getBudget(int categoryId, const std::string &monthYear)
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = budgetSlots.find(budgetKey(categoryId, monthYear));
+    if (it == budgetSlots.end())
+    {
+        return nullptr; // Budget not found
+    }
+    return &budgets[it->second];
+}
+
+std::vector<Budget> DataManager::getAllBudgets() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return budgets;
+}
+
+std::vector<Budget> DataManager::getBudgetsByMonth(const std::string &monthYear) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::vector<Budget> result;
+    for (const auto &budget : budgets)
+    {
+        if (budget.getMonthYear() == monthYear)
+        {
+            result.push_back(budget);
+        }
+    }
+    return result;
+}
+
+// File operations
+bool DataManager::saveTransactions()
+{
+    json transactionsJson = json::array();
     for (const auto &transaction : transactions)
     {
-        if (transaction.getIsIncome() && transaction.getDate().substr(0, 7) == monthYear)
+        transactionsJson.push_back(transaction);
+    }
+
+    size_t fileBytes = 0;
+    bool success = saveToFile(getTransactionsFilePath(), transactionsJson, &fileBytes);
+    raisePeak(peakSaveBytes, estimateJsonDomBytes(fileBytes));
+    transactionsDirty = !success;
+    return success;
+}
+
+bool DataManager::saveCategories()
+{
+    json categoriesJson = json::array();
+    for (const auto &category : categories)
+    {
+        categoriesJson.push_back(category);
+    }
+
+    size_t fileBytes = 0;
+    bool success = saveToFile(getCategoriesFilePath(), categoriesJson, &fileBytes);
+    raisePeak(peakSaveBytes, estimateJsonDomBytes(fileBytes));
+    categoriesDirty = !success;
+    return success;
+}
+
+bool DataManager::saveBudgets()
+{
+    json budgetsJson = json::array();
+    for (const auto &budget : budgets)
+    {
+        budgetsJson.push_back(budget);
+    }
+
+    size_t fileBytes = 0;
+    bool success = saveToFile(getBudgetsFilePath(), budgetsJson, &fileBytes);
+    raisePeak(peakSaveBytes, estimateJsonDomBytes(fileBytes));
+    budgetsDirty = !success;
+    return success;
+}
+
+bool DataManager::saveRates()
+{
+    json ratesJson = json::array();
+    for (const auto &rate : exchangeRates.getRates())
+    {
+        ratesJson.push_back({{"currency", rate.currency}, {"date", rate.date}, {"rate", rate.rate}});
+    }
+
+    json ratesFile = {{"baseCurrency", exchangeRates.getBaseCurrency()}, {"rates", ratesJson}};
+    bool success = saveToFile(getRatesFilePath(), ratesFile);
+    ratesDirty = !success;
+    return success;
+}
+
+bool DataManager::saveAllData()
+{
+    Metrics::Timer timer(metrics, MetricOperation::SaveAllData);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::lock_guard<std::mutex> saveLock(saveMutex);
+    bool success = true;
+
+    success &= saveTransactions();
+    success &= saveCategories();
+    success &= saveBudgets();
+    success &= saveRates();
+
+    return success;
+}
+
+bool DataManager::loadAllData()
+{
+    Metrics::Timer timer(metrics, MetricOperation::LoadAllData);
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (!isBatchWriter())
+    {
+        return false;
+    }
+
+    json transactionsJson, categoriesJson, budgetsJson, ratesJson;
+    size_t transactionsBytes = 0, categoriesBytes = 0, budgetsBytes = 0;
+    bool anyLoaded = false;
+
+    // Load rates first so the base amounts computed while rebuilding use them; a missing file reads as an empty array
+    if (loadFromFile(getRatesFilePath(), ratesJson) && ratesJson.is_object())
+    {
+        exchangeRates.clear();
+        exchangeRates.setBaseCurrency(ratesJson.value("baseCurrency", ""));
+        for (const auto &item : ratesJson.value("rates", json::array()))
+        {
+            exchangeRates.setRate(item.at("currency").get<std::string>(), item.at("date").get<std::string>(),
+                                  item.at("rate").get<double>());
+        }
+        anyLoaded = true;
+    }
+
+    // Load transactions
+    if (loadFromFile(getTransactionsFilePath(), transactionsJson, &transactionsBytes))
+    {
+        transactions.clear();
+        transactions.reserve(transactionsJson.size());
+        nextTransactionId = 1;
+
+        for (const auto &item : transactionsJson)
+        {
+            Transaction transaction;
+            from_json(item, transaction);
+            transactions.push_back(transaction);
+
+            // Update next ID
+            if (transaction.getId() >= nextTransactionId)
+            {
+                nextTransactionId = transaction.getId() + 1;
+            }
+        }
+        anyLoaded = true;
+    }
+
+    // Load categories
+    if (loadFromFile(getCategoriesFilePath(), categoriesJson, &categoriesBytes))
+    {
+        categories.clear();
+        nextCategoryId = 1;
+
+        for (const auto &item : categoriesJson)
         {
-            total += transaction.getAmount();
+            Category category;
+            from_json(item, category);
+            categories.push_back(category);
+
+            // Update next ID
+            if (category.getId() >= nextCategoryId)
+            {
+                nextCategoryId = category.getId() + 1;
+            }
         }
+        anyLoaded = true;
     }
-    return total;
+
+    // Load budgets
+    if (loadFromFile(getBudgetsFilePath(), budgetsJson, &budgetsBytes))
+    {
+        budgets.clear();
+
+        for (const auto &item : budgetsJson)
+        {
+            Budget budget;
+            from_json(item, budget);
+            budgets.push_back(budget);
+        }
+        anyLoaded = true;
+    }
+
+    // All three documents are alive until this point
+    raisePeak(peakLoadBytes, estimateJsonDomBytes(transactionsBytes) + estimateJsonDomBytes(categoriesBytes) +
+                                 estimateJsonDomBytes(budgetsBytes));
+
+    rebuildIndexes();
+    changeLog.reset();
+    transactionsDirty = categoriesDirty = budgetsDirty = ratesDirty = false;
+    timer.trace().addArg("transactions", transactions.size());
+    timer.trace().addArg("categories", categories.size());
+    timer.trace().addArg("budgets", budgets.size());
+
+    return anyLoaded;
 }
 
-double DataManager::getTotalExpense(const std::string &monthYear) const
+// Currency operations
+double DataManager::toBaseAmount(size_t slot) const
+{
+    return transactions[slot].getAmount() * exchangeRates.monthlyRate(transactionCurrencies[slot], transactionMonths[slot]);
+}
+
+void DataManager::convertAllAmounts()
+{
+    baseAmounts.resize(transactions.size());
+    ThreadPool::shared().parallelFor(transactions.size(), kScanGrainSize, [&](size_t, size_t begin, size_t end)
+                                     {
+        // Rows arrive mostly in date order, so the rate rarely needs resolving
+        uint16_t currency = 0;
+        int month = std::numeric_limits<int>::min();
+        double rate = 1.0;
+        for (size_t i = begin; i < end; i++)
+        {
+            if (transactionCurrencies[i] != currency || transactionMonths[i] != month)
+            {
+                currency = transactionCurrencies[i];
+                month = transactionMonths[i];
+                rate = exchangeRates.monthlyRate(currency, month);
+            }
+            baseAmounts[i] = transactions[i].getAmount() * rate;
+        } });
+    rebuildTotals();
+}
+
+bool DataManager::setBaseCurrency(const std::string &currency)
+{
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        exchangeRates.setBaseCurrency(currency);
+        convertAllAmounts();
+        ratesDirty = true;
+    }
+    return persistRates();
+}
+
+std::string DataManager::getBaseCurrency() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return exchangeRates.getBaseCurrency();
+}
+
+bool DataManager::setExchangeRate(const std::string &currency, const std::string &date, double rate)
 {
-    double total = 0.0;
-    for (const auto &transaction : transactions)
     {
-        if (!transaction.getIsIncome() && transaction.getDate().substr(0, 7) == monthYear)
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (!exchangeRates.setRate(currency, date, rate))
         {
-            total += transaction.getAmount();
+            return false;
         }
+        convertAllAmounts();
+        ratesDirty = true;
     }
-    return total;
+    return persistRates();
 }
 
-double DataManager::getCategoryTotal(int categoryId, const std::string &monthYear) const
+bool DataManager::removeExchangeRate(const std::string &currency, const std::string &date)
+{
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (!exchangeRates.removeRate(currency, date))
+        {
+            return false;
+        }
+        convertAllAmounts();
+        ratesDirty = true;
+    }
+    return persistRates();
+}
+
+std::vector<ExchangeRate> DataManager::getExchangeRates() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return exchangeRates.getRates();
+}
+
+std::map<std::string, size_t> DataManager::getUnconvertedCurrencies() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::vector<size_t> counts;
+    for (uint16_t currency : transactionCurrencies)
+    {
+        if (currency >= counts.size())
+        {
+            counts.resize(currency + 1, 0);
+        }
+        counts[currency]++;
+    }
+
+    std::map<std::string, size_t> unconverted;
+    for (size_t currency = 0; currency < counts.size(); currency++)
+    {
+        if (counts[currency] > 0 && !exchangeRates.isConvertible(static_cast<uint16_t>(currency)))
+        {
+            unconverted[exchangeRates.getCode(static_cast<uint16_t>(currency))] = counts[currency];
+        }
+    }
+    return unconverted;
+}
+
+// Analysis functions
+double DataManager::getTotalIncome(const std::string &monthYear) const
 {
+    Metrics::Timer timer(metrics, MetricOperation::GetTotalIncome);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    metrics.add(MetricCounter::RowsScanned, transactions.size());
+    timer.trace().addArg("rows", transactions.size());
+    int monthKey = toQueryMonthKey(monthYear);
+
+    auto partials = scanInChunks<double>(transactions.size(), [&](double &total, size_t begin, size_t end)
+                                         {
+        for (size_t i = begin; i < end; i++)
+        {
+            if (transactions[i].getIsIncome() && matchesMonth(i, monthKey, monthYear))
+            {
+                total += baseAmounts[i];
+            }
+        } });
+
     double total = 0.0;
-    for (const auto &transaction : transactions)
+    for (double partial : partials)
     {
-        if (transaction.getCategoryId() == categoryId &&
-            transaction.getDate().substr(0, 7) == monthYear)
+        total += partial;
+    }
+    return total;
+}
+
+double DataManager::getTotalExpense(const std::string &monthYear) const
+{
+    Metrics::Timer timer(metrics, MetricOperation::GetTotalExpense);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    metrics.add(MetricCounter::RowsScanned, transactions.size());
+    timer.trace().addArg("rows", transactions.size());
+    int monthKey = toQueryMonthKey(monthYear);
+
+    auto partials = scanInChunks<double>(transactions.size(), [&](double &total, size_t begin, size_t end)
+                                         {
+        for (size_t i = begin; i < end; i++)
         {
-            if (transaction.getIsIncome())
+            if (!transactions[i].getIsIncome() && matchesMonth(i, monthKey, monthYear))
             {
-                total += transaction.getAmount();
+                total += baseAmounts[i];
             }
-            else
+        } });
+
+    double total = 0.0;
+    for (double partial : partials)
+    {
+        total += partial;
+    }
+    return total;
+}
+
+double DataManager::getCategoryTotal(int categoryId, const std::string &monthYear) const
+{
+    Metrics::Timer timer(metrics, MetricOperation::GetCategoryTotal);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    metrics.add(MetricCounter::RowsScanned, transactions.size());
+    timer.trace().addArg("rows", transactions.size());
+    int monthKey = toQueryMonthKey(monthYear);
+
+    auto partials = scanInChunks<double>(transactions.size(), [&](double &total, size_t begin, size_t end)
+                                         {
+        for (size_t i = begin; i < end; i++)
+        {
+            const Transaction &transaction = transactions[i];
+            if (transaction.getCategoryId() == categoryId && matchesMonth(i, monthKey, monthYear))
             {
-                total -= transaction.getAmount();
+                if (transaction.getIsIncome())
+                {
+                    total += baseAmounts[i];
+                }
+                else
+                {
+                    total -= baseAmounts[i];
+                }
             }
-        }
+        } });
+
+    double total = 0.0;
+    for (double partial : partials)
+    {
+        total += partial;
     }
     return total;
 }
 
 std::map<int, double> DataManager::getCategoryTotals(const std::string &monthYear) const
 {
+    Metrics::Timer timer(metrics, MetricOperation::GetCategoryTotals);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    metrics.add(MetricCounter::RowsScanned, transactions.size());
+    timer.trace().addArg("rows", transactions.size());
+    int monthKey = toQueryMonthKey(monthYear);
     std::map<int, double> totals;
 
     // Initialize totals for all categories
@@ -531,38 +2900,407 @@ std::map<int, double> DataManager::getCategoryTotals(const std::string &monthYea
         totals[category.getId()] = 0.0;
     }
 
-    // Add up transactions
-    for (const auto &transaction : transactions)
+    // Add up transactions per chunk, then merge the chunks in order
+    auto partials = scanInChunks<std::unordered_map<int, double>>(transactions.size(), [&](std::unordered_map<int, double> &chunkTotals, size_t begin, size_t end)
+                                                                  {
+        for (size_t i = begin; i < end; i++)
+        {
+            const Transaction &transaction = transactions[i];
+            if (matchesMonth(i, monthKey, monthYear))
+            {
+                if (transaction.getIsIncome())
+                {
+                    chunkTotals[transaction.getCategoryId()] += baseAmounts[i];
+                }
+                else
+                {
+                    chunkTotals[transaction.getCategoryId()] -= baseAmounts[i];
+                }
+            }
+        } });
+
+    for (const auto &partial : partials)
     {
-        if (transaction.getDate().substr(0, 7) == monthYear)
+        for (const auto &pair : partial)
         {
-            if (transaction.getIsIncome())
+            totals[pair.first] += pair.second;
+        }
+    }
+
+    return totals;
+}
+
+std::vector<CategoryRollup> DataManager::getCategoryRollups(const std::string &monthYear) const
+{
+    Metrics::Timer timer(metrics, MetricOperation::GetCategoryRollups);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    timer.trace().addArg("categories", categories.size());
+    size_t count = categories.size();
+
+    // Own totals come from the running per-category, per-month totals
+    std::vector<double> total(count, 0.0);
+    std::vector<double> spent(count, 0.0);
+    if (monthYear.empty())
+    {
+        for (const auto &entry : categorySpending)
+        {
+            auto slot = categorySlots.find(static_cast<int>(entry.first >> 32));
+            if (slot != categorySlots.end())
             {
-                totals[transaction.getCategoryId()] += transaction.getAmount();
+                total[slot->second] += entry.second.income - entry.second.amount;
+                spent[slot->second] += entry.second.amount;
             }
-            else
+        }
+    }
+    else
+    {
+        int monthKey = toQueryMonthKey(monthYear);
+        for (size_t i = 0; monthKey >= 0 && i < count; i++)
+        {
+            auto entry = categorySpending.find(spendingKey(categories[i].getId(), monthKey));
+            if (entry != categorySpending.end())
             {
-                totals[transaction.getCategoryId()] -= transaction.getAmount();
+                total[i] = entry->second.income - entry->second.amount;
+                spent[i] = entry->second.amount;
             }
         }
     }
 
-    return totals;
+    // Lay the tree out depth first, children in ID order; a missing parent makes a category top-level
+    std::vector<std::vector<size_t>> children(count);
+    std::vector<size_t> roots;
+    for (size_t i = 0; i < count; i++)
+    {
+        auto parent = categorySlots.find(categories[i].getParentId());
+        if (categories[i].getParentId() == 0 || parent == categorySlots.end())
+        {
+            roots.push_back(i);
+        }
+        else
+        {
+            children[parent->second].push_back(i);
+        }
+    }
+    auto byId = [&](size_t a, size_t b)
+    { return categories[a].getId() < categories[b].getId(); };
+    std::sort(roots.begin(), roots.end(), byId);
+    for (auto &list : children)
+    {
+        std::sort(list.begin(), list.end(), byId);
+    }
+
+    std::vector<CategoryRollup> result;
+    std::vector<size_t> parentEntries; // Index in result of each entry's parent, parallel to result
+    result.reserve(count);
+    std::vector<bool> visited(count, false);
+    std::vector<std::pair<size_t, size_t>> stack;
+    const size_t noParent = std::numeric_limits<size_t>::max();
+    auto visit = [&](size_t root)
+    {
+        stack.push_back({root, noParent});
+        while (!stack.empty())
+        {
+            size_t slot = stack.back().first;
+            size_t parentEntry = stack.back().second;
+            stack.pop_back();
+            visited[slot] = true;
+
+            bool top = parentEntry == noParent;
+            result.push_back({categories[slot].getId(), top ? 0 : result[parentEntry].categoryId, top ? 0 : result[parentEntry].depth + 1,
+                              total[slot], spent[slot], total[slot], spent[slot]});
+            parentEntries.push_back(parentEntry);
+            for (auto child = children[slot].rbegin(); child != children[slot].rend(); ++child)
+            {
+                if (!visited[*child])
+                {
+                    stack.push_back({*child, result.size() - 1});
+                }
+            }
+        }
+    };
+    for (size_t root : roots)
+    {
+        visit(root);
+    }
+
+    // Categories caught in a parent cycle, possible only in hand-edited files, are cut loose at their smallest ID
+    std::vector<size_t> remaining;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!visited[i])
+        {
+            remaining.push_back(i);
+        }
+    }
+    std::sort(remaining.begin(), remaining.end(), byId);
+    for (size_t slot : remaining)
+    {
+        if (!visited[slot])
+        {
+            visit(slot);
+        }
+    }
+
+    // Every child follows its parent, so one backward pass folds each subtree into its parent
+    for (size_t i = result.size(); i-- > 0;)
+    {
+        if (parentEntries[i] != noParent)
+        {
+            result[parentEntries[i]].subtreeTotal += result[i].subtreeTotal;
+            result[parentEntries[i]].subtreeSpent += result[i].subtreeSpent;
+        }
+    }
+
+    metrics.add(MetricCounter::RowsReturned, result.size());
+    return result;
+}
+
+double DataManager::getCategorySubtreeTotal(int categoryId, const std::string &monthYear) const
+{
+    for (const auto &rollup : getCategoryRollups(monthYear))
+    {
+        if (rollup.categoryId == categoryId)
+        {
+            return rollup.subtreeTotal;
+        }
+    }
+    return 0.0;
 }
 
 std::map<std::string, double> DataManager::getMonthlyTotals(bool isIncome) const
 {
-    std::map<std::string, double> totals;
+    Metrics::Timer timer(metrics, MetricOperation::GetMonthlyTotals);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    metrics.add(MetricCounter::RowsScanned, transactions.size());
+    timer.trace().addArg("rows", transactions.size());
 
-    for (const auto &transaction : transactions)
+    // Rows with a malformed date are grouped by their raw prefix, as before
+    struct MonthlyPartial
     {
-        std::string month = transaction.getDate().substr(0, 7); // Extract YYYY-MM
+        std::map<int, double> byKey;
+        std::map<std::string, double> byPrefix;
+    };
+
+    auto partials = scanInChunks<MonthlyPartial>(transactions.size(), [&](MonthlyPartial &partial, size_t begin, size_t end)
+                                                 {
+        for (size_t i = begin; i < end; i++)
+        {
+            const Transaction &transaction = transactions[i];
+            if (transaction.getIsIncome() != isIncome)
+            {
+                continue;
+            }
+
+            if (transactionMonths[i] >= 0)
+            {
+                partial.byKey[transactionMonths[i]] += baseAmounts[i];
+            }
+            else
+            {
+                partial.byPrefix[transaction.getDate().substr(0, 7)] += baseAmounts[i];
+            }
+        } });
 
-        if (transaction.getIsIncome() == isIncome)
+    std::map<std::string, double> totals;
+    for (const auto &partial : partials)
+    {
+        for (const auto &pair : partial.byKey)
         {
-            totals[month] += transaction.getAmount();
+            totals[fromMonthKey(pair.first)] += pair.second;
+        }
+        for (const auto &pair : partial.byPrefix)
+        {
+            totals[pair.first] += pair.second;
         }
     }
 
     return totals;
-}
\ No newline at end of file
+}
+
+bool DataManager::getReportBundle(const std::string &fromMonth, const std::string &toMonth, ReportBundle &bundle) const
+{
+    Metrics::Timer timer(metrics, MetricOperation::GetReportBundle);
+    int fromKey = toQueryMonthKey(fromMonth);
+    int toKey = toQueryMonthKey(toMonth);
+    int first = monthOrdinal(fromKey);
+    int last = monthOrdinal(toKey);
+    if (first < 0 || last < first || last - first >= kMaxReportMonths)
+    {
+        std::cerr << "Invalid report range: " << fromMonth << " to " << toMonth << std::endl;
+        return false;
+    }
+    size_t monthCount = static_cast<size_t>(last - first + 1);
+
+    struct CategoryActivity
+    {
+        double total = 0.0;
+        double spent = 0.0;
+    };
+    struct ReportPartial
+    {
+        std::vector<double> income;
+        std::vector<double> expense;
+        std::vector<std::unordered_map<int, CategoryActivity>> categories;
+    };
+    auto accumulate = [&](ReportPartial &partial, size_t slot)
+    {
+        size_t month = static_cast<size_t>(monthOrdinal(transactionMonths[slot]) - first);
+        if (month >= monthCount)
+        {
+            return;
+        }
+
+        const Transaction &transaction = transactions[slot];
+        CategoryActivity &activity = partial.categories[month][transaction.getCategoryId()];
+        double amount = baseAmounts[slot];
+        if (transaction.getIsIncome())
+        {
+            partial.income[month] += amount;
+            activity.total += amount;
+        }
+        else
+        {
+            partial.expense[month] += amount;
+            activity.total -= amount;
+            activity.spent += amount;
+        }
+    };
+    auto startPartial = [&](ReportPartial &partial)
+    {
+        partial.income.assign(monthCount, 0.0);
+        partial.expense.assign(monthCount, 0.0);
+        partial.categories.resize(monthCount);
+    };
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+
+    // Read the range through the month index when it holds few of the transactions
+    std::vector<const std::vector<int> *> lists;
+    size_t rows = monthIndex.findRange(fromKey, toKey, lists);
+    std::vector<ReportPartial> partials;
+    if (rows * kIndexCostFactor < transactions.size())
+    {
+        timer.trace().addArg("access", "month");
+        partials.resize(1);
+        startPartial(partials[0]);
+        for (const auto *ids : lists)
+        {
+            for (int id : *ids)
+            {
+                accumulate(partials[0], transactionSlots.at(id));
+            }
+        }
+    }
+    else
+    {
+        timer.trace().addArg("access", "scan");
+        rows = transactions.size();
+        partials = scanInChunks<ReportPartial>(transactions.size(), [&](ReportPartial &partial, size_t begin, size_t end)
+                                               {
+            startPartial(partial);
+            for (size_t i = begin; i < end; i++)
+            {
+                accumulate(partial, i);
+            } });
+    }
+    metrics.add(MetricCounter::RowsScanned, rows);
+    timer.trace().addArg("rows", rows);
+
+    // Merge the partials, then probe the merged activity with each budget in the range
+    std::vector<std::unordered_map<int, CategoryReport>> byCategory(monthCount);
+    bundle.fromMonth = fromMonth;
+    bundle.toMonth = toMonth;
+    bundle.income = bundle.expense = 0.0;
+    bundle.months.assign(monthCount, MonthReport());
+    for (size_t month = 0; month < monthCount; month++)
+    {
+        MonthReport &report = bundle.months[month];
+        int ordinal = first + static_cast<int>(month);
+        report.monthYear = fromMonthKey(ordinal / 12 * 100 + ordinal % 12 + 1);
+        report.income = report.expense = 0.0;
+        for (const auto &partial : partials)
+        {
+            if (partial.income.empty())
+            {
+                continue; // Chunks of an empty ledger are never started
+            }
+            report.income += partial.income[month];
+            report.expense += partial.expense[month];
+            for (const auto &pair : partial.categories[month])
+            {
+                auto inserted = byCategory[month].emplace(pair.first, CategoryReport{pair.first, 0.0, 0.0, 0.0, false, 0.0});
+                inserted.first->second.total += pair.second.total;
+                inserted.first->second.spent += pair.second.spent;
+            }
+        }
+        report.net = report.income - report.expense;
+        bundle.income += report.income;
+        bundle.expense += report.expense;
+    }
+    bundle.net = bundle.income - bundle.expense;
+
+    for (const auto &budget : budgets)
+    {
+        size_t month = static_cast<size_t>(monthOrdinal(toQueryMonthKey(budget.getMonthYear())) - first);
+        if (month < monthCount)
+        {
+            auto inserted = byCategory[month].emplace(budget.getCategoryId(), CategoryReport{budget.getCategoryId(), 0.0, 0.0, 0.0, false, 0.0});
+            inserted.first->second.allocated = budget.getAllocatedAmount();
+            inserted.first->second.hasBudget = true;
+        }
+    }
+
+    for (size_t month = 0; month < monthCount; month++)
+    {
+        std::vector<CategoryReport> &categoryReports = bundle.months[month].categories;
+        categoryReports.reserve(byCategory[month].size());
+        for (auto &pair : byCategory[month])
+        {
+            CategoryReport &report = pair.second;
+            report.utilization = report.allocated != 0.0 ? report.spent / report.allocated : 0.0;
+            categoryReports.push_back(report);
+        }
+        std::sort(categoryReports.begin(), categoryReports.end(), [](const CategoryReport &a, const CategoryReport &b)
+                  { return a.categoryId < b.categoryId; });
+    }
+    return true;
+}
+
+bool DataManager::getTimeSeries(const std::string &fromDate, const std::string &toDate, SeriesInterval interval, int windowDays,
+                                std::vector<SeriesPoint> &series) const
+{
+    Metrics::Timer timer(metrics, MetricOperation::GetTimeSeries);
+    int first, last;
+    if (!DailyLedger::toDayNumber(fromDate, first) || !DailyLedger::toDayNumber(toDate, last) || last < first)
+    {
+        std::cerr << "Invalid time series range: " << fromDate << " to " << toDate << std::endl;
+        return false;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    series.clear();
+    for (int start = first; start <= last;)
+    {
+        int end = std::min(DailyLedger::bucketEnd(start, interval), last);
+        SeriesPoint point;
+        point.startDate = DailyLedger::fromDayNumber(start);
+        point.endDate = DailyLedger::fromDayNumber(end);
+        point.income = dailyLedger.sumIncome(start, end);
+        point.expense = dailyLedger.sumExpense(start, end);
+        point.net = point.income - point.expense;
+        point.balance = dailyLedger.sumIncome(std::numeric_limits<int>::min(), end) -
+                        dailyLedger.sumExpense(std::numeric_limits<int>::min(), end);
+        point.averageIncome = point.averageExpense = 0.0;
+        if (windowDays > 0)
+        {
+            // Days before the first tracked one hold nothing, and clamping keeps a huge window from overflowing
+            int windowStart = static_cast<int>(std::max<long long>(static_cast<long long>(end) - windowDays + 1, DailyLedger::kFirstDay));
+            point.averageIncome = dailyLedger.sumIncome(windowStart, end) / windowDays;
+            point.averageExpense = dailyLedger.sumExpense(windowStart, end) / windowDays;
+        }
+        series.push_back(point);
+        start = end + 1;
+    }
+    timer.trace().addArg("buckets", series.size());
+    return true;
+}
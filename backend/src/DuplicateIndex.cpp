@@ -0,0 +1,191 @@
+#include "../include/DuplicateIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+// 64-bit FNV-1a over a byte range, continuing from a previous hash
+static uint64_t hashBytes(const char *data, size_t size, uint64_t hash)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Final avalanche so every bit of the fingerprint depends on every input bit
+static uint64_t mix(uint64_t value)
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+DuplicateIndex::DuplicateIndex()
+    : bloomCapacity(0)
+{
+    resizeBloom(1024);
+}
+
+uint64_t DuplicateIndex::fingerprint(const Transaction &transaction)
+{
+    long long cents = std::llround(transaction.getAmount() * 100.0);
+    if (!transaction.getIsIncome())
+    {
+        cents = -cents;
+    }
+
+    std::string date = transaction.getDate();
+    std::string description = normalizeDescription(transaction.getDescription());
+
+    uint64_t hash = 14695981039346656037ULL;
+    hash = hashBytes(date.data(), date.size(), hash);
+    hash = hashBytes(reinterpret_cast<const char *>(&cents), sizeof(cents), hash);
+    hash = hashBytes(description.data(), description.size(), hash);
+    return mix(hash);
+}
+
+std::string DuplicateIndex::normalizeDescription(const std::string &description)
+{
+    std::string normalized;
+    normalized.reserve(description.size());
+    bool pendingSpace = false;
+    for (char c : description)
+    {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (std::isalnum(byte))
+        {
+            if (pendingSpace && !normalized.empty())
+            {
+                normalized += ' ';
+            }
+            normalized += static_cast<char>(std::tolower(byte));
+            pendingSpace = false;
+        }
+        else
+        {
+            pendingSpace = true;
+        }
+    }
+    return normalized;
+}
+
+void DuplicateIndex::add(uint64_t fingerprint, int id)
+{
+    entries.emplace(fingerprint, id);
+    if (entries.size() > bloomCapacity)
+    {
+        resizeBloom(bloomCapacity * 2);
+    }
+    else
+    {
+        setBloomBits(fingerprint);
+    }
+}
+
+void DuplicateIndex::remove(uint64_t fingerprint, int id)
+{
+    // Bloom bits cannot be cleared; stale bits only cost an extra exact lookup
+    auto range = entries.equal_range(fingerprint);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second == id)
+        {
+            entries.erase(it);
+            return;
+        }
+    }
+}
+
+int DuplicateIndex::find(uint64_t fingerprint) const
+{
+    if (!testBloomBits(fingerprint))
+    {
+        return 0;
+    }
+
+    auto it = entries.find(fingerprint);
+    return it == entries.end() ? 0 : it->second;
+}
+
+std::vector<std::vector<int>> DuplicateIndex::findGroups() const
+{
+    // Entries with equal fingerprints are adjacent when iterating a multimap
+    std::vector<std::vector<int>> groups;
+    auto it = entries.begin();
+    while (it != entries.end())
+    {
+        auto range = entries.equal_range(it->first);
+        std::vector<int> group;
+        for (auto match = range.first; match != range.second; ++match)
+        {
+            group.push_back(match->second);
+        }
+        if (group.size() > 1)
+        {
+            std::sort(group.begin(), group.end());
+            groups.push_back(std::move(group));
+        }
+        it = range.second;
+    }
+
+    std::sort(groups.begin(), groups.end());
+    return groups;
+}
+
+void DuplicateIndex::reset(size_t expectedCount)
+{
+    entries.clear();
+    entries.reserve(expectedCount);
+    bloomCapacity = 0;
+    resizeBloom(std::max<size_t>(1024, expectedCount));
+}
+
+size_t DuplicateIndex::getMemoryUsage() const
+{
+    return bloomBits.capacity() * sizeof(uint64_t) + entries.bucket_count() * sizeof(void *) +
+           entries.size() * (sizeof(void *) + sizeof(size_t) + sizeof(std::pair<const uint64_t, int>));
+}
+
+void DuplicateIndex::resizeBloom(size_t capacity)
+{
+    bloomCapacity = capacity;
+    bloomBits.assign((capacity * kBitsPerEntry + 63) / 64, 0);
+    for (const auto &entry : entries)
+    {
+        setBloomBits(entry.first);
+    }
+}
+
+void DuplicateIndex::setBloomBits(uint64_t fingerprint)
+{
+    // Double hashing: probe i uses low + i * high
+    uint64_t bitCount = bloomBits.size() * 64;
+    uint64_t low = fingerprint & 0xffffffffULL;
+    uint64_t high = (fingerprint >> 32) | 1;
+    for (int i = 0; i < kHashCount; i++)
+    {
+        uint64_t bit = (low + i * high) % bitCount;
+        bloomBits[bit / 64] |= 1ULL << (bit % 64);
+    }
+}
+
+bool DuplicateIndex::testBloomBits(uint64_t fingerprint) const
+{
+    uint64_t bitCount = bloomBits.size() * 64;
+    uint64_t low = fingerprint & 0xffffffffULL;
+    uint64_t high = (fingerprint >> 32) | 1;
+    for (int i = 0; i < kHashCount; i++)
+    {
+        uint64_t bit = (low + i * high) % bitCount;
+        if ((bloomBits[bit / 64] & (1ULL << (bit % 64))) == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,187 @@
+#include "../include/ExchangeRates.h"
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <iterator>
+#include "../include/DailyLedger.h"
+
+ExchangeRates::ExchangeRates()
+{
+    codes.push_back("");
+    rates.emplace_back();
+    indexes[""] = 0;
+}
+
+std::string ExchangeRates::normalizeCode(const std::string &code)
+{
+    size_t begin = 0;
+    size_t end = code.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(code[begin])))
+    {
+        begin++;
+    }
+    while (end > begin && std::isspace(static_cast<unsigned char>(code[end - 1])))
+    {
+        end--;
+    }
+
+    std::string value = code.substr(begin, end - begin);
+    for (char &c : value)
+    {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    return value;
+}
+
+const std::string &ExchangeRates::getBaseCurrency() const
+{
+    return baseCurrency;
+}
+
+void ExchangeRates::setBaseCurrency(const std::string &code)
+{
+    baseCurrency = normalizeCode(code);
+    invalidate();
+}
+
+uint16_t ExchangeRates::intern(const std::string &code)
+{
+    auto entry = indexes.find(code);
+    if (entry != indexes.end())
+    {
+        return entry->second;
+    }
+
+    auto index = static_cast<uint16_t>(codes.size());
+    codes.push_back(code);
+    rates.emplace_back();
+    indexes.emplace(code, index);
+    return index;
+}
+
+const std::string &ExchangeRates::getCode(uint16_t currency) const
+{
+    return codes[currency];
+}
+
+bool ExchangeRates::isConvertible(uint16_t currency) const
+{
+    return currency == 0 || !rates[currency].empty() || codes[currency] == baseCurrency;
+}
+
+bool ExchangeRates::setRate(const std::string &code, const std::string &date, double rate)
+{
+    std::string currency = normalizeCode(code);
+    int day;
+    if (currency.empty() || !DailyLedger::toDayNumber(date, day) || !std::isfinite(rate) || rate <= 0.0)
+    {
+        std::cerr << "Invalid exchange rate: " << code << " " << date << " " << rate << std::endl;
+        return false;
+    }
+
+    rates[intern(currency)][date.substr(0, 10)] = rate;
+    invalidate();
+    return true;
+}
+
+bool ExchangeRates::removeRate(const std::string &code, const std::string &date)
+{
+    auto entry = indexes.find(normalizeCode(code));
+    if (entry == indexes.end() || rates[entry->second].erase(date) == 0)
+    {
+        return false;
+    }
+
+    invalidate();
+    return true;
+}
+
+std::vector<ExchangeRate> ExchangeRates::getRates() const
+{
+    std::map<std::string, uint16_t> byCode(indexes.begin(), indexes.end());
+    std::vector<ExchangeRate> result;
+    for (const auto &entry : byCode)
+    {
+        for (const auto &rate : rates[entry.second])
+        {
+            result.push_back({entry.first, rate.first, rate.second});
+        }
+    }
+    return result;
+}
+
+double ExchangeRates::monthlyRate(uint16_t currency, int monthKey) const
+{
+    if (currency == 0)
+    {
+        return 1.0;
+    }
+    if (rates[currency].empty())
+    {
+        // Counting an unrated amount at face value would mix currencies in one total
+        return codes[currency] == baseCurrency ? 1.0 : 0.0;
+    }
+
+    uint64_t key = (static_cast<uint64_t>(currency) << 32) | static_cast<uint32_t>(monthKey);
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto cached = monthCache.find(key);
+    if (cached != monthCache.end())
+    {
+        return cached->second;
+    }
+    double rate = resolve(currency, monthKey);
+    monthCache.emplace(key, rate);
+    return rate;
+}
+
+void ExchangeRates::clear()
+{
+    baseCurrency.clear();
+    for (auto &dated : rates)
+    {
+        dated.clear();
+    }
+    invalidate();
+}
+
+size_t ExchangeRates::getMemoryUsage() const
+{
+    // Red-black tree node: three links and a color, then the date and rate
+    size_t bytes = codes.capacity() * sizeof(std::string) + rates.capacity() * sizeof(std::map<std::string, double>) +
+                   indexes.bucket_count() * sizeof(void *) +
+                   indexes.size() * (2 * sizeof(void *) + sizeof(std::pair<const std::string, uint16_t>));
+    for (const auto &dated : rates)
+    {
+        bytes += dated.size() * (4 * sizeof(void *) + sizeof(std::pair<const std::string, double>));
+    }
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return bytes + monthCache.bucket_count() * sizeof(void *) +
+           monthCache.size() * (2 * sizeof(void *) + sizeof(std::pair<const uint64_t, double>));
+}
+
+double ExchangeRates::resolve(uint16_t currency, int monthKey) const
+{
+    if (codes[currency] == baseCurrency)
+    {
+        return 1.0;
+    }
+
+    const std::map<std::string, double> &dated = rates[currency];
+    if (monthKey < 0)
+    {
+        return dated.rbegin()->second;
+    }
+
+    // Every date of the month sorts at or before its day 31
+    char monthEnd[16];
+    std::snprintf(monthEnd, sizeof(monthEnd), "%04d-%02d-31", monthKey / 100, monthKey % 100);
+    auto after = dated.upper_bound(monthEnd);
+    return after == dated.begin() ? after->second : std::prev(after)->second;
+}
+
+void ExchangeRates::invalidate()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    monthCache.clear();
+}
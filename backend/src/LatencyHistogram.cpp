@@ -0,0 +1,146 @@
+#include "../include/LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram()
+    : count(0), sum(0), max(0)
+{
+    for (auto &bucket : buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+LatencyHistogram::LatencyHistogram(const LatencyHistogram &other)
+    : LatencyHistogram()
+{
+    merge(other);
+}
+
+LatencyHistogram &LatencyHistogram::operator=(const LatencyHistogram &other)
+{
+    if (this != &other)
+    {
+        reset();
+        merge(other);
+    }
+    return *this;
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t nanos)
+{
+    if (nanos < 2 * kSubBucketCount)
+    {
+        return static_cast<size_t>(nanos);
+    }
+
+    // Position of the highest set bit decides the power of two, the next bits the sub-bucket
+    int msb = 63;
+    while ((nanos >> msb) == 0)
+    {
+        msb--;
+    }
+    if (msb > kMaxExponent)
+    {
+        return kBucketCount - 1;
+    }
+
+    int exponent = msb - kSubBucketBits;
+    return static_cast<size_t>((exponent + 1) * kSubBucketCount + ((nanos >> exponent) - kSubBucketCount));
+}
+
+uint64_t LatencyHistogram::bucketValue(size_t index)
+{
+    if (index < 2 * kSubBucketCount)
+    {
+        return index;
+    }
+
+    int exponent = static_cast<int>(index / kSubBucketCount) - 1;
+    uint64_t subBucket = index % kSubBucketCount + kSubBucketCount;
+    uint64_t lower = subBucket << exponent;
+    uint64_t width = uint64_t(1) << exponent;
+    return lower + width / 2;
+}
+
+void LatencyHistogram::record(uint64_t nanos)
+{
+    buckets[bucketIndex(nanos)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(nanos, std::memory_order_relaxed);
+
+    uint64_t current = max.load(std::memory_order_relaxed);
+    while (nanos > current && !max.compare_exchange_weak(current, nanos, std::memory_order_relaxed))
+    {
+    }
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    for (size_t i = 0; i < kBucketCount; i++)
+    {
+        uint64_t value = other.buckets[i].load(std::memory_order_relaxed);
+        if (value != 0)
+        {
+            buckets[i].fetch_add(value, std::memory_order_relaxed);
+        }
+    }
+    count.fetch_add(other.count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    sum.fetch_add(other.sum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    uint64_t otherMax = other.max.load(std::memory_order_relaxed);
+    uint64_t current = max.load(std::memory_order_relaxed);
+    while (otherMax > current && !max.compare_exchange_weak(current, otherMax, std::memory_order_relaxed))
+    {
+    }
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto &bucket : buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getCount() const
+{
+    return count.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getMax() const
+{
+    return max.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::getMean() const
+{
+    uint64_t samples = getCount();
+    return samples == 0 ? 0.0 : static_cast<double>(sum.load(std::memory_order_relaxed)) / samples;
+}
+
+uint64_t LatencyHistogram::getPercentile(double percentile) const
+{
+    uint64_t samples = getCount();
+    if (samples == 0)
+    {
+        return 0;
+    }
+
+    percentile = std::min(100.0, std::max(0.0, percentile));
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * samples)));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; i++)
+    {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            return std::min(bucketValue(i), getMax());
+        }
+    }
+    return getMax();
+}
@@ -0,0 +1,157 @@
+#include "../include/Metrics.h"
+
+Metrics::Timer::Timer(Metrics &metrics, MetricOperation operation)
+    : metrics(metrics), operation(operation), startTime(std::chrono::steady_clock::now()),
+      span(operationName(operation), "data")
+{
+}
+
+Metrics::Timer::~Timer()
+{
+    auto elapsed = std::chrono::steady_clock::now() - startTime;
+    metrics.record(operation, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+Metrics::Metrics()
+{
+    for (auto &counter : counters)
+    {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+void Metrics::record(MetricOperation operation, uint64_t nanos)
+{
+    histograms[static_cast<size_t>(operation)].record(nanos);
+}
+
+void Metrics::add(MetricCounter counter, uint64_t amount)
+{
+    counters[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+}
+
+const LatencyHistogram &Metrics::getHistogram(MetricOperation operation) const
+{
+    return histograms[static_cast<size_t>(operation)];
+}
+
+uint64_t Metrics::getCounter(MetricCounter counter) const
+{
+    return counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+}
+
+void Metrics::reset()
+{
+    for (auto &histogram : histograms)
+    {
+        histogram.reset();
+    }
+    for (auto &counter : counters)
+    {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+const char *Metrics::operationName(MetricOperation operation)
+{
+    switch (operation)
+    {
+    case MetricOperation::LoadAllData:
+        return "loadAllData";
+    case MetricOperation::SaveAllData:
+        return "saveAllData";
+    case MetricOperation::Persist:
+        return "persist";
+    case MetricOperation::ReadFile:
+        return "readFile";
+    case MetricOperation::WriteFile:
+        return "writeFile";
+    case MetricOperation::AddTransaction:
+        return "addTransaction";
+    case MetricOperation::UpdateTransaction:
+        return "updateTransaction";
+    case MetricOperation::DeleteTransaction:
+        return "deleteTransaction";
+    case MetricOperation::TransactionsBatch:
+        return "transactionsBatch";
+    case MetricOperation::AddCategory:
+        return "addCategory";
+    case MetricOperation::UpdateCategory:
+        return "updateCategory";
+    case MetricOperation::DeleteCategory:
+        return "deleteCategory";
+    case MetricOperation::AddBudget:
+        return "addBudget";
+    case MetricOperation::UpdateBudget:
+        return "updateBudget";
+    case MetricOperation::DeleteBudget:
+        return "deleteBudget";
+    case MetricOperation::CommitBatch:
+        return "commitBatch";
+    case MetricOperation::GetAllTransactions:
+        return "getAllTransactions";
+    case MetricOperation::GetTransactionsByCategory:
+        return "getTransactionsByCategory";
+    case MetricOperation::GetTransactionsByMonth:
+        return "getTransactionsByMonth";
+    case MetricOperation::GetTotalIncome:
+        return "getTotalIncome";
+    case MetricOperation::GetTotalExpense:
+        return "getTotalExpense";
+    case MetricOperation::GetCategoryTotal:
+        return "getCategoryTotal";
+    case MetricOperation::GetCategoryTotals:
+        return "getCategoryTotals";
+    case MetricOperation::GetMonthlyTotals:
+        return "getMonthlyTotals";
+    case MetricOperation::GetChangesSince:
+        return "getChangesSince";
+    case MetricOperation::ImportFile:
+        return "importFile";
+    case MetricOperation::ExportTransactions:
+        return "exportTransactions";
+    case MetricOperation::SearchTransactions:
+        return "searchTransactions";
+    case MetricOperation::SuggestDescriptions:
+        return "suggestDescriptions";
+    case MetricOperation::QueryTransactions:
+        return "queryTransactions";
+    case MetricOperation::GetReportBundle:
+        return "getReportBundle";
+    case MetricOperation::GetBudgetVariance:
+        return "getBudgetVariance";
+    case MetricOperation::GetTopTransactions:
+        return "getTopTransactions";
+    case MetricOperation::GetAmountStatistics:
+        return "getAmountStatistics";
+    case MetricOperation::GetTimeSeries:
+        return "getTimeSeries";
+    case MetricOperation::FindRecurringTransactions:
+        return "findRecurringTransactions";
+    case MetricOperation::GetCategoryRollups:
+        return "getCategoryRollups";
+    case MetricOperation::SerializeResult:
+        return "serializeResult";
+    default:
+        return "unknown";
+    }
+}
+
+const char *Metrics::counterName(MetricCounter counter)
+{
+    switch (counter)
+    {
+    case MetricCounter::RowsScanned:
+        return "rowsScanned";
+    case MetricCounter::RowsReturned:
+        return "rowsReturned";
+    case MetricCounter::BytesSerialized:
+        return "bytesSerialized";
+    case MetricCounter::BytesWritten:
+        return "bytesWritten";
+    case MetricCounter::BytesRead:
+        return "bytesRead";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,85 @@
+#include "../include/PostingIndex.h"
+#include <algorithm>
+
+void PostingIndex::add(int key, int id)
+{
+    std::vector<int> &ids = postings[key];
+    if (ids.empty() || ids.back() < id)
+    {
+        ids.push_back(id);
+        return;
+    }
+
+    auto position = std::lower_bound(ids.begin(), ids.end(), id);
+    if (*position != id)
+    {
+        ids.insert(position, id);
+    }
+}
+
+void PostingIndex::remove(int key, int id)
+{
+    auto entry = postings.find(key);
+    if (entry == postings.end())
+    {
+        return;
+    }
+
+    std::vector<int> &ids = entry->second;
+    auto position = std::lower_bound(ids.begin(), ids.end(), id);
+    if (position != ids.end() && *position == id)
+    {
+        ids.erase(position);
+    }
+    if (ids.empty())
+    {
+        postings.erase(entry);
+    }
+}
+
+const std::vector<int> *PostingIndex::find(int key) const
+{
+    auto entry = postings.find(key);
+    return entry != postings.end() ? &entry->second : nullptr;
+}
+
+size_t PostingIndex::count(int key) const
+{
+    auto entry = postings.find(key);
+    return entry != postings.end() ? entry->second.size() : 0;
+}
+
+size_t PostingIndex::findRange(int first, int last, std::vector<const std::vector<int> *> &lists) const
+{
+    size_t total = 0;
+    for (auto entry = postings.lower_bound(first); entry != postings.end() && entry->first <= last; ++entry)
+    {
+        lists.push_back(&entry->second);
+        total += entry->second.size();
+    }
+    return total;
+}
+
+void PostingIndex::clear()
+{
+    postings.clear();
+}
+
+void PostingIndex::shrinkToFit()
+{
+    for (auto &entry : postings)
+    {
+        entry.second.shrink_to_fit();
+    }
+}
+
+size_t PostingIndex::getMemoryUsage() const
+{
+    // Red-black tree node: three links and a color, then the key and list
+    size_t bytes = postings.size() * (4 * sizeof(void *) + sizeof(std::pair<const int, std::vector<int>>));
+    for (const auto &entry : postings)
+    {
+        bytes += entry.second.capacity() * sizeof(int);
+    }
+    return bytes;
+}
@@ -0,0 +1,214 @@
+#include "../include/RecurringDetector.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include "../include/DailyLedger.h"
+
+// Accepted gaps of each period: the median gap must lie in [minGap, maxGap],
+// and a gap is regular when it is within slack days of the expected length
+struct PeriodRule
+{
+    RecurrencePeriod period;
+    double minGap;
+    double maxGap;
+    double expected;
+    double slack;
+};
+
+static const PeriodRule kPeriodRules[] = {
+    {RecurrencePeriod::Weekly, 5.0, 9.0, 7.0, 2.0},
+    {RecurrencePeriod::Monthly, 25.0, 36.0, 30.44, 5.0},
+    {RecurrencePeriod::Yearly, 350.0, 380.0, 365.25, 15.0},
+};
+
+const char *recurrencePeriodName(RecurrencePeriod period)
+{
+    switch (period)
+    {
+    case RecurrencePeriod::Weekly:
+        return "weekly";
+    case RecurrencePeriod::Yearly:
+        return "yearly";
+    default:
+        return "monthly";
+    }
+}
+
+std::string RecurringDetector::seriesKey(const std::string &description)
+{
+    std::string key;
+    key.reserve(description.size());
+    size_t wordStart = 0;
+    bool inWord = false;
+    bool hasDigit = false;
+    auto endWord = [&]()
+    {
+        if (inWord && hasDigit)
+        {
+            key.resize(wordStart);
+        }
+        inWord = false;
+        hasDigit = false;
+    };
+
+    for (char c : description)
+    {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (!std::isalnum(byte))
+        {
+            endWord();
+            continue;
+        }
+        if (!inWord)
+        {
+            // Remember where the word starts, before its separating space, so a dropped word leaves no trace
+            wordStart = key.size();
+            if (!key.empty())
+            {
+                key += ' ';
+            }
+            inWord = true;
+        }
+        hasDigit = hasDigit || std::isdigit(byte);
+        key += static_cast<char>(std::tolower(byte));
+    }
+    endWord();
+    return key;
+}
+
+uint64_t RecurringDetector::groupHash(const std::string &key, bool isIncome)
+{
+    // 64-bit FNV-1a, as for DuplicateIndex fingerprints
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : key)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    hash ^= isIncome ? 1 : 2;
+    hash *= 1099511628211ULL;
+    return hash;
+}
+
+void RecurringDetector::detect(std::vector<RecurringOccurrence> &occurrences, double amountTolerance, size_t minOccurrences,
+                               std::vector<RecurringSeries> &series, std::vector<std::vector<size_t>> &slots)
+{
+    // A single occurrence has no interval to judge
+    minOccurrences = std::max<size_t>(minOccurrences, 2);
+    if (occurrences.size() < minOccurrences)
+    {
+        return;
+    }
+
+    std::sort(occurrences.begin(), occurrences.end(), [](const RecurringOccurrence &a, const RecurringOccurrence &b)
+              { return a.amount != b.amount ? a.amount < b.amount : a.slot < b.slot; });
+
+    std::vector<RecurringOccurrence> band;
+    for (size_t begin = 0; begin < occurrences.size();)
+    {
+        double limit = occurrences[begin].amount + std::fabs(occurrences[begin].amount) * amountTolerance;
+        size_t end = begin + 1;
+        while (end < occurrences.size() && occurrences[end].amount <= limit)
+        {
+            end++;
+        }
+
+        if (end - begin >= minOccurrences)
+        {
+            band.assign(occurrences.begin() + begin, occurrences.begin() + end);
+            std::sort(band.begin(), band.end(), [](const RecurringOccurrence &a, const RecurringOccurrence &b)
+                      { return a.day != b.day ? a.day < b.day : a.slot < b.slot; });
+
+            RecurringSeries found;
+            if (analyzeBand(band, found))
+            {
+                std::vector<size_t> bandSlots;
+                bandSlots.reserve(band.size());
+                for (const auto &occurrence : band)
+                {
+                    bandSlots.push_back(occurrence.slot);
+                }
+                series.push_back(std::move(found));
+                slots.push_back(std::move(bandSlots));
+            }
+        }
+        begin = end;
+    }
+}
+
+bool RecurringDetector::analyzeBand(const std::vector<RecurringOccurrence> &band, RecurringSeries &series)
+{
+    std::vector<double> gaps;
+    gaps.reserve(band.size() - 1);
+    for (size_t i = 1; i < band.size(); i++)
+    {
+        gaps.push_back(band[i].day - band[i - 1].day);
+    }
+
+    std::vector<double> ordered = gaps;
+    std::nth_element(ordered.begin(), ordered.begin() + ordered.size() / 2, ordered.end());
+    double medianGap = ordered[ordered.size() / 2];
+
+    const PeriodRule *rule = nullptr;
+    for (const auto &candidate : kPeriodRules)
+    {
+        if (medianGap >= candidate.minGap && medianGap <= candidate.maxGap)
+        {
+            rule = &candidate;
+            break;
+        }
+    }
+    if (!rule)
+    {
+        return false;
+    }
+
+    size_t regular = 0;
+    double sum = 0.0;
+    for (double gap : gaps)
+    {
+        regular += std::fabs(gap - rule->expected) <= rule->slack ? 1 : 0;
+        sum += gap;
+    }
+    double regularity = static_cast<double>(regular) / gaps.size();
+    if (regularity < kMinRegularity)
+    {
+        return false;
+    }
+
+    double mean = sum / gaps.size();
+    double squares = 0.0;
+    for (double gap : gaps)
+    {
+        squares += (gap - mean) * (gap - mean);
+    }
+
+    std::vector<double> amounts;
+    amounts.reserve(band.size());
+    for (const auto &occurrence : band)
+    {
+        amounts.push_back(occurrence.amount);
+    }
+    std::nth_element(amounts.begin(), amounts.begin() + amounts.size() / 2, amounts.end());
+
+    int last = band.back().day;
+    int next = last + 7;
+    if (rule->period == RecurrencePeriod::Monthly)
+    {
+        next = DailyLedger::addMonths(last, 1);
+    }
+    else if (rule->period == RecurrencePeriod::Yearly)
+    {
+        next = DailyLedger::addMonths(last, 12);
+    }
+
+    series.period = rule->period;
+    series.amount = amounts[amounts.size() / 2];
+    series.meanInterval = mean;
+    series.intervalDeviation = std::sqrt(squares / gaps.size());
+    series.regularity = regularity;
+    series.firstDate = DailyLedger::fromDayNumber(band.front().day);
+    series.lastDate = DailyLedger::fromDayNumber(last);
+    series.nextDate = DailyLedger::fromDayNumber(next);
+    return true;
+}
@@ -0,0 +1,417 @@
+#include "../include/RoaringBitmap.h"
+#include <algorithm>
+#include <iterator>
+
+static int popcount(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return static_cast<int>((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+static bool testBit(const std::vector<uint64_t> &bits, uint16_t value)
+{
+    return (bits[value >> 6] >> (value & 63)) & 1;
+}
+
+void RoaringBitmap::add(uint32_t value)
+{
+    Container &container = containerFor(static_cast<uint16_t>(value >> 16));
+    auto low = static_cast<uint16_t>(value);
+    if (container.isBitmap())
+    {
+        uint64_t mask = 1ULL << (low & 63);
+        container.count += (container.bits[low >> 6] & mask) ? 0 : 1;
+        container.bits[low >> 6] |= mask;
+        return;
+    }
+
+    auto position = std::lower_bound(container.array.begin(), container.array.end(), low);
+    if (position == container.array.end() || *position != low)
+    {
+        container.array.insert(position, low);
+        container.count++;
+        toBitmapIfFull(container);
+    }
+}
+
+void RoaringBitmap::addSorted(const std::vector<int> &values)
+{
+    for (int value : values)
+    {
+        auto key = static_cast<uint16_t>(static_cast<uint32_t>(value) >> 16);
+        auto low = static_cast<uint16_t>(value);
+
+        // Ascending input only ever extends the last container or opens a new one
+        if (!keys.empty() && keys.back() == key && !containers.back().isBitmap() &&
+            (containers.back().array.empty() || containers.back().array.back() < low))
+        {
+            Container &container = containers.back();
+            container.array.push_back(low);
+            container.count++;
+            toBitmapIfFull(container);
+        }
+        else
+        {
+            add(static_cast<uint32_t>(value));
+        }
+    }
+}
+
+void RoaringBitmap::remove(uint32_t value)
+{
+    auto key = static_cast<uint16_t>(value >> 16);
+    auto slot = std::lower_bound(keys.begin(), keys.end(), key);
+    if (slot == keys.end() || *slot != key)
+    {
+        return;
+    }
+
+    size_t index = static_cast<size_t>(slot - keys.begin());
+    Container &container = containers[index];
+    auto low = static_cast<uint16_t>(value);
+    if (container.isBitmap())
+    {
+        uint64_t mask = 1ULL << (low & 63);
+        if (container.bits[low >> 6] & mask)
+        {
+            container.bits[low >> 6] &= ~mask;
+            container.count--;
+            toArrayIfSparse(container);
+        }
+    }
+    else
+    {
+        auto position = std::lower_bound(container.array.begin(), container.array.end(), low);
+        if (position != container.array.end() && *position == low)
+        {
+            container.array.erase(position);
+            container.count--;
+        }
+    }
+
+    if (container.count == 0)
+    {
+        keys.erase(keys.begin() + index);
+        containers.erase(containers.begin() + index);
+    }
+}
+
+bool RoaringBitmap::contains(uint32_t value) const
+{
+    auto key = static_cast<uint16_t>(value >> 16);
+    auto slot = std::lower_bound(keys.begin(), keys.end(), key);
+    if (slot == keys.end() || *slot != key)
+    {
+        return false;
+    }
+
+    const Container &container = containers[slot - keys.begin()];
+    auto low = static_cast<uint16_t>(value);
+    return container.isBitmap() ? testBit(container.bits, low)
+                                : std::binary_search(container.array.begin(), container.array.end(), low);
+}
+
+size_t RoaringBitmap::cardinality() const
+{
+    size_t total = 0;
+    for (const auto &container : containers)
+    {
+        total += container.count;
+    }
+    return total;
+}
+
+bool RoaringBitmap::empty() const
+{
+    return keys.empty();
+}
+
+void RoaringBitmap::intersectWith(const RoaringBitmap &other)
+{
+    size_t kept = 0;
+    size_t j = 0;
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        while (j < other.keys.size() && other.keys[j] < keys[i])
+        {
+            j++;
+        }
+        if (j == other.keys.size() || other.keys[j] != keys[i])
+        {
+            continue;
+        }
+
+        Container &mine = containers[i];
+        const Container &theirs = other.containers[j];
+        if (mine.isBitmap() && theirs.isBitmap())
+        {
+            mine.count = 0;
+            for (size_t w = 0; w < kBitmapWords; w++)
+            {
+                mine.bits[w] &= theirs.bits[w];
+                mine.count += popcount(mine.bits[w]);
+            }
+            toArrayIfSparse(mine);
+        }
+        else if (mine.isBitmap())
+        {
+            // The result can hold no more values than the array side
+            std::vector<uint16_t> values;
+            for (uint16_t value : theirs.array)
+            {
+                if (testBit(mine.bits, value))
+                {
+                    values.push_back(value);
+                }
+            }
+            mine.bits.clear();
+            mine.array = std::move(values);
+            mine.count = static_cast<uint32_t>(mine.array.size());
+        }
+        else
+        {
+            auto end = theirs.isBitmap()
+                           ? std::remove_if(mine.array.begin(), mine.array.end(), [&](uint16_t value)
+                                            { return !testBit(theirs.bits, value); })
+                           : std::set_intersection(mine.array.begin(), mine.array.end(), theirs.array.begin(),
+                                                   theirs.array.end(), mine.array.begin());
+            mine.array.erase(end, mine.array.end());
+            mine.count = static_cast<uint32_t>(mine.array.size());
+        }
+
+        if (mine.count != 0)
+        {
+            if (kept != i)
+            {
+                keys[kept] = keys[i];
+                containers[kept] = std::move(mine);
+            }
+            kept++;
+        }
+    }
+    keys.resize(kept);
+    containers.resize(kept);
+}
+
+void RoaringBitmap::unionWith(const RoaringBitmap &other)
+{
+    for (size_t j = 0; j < other.keys.size(); j++)
+    {
+        const Container &theirs = other.containers[j];
+        Container &mine = containerFor(other.keys[j]);
+        if (!mine.isBitmap() && !theirs.isBitmap())
+        {
+            std::vector<uint16_t> merged;
+            merged.reserve(mine.array.size() + theirs.array.size());
+            std::set_union(mine.array.begin(), mine.array.end(), theirs.array.begin(), theirs.array.end(),
+                           std::back_inserter(merged));
+            mine.array = std::move(merged);
+            mine.count = static_cast<uint32_t>(mine.array.size());
+            toBitmapIfFull(mine);
+            continue;
+        }
+
+        if (!mine.isBitmap())
+        {
+            mine.bits.assign(kBitmapWords, 0);
+            for (uint16_t value : mine.array)
+            {
+                mine.bits[value >> 6] |= 1ULL << (value & 63);
+            }
+            mine.array.clear();
+            mine.array.shrink_to_fit();
+        }
+        if (theirs.isBitmap())
+        {
+            for (size_t w = 0; w < kBitmapWords; w++)
+            {
+                mine.bits[w] |= theirs.bits[w];
+            }
+        }
+        else
+        {
+            for (uint16_t value : theirs.array)
+            {
+                mine.bits[value >> 6] |= 1ULL << (value & 63);
+            }
+        }
+        mine.count = 0;
+        for (uint64_t word : mine.bits)
+        {
+            mine.count += popcount(word);
+        }
+    }
+}
+
+void RoaringBitmap::subtract(const RoaringBitmap &other)
+{
+    size_t kept = 0;
+    size_t j = 0;
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        while (j < other.keys.size() && other.keys[j] < keys[i])
+        {
+            j++;
+        }
+
+        Container &mine = containers[i];
+        if (j < other.keys.size() && other.keys[j] == keys[i])
+        {
+            const Container &theirs = other.containers[j];
+            if (mine.isBitmap())
+            {
+                if (theirs.isBitmap())
+                {
+                    for (size_t w = 0; w < kBitmapWords; w++)
+                    {
+                        mine.bits[w] &= ~theirs.bits[w];
+                    }
+                }
+                else
+                {
+                    for (uint16_t value : theirs.array)
+                    {
+                        mine.bits[value >> 6] &= ~(1ULL << (value & 63));
+                    }
+                }
+                mine.count = 0;
+                for (uint64_t word : mine.bits)
+                {
+                    mine.count += popcount(word);
+                }
+                toArrayIfSparse(mine);
+            }
+            else
+            {
+                auto end = theirs.isBitmap()
+                               ? std::remove_if(mine.array.begin(), mine.array.end(), [&](uint16_t value)
+                                                { return testBit(theirs.bits, value); })
+                               : std::set_difference(mine.array.begin(), mine.array.end(), theirs.array.begin(),
+                                                     theirs.array.end(), mine.array.begin());
+                mine.array.erase(end, mine.array.end());
+                mine.count = static_cast<uint32_t>(mine.array.size());
+            }
+        }
+
+        if (mine.count != 0)
+        {
+            if (kept != i)
+            {
+                keys[kept] = keys[i];
+                containers[kept] = std::move(mine);
+            }
+            kept++;
+        }
+    }
+    keys.resize(kept);
+    containers.resize(kept);
+}
+
+void RoaringBitmap::toVector(std::vector<int> &values) const
+{
+    values.clear();
+    values.reserve(cardinality());
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        int high = static_cast<int>(keys[i]) << 16;
+        const Container &container = containers[i];
+        if (!container.isBitmap())
+        {
+            for (uint16_t value : container.array)
+            {
+                values.push_back(high | value);
+            }
+            continue;
+        }
+
+        for (size_t w = 0; w < kBitmapWords; w++)
+        {
+            // Visit only the set bits, lowest first
+            for (uint64_t word = container.bits[w]; word != 0; word &= word - 1)
+            {
+                values.push_back(high | static_cast<int>(w * 64 + popcount((word & (~word + 1)) - 1)));
+            }
+        }
+    }
+}
+
+void RoaringBitmap::clear()
+{
+    keys.clear();
+    containers.clear();
+}
+
+void RoaringBitmap::shrinkToFit()
+{
+    keys.shrink_to_fit();
+    containers.shrink_to_fit();
+    for (auto &container : containers)
+    {
+        container.array.shrink_to_fit();
+    }
+}
+
+size_t RoaringBitmap::getMemoryUsage() const
+{
+    size_t bytes = keys.capacity() * sizeof(uint16_t) + containers.capacity() * sizeof(Container);
+    for (const auto &container : containers)
+    {
+        bytes += container.array.capacity() * sizeof(uint16_t) + container.bits.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+void RoaringBitmap::toBitmapIfFull(Container &container)
+{
+    if (container.isBitmap() || container.array.size() <= kArrayLimit)
+    {
+        return;
+    }
+
+    container.bits.assign(kBitmapWords, 0);
+    for (uint16_t value : container.array)
+    {
+        container.bits[value >> 6] |= 1ULL << (value & 63);
+    }
+    container.array.clear();
+    container.array.shrink_to_fit();
+}
+
+void RoaringBitmap::toArrayIfSparse(Container &container)
+{
+    if (!container.isBitmap() || container.count > kArrayLimit)
+    {
+        return;
+    }
+
+    std::vector<uint16_t> values;
+    values.reserve(container.count);
+    for (size_t w = 0; w < kBitmapWords; w++)
+    {
+        for (uint64_t word = container.bits[w]; word != 0; word &= word - 1)
+        {
+            values.push_back(static_cast<uint16_t>(w * 64 + popcount((word & (~word + 1)) - 1)));
+        }
+    }
+    container.array = std::move(values);
+    container.bits.clear();
+    container.bits.shrink_to_fit();
+}
+
+RoaringBitmap::Container &RoaringBitmap::containerFor(uint16_t key)
+{
+    auto slot = std::lower_bound(keys.begin(), keys.end(), key);
+    size_t index = static_cast<size_t>(slot - keys.begin());
+    if (slot == keys.end() || *slot != key)
+    {
+        keys.insert(slot, key);
+        containers.insert(containers.begin() + index, Container{{}, {}, 0});
+    }
+    return containers[index];
+}
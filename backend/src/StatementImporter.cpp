@@ -0,0 +1,865 @@
+#include "../include/StatementImporter.h"
+#include "../include/ThreadPool.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+// Entries per parallel parse task
+static const size_t kImportGrainSize = 4096;
+
+static std::string trim(const std::string &text)
+{
+    size_t begin = 0;
+    size_t end = text.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(text[begin])))
+    {
+        begin++;
+    }
+    while (end > begin && std::isspace(static_cast<unsigned char>(text[end - 1])))
+    {
+        end--;
+    }
+    return text.substr(begin, end - begin);
+}
+
+static std::string toLower(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c)
+                   { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+static bool isLeapYear(int year)
+{
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+static int daysInMonth(int year, int month)
+{
+    static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return month == 2 && isLeapYear(year) ? 29 : days[month - 1];
+}
+
+// Splits a date into three numeric fields separated by '-', '/', '.', ' ' or the QIF apostrophe;
+// separator receives the first separator other than the apostrophe. A space only separates
+// fields when nothing else does; before a field it is padding, as in Quicken's "1/ 2' 5"
+static bool splitDateFields(const std::string &value, std::vector<std::string> &parts, char &separator, bool &apostrophe)
+{
+    parts.clear();
+    separator = 0;
+    apostrophe = false;
+    bool spaceSeparates = value.find_first_of("-/.'") == std::string::npos;
+    std::string part;
+    bool digitSeen = false;
+    for (char c : value)
+    {
+        if (std::isdigit(static_cast<unsigned char>(c)))
+        {
+            part += c;
+            digitSeen = true;
+        }
+        else if (c == ' ' && (!digitSeen || !spaceSeparates))
+        {
+            if (digitSeen)
+            {
+                return false; // Padding only comes before a field's digits
+            }
+            part += '0'; // Keeps the field's width, so a padded two-digit year stays two digits
+        }
+        else if (c == '-' || c == '/' || c == '.' || c == ' ' || c == '\'')
+        {
+            if (part.empty())
+            {
+                return false;
+            }
+            parts.push_back(part);
+            part.clear();
+            digitSeen = false;
+            if (c == '\'')
+            {
+                apostrophe = true;
+            }
+            else if (separator == 0)
+            {
+                separator = c;
+            }
+        }
+        else
+        {
+            return false;
+        }
+    }
+    parts.push_back(part);
+    return parts.size() == 3 && !parts[2].empty();
+}
+
+// Whether a date has the year last in a form whose field order depends on the file
+static bool isYearLast(const std::vector<std::string> &parts, char separator)
+{
+    return parts[0].size() != 4 && (parts[2].size() == 4 || parts[2].size() == 2) && separator != '.';
+}
+
+// Splits one CSV record into fields, honouring quotes and doubled quote escapes
+static void splitCsvFields(const std::string &text, size_t begin, size_t end, char delimiter, std::vector<std::string> &fields)
+{
+    fields.clear();
+    std::string field;
+    bool quoted = false;
+    for (size_t i = begin; i < end; i++)
+    {
+        char c = text[i];
+        if (quoted)
+        {
+            if (c == '"' && i + 1 < end && text[i + 1] == '"')
+            {
+                field += '"';
+                i++;
+            }
+            else if (c == '"')
+            {
+                quoted = false;
+            }
+            else
+            {
+                field += c;
+            }
+        }
+        else if (c == '"')
+        {
+            quoted = true;
+        }
+        else if (c == delimiter)
+        {
+            fields.push_back(trim(field));
+            field.clear();
+        }
+        else
+        {
+            field += c;
+        }
+    }
+    fields.push_back(trim(field));
+}
+
+// Gets the text following <tag> in an OFX entry, up to the next tag or line break
+static std::string ofxValue(const std::string &text, size_t begin, size_t end, const std::string &tag)
+{
+    size_t position = text.find("<" + tag + ">", begin);
+    if (position == std::string::npos || position >= end)
+    {
+        return "";
+    }
+
+    position += tag.size() + 2;
+    size_t valueEnd = position;
+    while (valueEnd < end && text[valueEnd] != '<' && text[valueEnd] != '\n' && text[valueEnd] != '\r')
+    {
+        valueEnd++;
+    }
+
+    std::string value = trim(text.substr(position, valueEnd - position));
+    static const std::pair<const char *, const char *> entities[] = {{"&lt;", "<"}, {"&gt;", ">"}, {"&quot;", "\""}, {"&apos;", "'"}, {"&amp;", "&"}};
+    for (const auto &entity : entities)
+    {
+        size_t found;
+        while ((found = value.find(entity.first)) != std::string::npos)
+        {
+            value.replace(found, std::string(entity.first).size(), entity.second);
+        }
+    }
+    return value;
+}
+
+// Gets the value of the first line of a QIF record that starts with the given field code
+static std::string qifValue(const std::string &text, size_t begin, size_t end, char code)
+{
+    size_t position = begin;
+    while (position < end)
+    {
+        size_t lineEnd = std::min(text.find('\n', position), end);
+        std::string content = trim(text.substr(position, lineEnd - position));
+        if (!content.empty() && content[0] == code)
+        {
+            return content.substr(1);
+        }
+        position = lineEnd + 1;
+    }
+    return "";
+}
+
+StatementImporter::StatementImporter(const std::vector<Category> &categories, DateOrder dateOrder) : dateOrder(dateOrder)
+{
+    for (const auto &category : categories)
+    {
+        categoryIds.emplace(toLower(trim(category.getName())), category.getId());
+    }
+}
+
+bool StatementImporter::parseFile(const std::string &filePath, ImportFormat format, ImportResult &result) const
+{
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    // One sequential read into a buffer sized from the file
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    std::string text(size > 0 ? static_cast<size_t>(size) : 0, '\0');
+    if (!text.empty() && !file.read(&text[0], size))
+    {
+        return false;
+    }
+
+    parse(text, format, result);
+    return true;
+}
+
+void StatementImporter::parse(const std::string &text, ImportFormat format, ImportResult &result) const
+{
+    result.transactions.clear();
+    result.lines.clear();
+    result.errors.clear();
+    result.duplicates.clear();
+
+    switch (format)
+    {
+    case ImportFormat::Csv:
+        parseCsv(text, result);
+        break;
+    case ImportFormat::Ofx:
+        parseOfx(text, result);
+        break;
+    case ImportFormat::Qif:
+        parseQif(text, result);
+        break;
+    }
+}
+
+bool StatementImporter::resolveFormat(const std::string &name, const std::string &filePath, ImportFormat &format)
+{
+    std::string key = toLower(trim(name));
+    if (key.empty())
+    {
+        size_t dot = filePath.find_last_of('.');
+        key = dot == std::string::npos ? "" : toLower(filePath.substr(dot + 1));
+    }
+
+    if (key == "csv")
+    {
+        format = ImportFormat::Csv;
+    }
+    else if (key == "ofx" || key == "qfx")
+    {
+        format = ImportFormat::Ofx;
+    }
+    else if (key == "qif")
+    {
+        format = ImportFormat::Qif;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+bool StatementImporter::normalizeDate(const std::string &text, std::string &isoDate, DateOrder order)
+{
+    std::string value = trim(text);
+    int year = 0, month = 0, day = 0;
+
+    size_t leadingDigits = 0;
+    while (leadingDigits < value.size() && std::isdigit(static_cast<unsigned char>(value[leadingDigits])))
+    {
+        leadingDigits++;
+    }
+
+    if (leadingDigits >= 8)
+    {
+        // YYYYMMDD, possibly followed by an OFX time and zone
+        year = std::atoi(value.substr(0, 4).c_str());
+        month = std::atoi(value.substr(4, 2).c_str());
+        day = std::atoi(value.substr(6, 2).c_str());
+    }
+    else
+    {
+        std::vector<std::string> parts;
+        char separator;
+        bool apostrophe;
+        if (!splitDateFields(value, parts, separator, apostrophe))
+        {
+            return false;
+        }
+
+        if (parts[0].size() == 4)
+        {
+            year = std::atoi(parts[0].c_str());
+            month = std::atoi(parts[1].c_str());
+            day = std::atoi(parts[2].c_str());
+        }
+        else if (parts[2].size() == 4 || parts[2].size() == 2)
+        {
+            year = std::atoi(parts[2].c_str());
+            if (parts[2].size() == 2)
+            {
+                // QIF marks 2000s years with an apostrophe; otherwise pivot at 70
+                year += apostrophe || year < 70 ? 2000 : 1900;
+            }
+
+            // DD.MM.YYYY is always day first
+            int first = std::atoi(parts[0].c_str());
+            int second = std::atoi(parts[1].c_str());
+            if (order == DateOrder::DayFirst || separator == '.')
+            {
+                day = first;
+                month = second;
+            }
+            else
+            {
+                month = first;
+                day = second;
+            }
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    if (year < 1 || year > 9999 || month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month))
+    {
+        return false;
+    }
+
+    // Sized for any three ints, so no field can be cut off
+    char buffer[36];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", year, month, day);
+    isoDate = buffer;
+    return true;
+}
+
+bool StatementImporter::detectDateOrder(const std::vector<std::string> &dates, DateOrder &order, std::string &error)
+{
+    size_t dayFirst = 0, monthFirst = 0, yearLast = 0;
+    std::vector<std::string> parts;
+    for (const auto &date : dates)
+    {
+        char separator;
+        bool apostrophe;
+        if (!splitDateFields(trim(date), parts, separator, apostrophe) || !isYearLast(parts, separator))
+        {
+            continue;
+        }
+        yearLast++;
+        dayFirst += std::atoi(parts[0].c_str()) > 12 ? 1 : 0;
+        monthFirst += std::atoi(parts[1].c_str()) > 12 ? 1 : 0;
+    }
+
+    if (dayFirst != 0 && monthFirst != 0)
+    {
+        error = "Dates mix day-first and month-first order (" + std::to_string(dayFirst) + " day-first, " +
+                std::to_string(monthFirst) + " month-first)";
+        return false;
+    }
+    if (yearLast != 0 && dayFirst == 0 && monthFirst == 0)
+    {
+        error = "Cannot tell whether dates are day-first or month-first; specify the date order";
+        return false;
+    }
+    order = dayFirst != 0 ? DateOrder::DayFirst : DateOrder::MonthFirst;
+    return true;
+}
+
+bool StatementImporter::parseAmount(const std::string &text, double &value)
+{
+    std::string digits;
+    bool negative = false;
+    bool hasDigit = false;
+    size_t lastDot = std::string::npos;
+    size_t lastComma = std::string::npos;
+
+    for (char c : text)
+    {
+        if (std::isdigit(static_cast<unsigned char>(c)))
+        {
+            digits += c;
+            hasDigit = true;
+        }
+        else if (c == '.')
+        {
+            lastDot = digits.size();
+            digits += c;
+        }
+        else if (c == ',')
+        {
+            lastComma = digits.size();
+            digits += c;
+        }
+        else if (c == '-' || c == '(')
+        {
+            negative = true;
+        }
+    }
+
+    if (!hasDigit)
+    {
+        return false;
+    }
+
+    // The separator that comes last is the decimal point; a lone comma followed
+    // by one or two digits ("12,50") is a decimal comma as well
+    char decimal = '.';
+    if (lastComma != std::string::npos &&
+        (lastDot == std::string::npos ? digits.size() - lastComma - 1 <= 2 : lastComma > lastDot))
+    {
+        decimal = ',';
+    }
+
+    std::string normalized;
+    for (char c : digits)
+    {
+        if (std::isdigit(static_cast<unsigned char>(c)))
+        {
+            normalized += c;
+        }
+        else if (c == decimal)
+        {
+            normalized += '.';
+        }
+    }
+
+    char *end = nullptr;
+    double parsed = std::strtod(normalized.c_str(), &end);
+    if (end == normalized.c_str() || *end != '\0' || !std::isfinite(parsed))
+    {
+        return false;
+    }
+
+    value = negative ? -parsed : parsed;
+    return true;
+}
+
+template <typename RawDate>
+bool StatementImporter::resolveDateOrder(const std::vector<Entry> &entries, RawDate rawDate, DateOrder &order, ImportResult &result) const
+{
+    order = dateOrder;
+    if (order != DateOrder::Detect)
+    {
+        return true;
+    }
+
+    std::vector<std::string> dates(entries.size());
+    ThreadPool::shared().parallelFor(entries.size(), kImportGrainSize, [&](size_t, size_t begin, size_t end)
+                                     {
+        for (size_t i = begin; i < end; i++)
+        {
+            dates[i] = rawDate(entries[i]);
+        } });
+
+    std::string error;
+    if (!detectDateOrder(dates, order, error))
+    {
+        result.errors.push_back({0, error});
+        return false;
+    }
+    return true;
+}
+
+template <typename ParseEntry>
+void StatementImporter::parseEntries(const std::vector<Entry> &entries, ParseEntry parseEntry, ImportResult &result) const
+{
+    struct Partial
+    {
+        std::vector<Transaction> transactions;
+        std::vector<size_t> lines;
+        std::vector<ImportError> errors;
+    };
+
+    std::vector<Partial> partials(ThreadPool::chunkCount(entries.size(), kImportGrainSize));
+    ThreadPool::shared().parallelFor(entries.size(), kImportGrainSize, [&](size_t chunk, size_t begin, size_t end)
+                                     {
+        Partial &partial = partials[chunk];
+        partial.transactions.reserve(end - begin);
+        for (size_t i = begin; i < end; i++)
+        {
+            Transaction transaction;
+            std::string error;
+            if (parseEntry(entries[i], transaction, error))
+            {
+                partial.transactions.push_back(std::move(transaction));
+                partial.lines.push_back(entries[i].line);
+            }
+            else
+            {
+                partial.errors.push_back({entries[i].line, error});
+            }
+        } });
+
+    size_t total = result.transactions.size();
+    for (const auto &partial : partials)
+    {
+        total += partial.transactions.size();
+    }
+    result.transactions.reserve(total);
+    result.lines.reserve(total);
+
+    for (auto &partial : partials)
+    {
+        std::move(partial.transactions.begin(), partial.transactions.end(), std::back_inserter(result.transactions));
+        result.lines.insert(result.lines.end(), partial.lines.begin(), partial.lines.end());
+        std::move(partial.errors.begin(), partial.errors.end(), std::back_inserter(result.errors));
+    }
+}
+
+void StatementImporter::parseCsv(const std::string &text, ImportResult &result) const
+{
+    // Split into records serially; quoted fields may span lines
+    std::vector<Entry> records;
+    size_t start = text.compare(0, 3, "\xEF\xBB\xBF") == 0 ? 3 : 0;
+    size_t line = 1;
+    size_t recordLine = 1;
+    bool quoted = false;
+    for (size_t i = start; i <= text.size(); i++)
+    {
+        if (i < text.size() && text[i] == '"')
+        {
+            quoted = !quoted;
+        }
+
+        if (i == text.size() || (text[i] == '\n' && !quoted))
+        {
+            size_t end = i;
+            if (end > start && text[end - 1] == '\r')
+            {
+                end--;
+            }
+            if (text.find_first_not_of(" \t", start) < end)
+            {
+                records.push_back({start, end, recordLine});
+            }
+            start = i + 1;
+            recordLine = line + 1;
+        }
+
+        if (i < text.size() && text[i] == '\n')
+        {
+            line++;
+        }
+    }
+
+    if (records.empty())
+    {
+        return;
+    }
+
+    // Detect the delimiter and map columns from the header
+    const Entry &header = records.front();
+    std::string headerText = text.substr(header.begin, header.end - header.begin);
+    CsvLayout layout = {',', -1, -1, -1, -1, -1, -1, -1, -1, -1};
+    size_t bestCount = std::count(headerText.begin(), headerText.end(), ',');
+    for (char candidate : {';', '\t'})
+    {
+        size_t count = std::count(headerText.begin(), headerText.end(), candidate);
+        if (count > bestCount)
+        {
+            bestCount = count;
+            layout.delimiter = candidate;
+        }
+    }
+
+    std::vector<std::string> columns;
+    splitCsvFields(text, header.begin, header.end, layout.delimiter, columns);
+    for (size_t i = 0; i < columns.size(); i++)
+    {
+        std::string name = toLower(columns[i]);
+        int index = static_cast<int>(i);
+        auto assign = [&](int &column, std::initializer_list<const char *> names)
+        {
+            if (column < 0 && std::find(names.begin(), names.end(), name) != names.end())
+            {
+                column = index;
+            }
+        };
+        assign(layout.date, {"date", "transaction date", "posted date", "posting date", "booking date"});
+        assign(layout.amount, {"amount", "value", "transaction amount"});
+        assign(layout.debit, {"debit", "withdrawal", "withdrawals", "debit amount", "money out"});
+        assign(layout.credit, {"credit", "deposit", "deposits", "credit amount", "money in"});
+        assign(layout.type, {"type", "transaction type", "dr/cr", "credit/debit"});
+        assign(layout.description, {"description", "payee", "name", "details", "narrative", "merchant"});
+        assign(layout.memo, {"memo", "notes", "reference"});
+        assign(layout.category, {"category", "category name"});
+        assign(layout.categoryId, {"categoryid", "category id", "category_id"});
+    }
+
+    if (layout.date < 0 || (layout.amount < 0 && layout.debit < 0 && layout.credit < 0))
+    {
+        result.errors.push_back({header.line, "Header must name a date column and an amount, debit or credit column"});
+        return;
+    }
+
+    std::vector<Entry> rows(records.begin() + 1, records.end());
+    DateOrder order;
+    if (!resolveDateOrder(rows, [&](const Entry &entry)
+                          {
+            thread_local std::vector<std::string> fields;
+            splitCsvFields(text, entry.begin, entry.end, layout.delimiter, fields);
+            return static_cast<size_t>(layout.date) < fields.size() ? fields[layout.date] : std::string(); }, order, result))
+    {
+        return;
+    }
+
+    parseEntries(rows, [&](const Entry &entry, Transaction &transaction, std::string &error)
+                 {
+        thread_local std::vector<std::string> fields;
+        splitCsvFields(text, entry.begin, entry.end, layout.delimiter, fields);
+        auto field = [&](int column) -> const std::string &
+        {
+            static const std::string empty;
+            return column >= 0 && static_cast<size_t>(column) < fields.size() ? fields[column] : empty;
+        };
+
+        std::string date;
+        if (!normalizeDate(field(layout.date), date, order))
+        {
+            error = "Invalid date '" + field(layout.date) + "'";
+            return false;
+        }
+
+        double amount = 0.0;
+        if (!field(layout.amount).empty())
+        {
+            if (!parseAmount(field(layout.amount), amount))
+            {
+                error = "Invalid amount '" + field(layout.amount) + "'";
+                return false;
+            }
+        }
+        else if (!field(layout.credit).empty() || !field(layout.debit).empty())
+        {
+            bool credit = !field(layout.credit).empty();
+            const std::string &raw = credit ? field(layout.credit) : field(layout.debit);
+            if (!parseAmount(raw, amount))
+            {
+                error = "Invalid amount '" + raw + "'";
+                return false;
+            }
+            amount = credit ? std::fabs(amount) : -std::fabs(amount);
+        }
+        else
+        {
+            error = "Missing amount";
+            return false;
+        }
+
+        bool isIncome = amount > 0.0;
+        std::string type = toLower(field(layout.type));
+        if (type == "income" || type == "credit" || type == "cr" || type == "c" || type == "deposit")
+        {
+            isIncome = true;
+        }
+        else if (type == "expense" || type == "debit" || type == "dr" || type == "d" || type == "withdrawal" || type == "payment")
+        {
+            isIncome = false;
+        }
+
+        std::string description = field(layout.description);
+        if (description.empty())
+        {
+            description = field(layout.memo);
+        }
+
+        int categoryId = 0;
+        if (!field(layout.categoryId).empty())
+        {
+            categoryId = std::atoi(field(layout.categoryId).c_str());
+        }
+        else if (!field(layout.category).empty())
+        {
+            categoryId = findCategory(field(layout.category));
+        }
+
+        transaction = Transaction(0, date, std::fabs(amount), description, categoryId, isIncome);
+        return true; }, result);
+}
+
+void StatementImporter::parseOfx(const std::string &text, ImportResult &result) const
+{
+    // Each <STMTTRN> aggregate is one entry; closing tags are optional in OFX 1.x
+    std::vector<Entry> entries;
+    const std::string openTag = "<STMTTRN>";
+    size_t line = 1;
+    size_t counted = 0;
+    size_t position = text.find(openTag);
+    while (position != std::string::npos)
+    {
+        line += std::count(text.begin() + counted, text.begin() + position, '\n');
+        counted = position;
+
+        size_t begin = position + openTag.size();
+        size_t next = text.find(openTag, begin);
+        size_t end = std::min(next, text.find("</STMTTRN>", begin));
+        entries.push_back({begin, end == std::string::npos ? text.size() : end, line});
+        position = next;
+    }
+
+    DateOrder order;
+    if (!resolveDateOrder(entries, [&](const Entry &entry)
+                          { return ofxValue(text, entry.begin, entry.end, "DTPOSTED"); }, order, result))
+    {
+        return;
+    }
+
+    parseEntries(entries, [&](const Entry &entry, Transaction &transaction, std::string &error)
+                 {
+        std::string rawDate = ofxValue(text, entry.begin, entry.end, "DTPOSTED");
+        std::string date;
+        if (!normalizeDate(rawDate, date, order))
+        {
+            error = "Invalid date '" + rawDate + "'";
+            return false;
+        }
+
+        std::string rawAmount = ofxValue(text, entry.begin, entry.end, "TRNAMT");
+        double amount = 0.0;
+        if (!parseAmount(rawAmount, amount))
+        {
+            error = "Invalid amount '" + rawAmount + "'";
+            return false;
+        }
+
+        std::string description = ofxValue(text, entry.begin, entry.end, "NAME");
+        if (description.empty())
+        {
+            description = ofxValue(text, entry.begin, entry.end, "MEMO");
+        }
+
+        transaction = Transaction(0, date, std::fabs(amount), description, 0, amount > 0.0);
+        return true; }, result);
+}
+
+void StatementImporter::parseQif(const std::string &text, ImportResult &result) const
+{
+    // Records are groups of lines terminated by a line holding only '^'
+    std::vector<Entry> entries;
+    size_t line = 1;
+    size_t start = 0;
+    size_t recordStart = std::string::npos;
+    size_t recordLine = 1;
+    while (start < text.size())
+    {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos)
+        {
+            end = text.size();
+        }
+
+        std::string content = trim(text.substr(start, end - start));
+        if (content == "^")
+        {
+            if (recordStart != std::string::npos)
+            {
+                entries.push_back({recordStart, start, recordLine});
+            }
+            recordStart = std::string::npos;
+        }
+        else if (!content.empty() && content[0] != '!' && recordStart == std::string::npos)
+        {
+            recordStart = start;
+            recordLine = line;
+        }
+
+        start = end + 1;
+        line++;
+    }
+    if (recordStart != std::string::npos)
+    {
+        entries.push_back({recordStart, text.size(), recordLine});
+    }
+
+    DateOrder order;
+    if (!resolveDateOrder(entries, [&](const Entry &entry)
+                          { return qifValue(text, entry.begin, entry.end, 'D'); }, order, result))
+    {
+        return;
+    }
+
+    parseEntries(entries, [&](const Entry &entry, Transaction &transaction, std::string &error)
+                 {
+        std::string rawDate, rawAmount, payee, memo, category;
+        size_t position = entry.begin;
+        while (position < entry.end)
+        {
+            size_t end = std::min(text.find('\n', position), entry.end);
+            std::string content = trim(text.substr(position, end - position));
+            if (!content.empty())
+            {
+                std::string value = content.substr(1);
+                switch (content[0])
+                {
+                case 'D':
+                    rawDate = value;
+                    break;
+                case 'T':
+                    rawAmount = value;
+                    break;
+                case 'U':
+                    if (rawAmount.empty())
+                    {
+                        rawAmount = value;
+                    }
+                    break;
+                case 'P':
+                    payee = value;
+                    break;
+                case 'M':
+                    memo = value;
+                    break;
+                case 'L':
+                    category = value;
+                    break;
+                }
+            }
+            position = end + 1;
+        }
+
+        std::string date;
+        if (!normalizeDate(rawDate, date, order))
+        {
+            error = "Invalid date '" + rawDate + "'";
+            return false;
+        }
+
+        double amount = 0.0;
+        if (!parseAmount(rawAmount, amount))
+        {
+            error = "Invalid amount '" + rawAmount + "'";
+            return false;
+        }
+
+        // "Category:Subcategory" falls back to the parent; "[Account]" marks a transfer
+        int categoryId = 0;
+        if (!category.empty() && category[0] != '[')
+        {
+            categoryId = findCategory(category);
+            if (categoryId == 0 && category.find(':') != std::string::npos)
+            {
+                categoryId = findCategory(category.substr(0, category.find(':')));
+            }
+        }
+
+        transaction = Transaction(0, date, std::fabs(amount), payee.empty() ? memo : payee, categoryId, amount > 0.0);
+        return true; }, result);
+}
+
+int StatementImporter::findCategory(const std::string &name) const
+{
+    auto it = categoryIds.find(toLower(trim(name)));
+    return it == categoryIds.end() ? 0 : it->second;
+}
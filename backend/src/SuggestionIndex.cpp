@@ -0,0 +1,588 @@
+#include "../include/SuggestionIndex.h"
+#include <algorithm>
+#include <cmath>
+#include "../include/DailyLedger.h"
+#include "../include/MemoryUsage.h"
+
+// Day number of 2000-01-01, the point where a use weighs exactly 1
+static const int kEpochDay = 10957;
+
+// Keeps weights well inside the range of a double
+static const double kMaxHalfLives = 1000.0;
+
+static bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+const size_t SuggestionIndex::kCachedSuggestions;
+const int SuggestionIndex::kHalfLifeDays;
+
+SuggestionIndex::SuggestionIndex()
+{
+    nodes.push_back({0, 0, -1, -1, {}, {}, {}});
+}
+
+std::string SuggestionIndex::toKey(const std::string &text, bool trimEnd)
+{
+    size_t begin = 0;
+    size_t end = text.size();
+    while (begin < end && isSpace(text[begin]))
+    {
+        begin++;
+    }
+    while (trimEnd && end > begin && isSpace(text[end - 1]))
+    {
+        end--;
+    }
+
+    std::string key = text.substr(begin, end - begin);
+    for (char &c : key)
+    {
+        if (c >= 'A' && c <= 'Z')
+        {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return key;
+}
+
+double SuggestionIndex::recencyWeight(const std::string &date)
+{
+    int day;
+    if (!DailyLedger::toDayNumber(date, day))
+    {
+        return 1.0;
+    }
+
+    double halfLives = static_cast<double>(day - kEpochDay) / kHalfLifeDays;
+    return std::exp2(std::max(-kMaxHalfLives, std::min(kMaxHalfLives, halfLives)));
+}
+
+bool SuggestionIndex::ranksAbove(int a, int b) const
+{
+    const Entry &first = entries[a];
+    const Entry &second = entries[b];
+    if (first.score != second.score)
+    {
+        return first.score > second.score;
+    }
+    if (first.lastId != second.lastId)
+    {
+        return first.lastId > second.lastId;
+    }
+    return a < b;
+}
+
+void SuggestionIndex::rebuild(const std::vector<Transaction> &transactions, const std::vector<Category> &categories)
+{
+    nodes.assign(1, {0, 0, -1, -1, {}, {}, {}});
+    labels.clear();
+    entries.clear();
+    freeEntries.clear();
+    categoryLookup.clear();
+
+    for (const auto &category : categories)
+    {
+        std::string key = toKey(category.getName(), true);
+        if (!key.empty())
+        {
+            int entry = createEntry(insertKey(key), category.getName(), true);
+            entries[entry].categoryId = category.getId();
+            categoryLookup[category.getId()] = entry;
+        }
+    }
+
+    // Accumulate the uses without touching the caches. Keys are inserted in
+    // sorted order so the path being extended stays in cache.
+    struct Use
+    {
+        std::string key;
+        int id;
+        size_t slot;
+        double weight;
+
+        bool operator<(const Use &other) const
+        {
+            return key < other.key;
+        }
+    };
+
+    std::vector<Use> uses;
+    uses.reserve(transactions.size());
+    for (size_t i = 0; i < transactions.size(); i++)
+    {
+        const Transaction &transaction = transactions[i];
+        double weight = recencyWeight(transaction.getDate());
+        auto category = categoryLookup.find(transaction.getCategoryId());
+        if (category != categoryLookup.end())
+        {
+            Entry &entry = entries[category->second];
+            entry.count++;
+            entry.score += weight;
+            entry.lastId = std::max(entry.lastId, transaction.getId());
+        }
+
+        std::string key = toKey(transaction.getDescription(), true);
+        if (!key.empty())
+        {
+            uses.push_back({std::move(key), transaction.getId(), i, weight});
+        }
+    }
+    std::sort(uses.begin(), uses.end());
+
+    nodes.reserve(nodes.size() + uses.size() * 2);
+    entries.reserve(entries.size() + uses.size());
+    for (size_t begin = 0, end = 0; begin < uses.size(); begin = end)
+    {
+        // One entry per run of equal keys, showing the newest spelling
+        Entry entry{"", insertKey(uses[begin].key), false, 0, 0, 0, 0.0};
+        size_t newest = begin;
+        for (end = begin; end < uses.size() && uses[end].key == uses[begin].key; end++)
+        {
+            entry.count++;
+            entry.score += uses[end].weight;
+            newest = uses[end].id >= uses[newest].id ? end : newest;
+        }
+
+        const Transaction &transaction = transactions[uses[newest].slot];
+        int index = createEntry(entry.node, transaction.getDescription(), false);
+        entries[index].categoryId = transaction.getCategoryId();
+        entries[index].lastId = transaction.getId();
+        entries[index].count = entry.count;
+        entries[index].score = entry.score;
+    }
+
+    // Fill the caches children first; breadth-first order reversed visits every child before its parent
+    std::vector<int> order(1, 0);
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        for (int child : nodes[order[i]].children)
+        {
+            order.push_back(child);
+        }
+    }
+    for (auto node = order.rbegin(); node != order.rend(); ++node)
+    {
+        recomputeTop(*node);
+    }
+
+    nodes.shrink_to_fit();
+    labels.shrink_to_fit();
+    entries.shrink_to_fit();
+}
+
+void SuggestionIndex::addTransaction(const Transaction &transaction)
+{
+    double weight = recencyWeight(transaction.getDate());
+    auto category = categoryLookup.find(transaction.getCategoryId());
+    if (category != categoryLookup.end())
+    {
+        Entry &entry = entries[category->second];
+        entry.count++;
+        entry.score += weight;
+        entry.lastId = std::max(entry.lastId, transaction.getId());
+        promote(category->second);
+    }
+
+    std::string key = toKey(transaction.getDescription(), true);
+    if (key.empty())
+    {
+        return;
+    }
+
+    int node = insertKey(key);
+    int index = nodes[node].descriptionEntry;
+    if (index < 0)
+    {
+        index = createEntry(node, transaction.getDescription(), false);
+    }
+
+    Entry &entry = entries[index];
+    entry.count++;
+    entry.score += weight;
+    if (transaction.getId() >= entry.lastId)
+    {
+        entry.text = transaction.getDescription();
+        entry.categoryId = transaction.getCategoryId();
+        entry.lastId = transaction.getId();
+    }
+    promote(index);
+}
+
+void SuggestionIndex::removeTransaction(const Transaction &transaction)
+{
+    double weight = recencyWeight(transaction.getDate());
+    auto category = categoryLookup.find(transaction.getCategoryId());
+    if (category != categoryLookup.end() && entries[category->second].count > 0)
+    {
+        Entry &entry = entries[category->second];
+        entry.count--;
+        entry.score = entry.count == 0 ? 0.0 : std::max(0.0, entry.score - weight);
+        refresh(entry.node);
+    }
+
+    std::string key = toKey(transaction.getDescription(), true);
+    int node = key.empty() ? -1 : findPrefix(key);
+    if (node < 0)
+    {
+        return;
+    }
+
+    // findPrefix() may stop inside an edge, leaving a node whose own key is longer
+    int index = nodes[node].descriptionEntry;
+    if (index < 0 || toKey(entries[index].text, true) != key)
+    {
+        return;
+    }
+
+    Entry &entry = entries[index];
+    entry.count--;
+    if (entry.count == 0)
+    {
+        releaseEntry(index);
+    }
+    else
+    {
+        entry.score = std::max(0.0, entry.score - weight);
+    }
+    refresh(node);
+}
+
+void SuggestionIndex::addCategory(const Category &category)
+{
+    std::string key = toKey(category.getName(), true);
+    if (key.empty() || categoryLookup.count(category.getId()) != 0)
+    {
+        return;
+    }
+
+    int entry = createEntry(insertKey(key), category.getName(), true);
+    entries[entry].categoryId = category.getId();
+    categoryLookup[category.getId()] = entry;
+    promote(entry);
+}
+
+void SuggestionIndex::updateCategory(const Category &category)
+{
+    auto existing = categoryLookup.find(category.getId());
+    if (existing == categoryLookup.end())
+    {
+        addCategory(category);
+        return;
+    }
+
+    Entry old = entries[existing->second];
+    removeCategory(category.getId());
+
+    std::string key = toKey(category.getName(), true);
+    if (key.empty())
+    {
+        return;
+    }
+
+    int entry = createEntry(insertKey(key), category.getName(), true);
+    entries[entry].categoryId = category.getId();
+    entries[entry].lastId = old.lastId;
+    entries[entry].count = old.count;
+    entries[entry].score = old.score;
+    categoryLookup[category.getId()] = entry;
+    promote(entry);
+}
+
+void SuggestionIndex::removeCategory(int categoryId)
+{
+    auto existing = categoryLookup.find(categoryId);
+    if (existing == categoryLookup.end())
+    {
+        return;
+    }
+
+    int node = entries[existing->second].node;
+    releaseEntry(existing->second);
+    categoryLookup.erase(existing);
+    refresh(node);
+}
+
+std::vector<Suggestion> SuggestionIndex::suggest(const std::string &prefix, size_t limit) const
+{
+    std::vector<Suggestion> result;
+    int node = findPrefix(toKey(prefix, false));
+    if (node < 0 || limit == 0)
+    {
+        return result;
+    }
+
+    std::vector<int> best;
+    if (limit <= kCachedSuggestions)
+    {
+        rankEntries(node, best);
+        best.resize(std::min(limit, best.size()));
+    }
+    else
+    {
+        // Deeper than the cache: rank the whole subtree
+        collectEntries(node, best);
+        size_t count = std::min(limit, best.size());
+        std::partial_sort(best.begin(), best.begin() + count, best.end(), [this](int a, int b)
+                          { return ranksAbove(a, b); });
+        best.resize(count);
+    }
+
+    for (int index : best)
+    {
+        const Entry &entry = entries[index];
+        result.push_back({entry.text, entry.isCategory, entry.categoryId, entry.count});
+    }
+    return result;
+}
+
+size_t SuggestionIndex::getMemoryUsage() const
+{
+    size_t bytes = nodes.capacity() * sizeof(Node) + labels.capacity() + entries.capacity() * sizeof(Entry) +
+                   freeEntries.capacity() * sizeof(int) +
+                   categoryLookup.bucket_count() * sizeof(void *) +
+                   categoryLookup.size() * (sizeof(void *) + sizeof(size_t) + sizeof(std::pair<const int, int>));
+    for (const auto &node : nodes)
+    {
+        bytes += (node.children.capacity() + node.categoryEntries.capacity() + node.top.capacity()) * sizeof(int);
+    }
+    for (const auto &entry : entries)
+    {
+        bytes += stringHeapSize(entry.text);
+    }
+    return bytes;
+}
+
+int SuggestionIndex::insertKey(const std::string &key)
+{
+    int node = 0;
+    size_t position = 0;
+    while (position < key.size())
+    {
+        char first = key[position];
+        auto &children = nodes[node].children;
+        auto slot = std::lower_bound(children.begin(), children.end(), first, [this](int child, char c)
+                                     { return labels[nodes[child].labelStart] < c; });
+
+        if (slot == children.end() || labels[nodes[*slot].labelStart] != first)
+        {
+            // A leaf about to get its first child starts caching its ranking
+            if (children.empty() && node != 0)
+            {
+                rankEntries(node, nodes[node].top);
+            }
+
+            int leaf = static_cast<int>(nodes.size());
+            nodes[node].children.insert(slot, leaf);
+            nodes.push_back({static_cast<uint32_t>(labels.size()), static_cast<uint32_t>(key.size() - position), node, -1, {}, {}, {}});
+            labels.append(key, position, std::string::npos);
+            return leaf;
+        }
+
+        int child = *slot;
+        const char *label = labels.data() + nodes[child].labelStart;
+        size_t labelLength = nodes[child].labelLength;
+        size_t common = 0;
+        while (common < labelLength && position + common < key.size() && label[common] == key[position + common])
+        {
+            common++;
+        }
+
+        if (common < labelLength)
+        {
+            // Split the edge; the new middle node's subtree is exactly the child's
+            int middle = static_cast<int>(nodes.size());
+            *slot = middle;
+            Node split{nodes[child].labelStart, static_cast<uint32_t>(common), node, -1, {child}, {}, {}};
+            rankEntries(child, split.top);
+            nodes[child].labelStart += static_cast<uint32_t>(common);
+            nodes[child].labelLength -= static_cast<uint32_t>(common);
+            nodes[child].parent = middle;
+            nodes.push_back(std::move(split));
+            child = middle;
+        }
+
+        node = child;
+        position += common;
+    }
+    return node;
+}
+
+int SuggestionIndex::findPrefix(const std::string &prefix) const
+{
+    int node = 0;
+    size_t position = 0;
+    while (position < prefix.size())
+    {
+        const auto &children = nodes[node].children;
+        auto slot = std::lower_bound(children.begin(), children.end(), prefix[position], [this](int child, char c)
+                                     { return labels[nodes[child].labelStart] < c; });
+        if (slot == children.end() || labels[nodes[*slot].labelStart] != prefix[position])
+        {
+            return -1;
+        }
+
+        size_t length = std::min<size_t>(nodes[*slot].labelLength, prefix.size() - position);
+        if (labels.compare(nodes[*slot].labelStart, length, prefix, position, length) != 0)
+        {
+            return -1;
+        }
+
+        node = *slot;
+        position += length;
+    }
+    return node;
+}
+
+int SuggestionIndex::createEntry(int node, const std::string &text, bool isCategory)
+{
+    int index;
+    if (!freeEntries.empty())
+    {
+        index = freeEntries.back();
+        freeEntries.pop_back();
+    }
+    else
+    {
+        index = static_cast<int>(entries.size());
+        entries.emplace_back();
+    }
+
+    Entry &entry = entries[index];
+    entry.text = text;
+    entry.node = node;
+    entry.isCategory = isCategory;
+    entry.categoryId = 0;
+    entry.lastId = 0;
+    entry.count = 0;
+    entry.score = 0.0;
+    if (isCategory)
+    {
+        nodes[node].categoryEntries.push_back(index);
+    }
+    else
+    {
+        nodes[node].descriptionEntry = index;
+    }
+    return index;
+}
+
+void SuggestionIndex::releaseEntry(int index)
+{
+    Entry &entry = entries[index];
+    Node &node = nodes[entry.node];
+    if (entry.isCategory)
+    {
+        node.categoryEntries.erase(std::find(node.categoryEntries.begin(), node.categoryEntries.end(), index));
+    }
+    else
+    {
+        node.descriptionEntry = -1;
+    }
+    entry.text.clear();
+    entry.text.shrink_to_fit();
+    entry.count = 0;
+    entry.score = 0.0;
+    freeEntries.push_back(index);
+}
+
+void SuggestionIndex::promote(int index)
+{
+    for (int node = entries[index].node; node >= 0; node = nodes[node].parent)
+    {
+        if (nodes[node].children.empty() && node != 0)
+        {
+            continue; // Leaves rank their own entries on demand
+        }
+
+        std::vector<int> &top = nodes[node].top;
+        auto existing = std::find(top.begin(), top.end(), index);
+        if (existing != top.end())
+        {
+            top.erase(existing);
+        }
+        else if (top.size() == kCachedSuggestions && !ranksAbove(index, top.back()))
+        {
+            return; // Not among this subtree's best, so not among any ancestor's either
+        }
+
+        auto position = std::lower_bound(top.begin(), top.end(), index, [this](int a, int b)
+                                         { return ranksAbove(a, b); });
+        top.insert(position, index);
+        if (top.size() > kCachedSuggestions)
+        {
+            top.pop_back();
+        }
+    }
+}
+
+void SuggestionIndex::refresh(int node)
+{
+    for (; node >= 0; node = nodes[node].parent)
+    {
+        recomputeTop(node);
+    }
+}
+
+void SuggestionIndex::recomputeTop(int node)
+{
+    if (nodes[node].children.empty() && node != 0)
+    {
+        std::vector<int>().swap(nodes[node].top);
+        return;
+    }
+
+    std::vector<int> candidates;
+    std::vector<int> ranked;
+    if (nodes[node].descriptionEntry >= 0)
+    {
+        candidates.push_back(nodes[node].descriptionEntry);
+    }
+    candidates.insert(candidates.end(), nodes[node].categoryEntries.begin(), nodes[node].categoryEntries.end());
+    for (int child : nodes[node].children)
+    {
+        rankEntries(child, ranked);
+        candidates.insert(candidates.end(), ranked.begin(), ranked.end());
+    }
+
+    size_t count = std::min(kCachedSuggestions, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), [this](int a, int b)
+                      { return ranksAbove(a, b); });
+    candidates.resize(count);
+    nodes[node].top = std::move(candidates);
+}
+
+void SuggestionIndex::rankEntries(int node, std::vector<int> &ranked) const
+{
+    if (!nodes[node].children.empty() || node == 0)
+    {
+        ranked = nodes[node].top;
+        return;
+    }
+
+    ranked.clear();
+    if (nodes[node].descriptionEntry >= 0)
+    {
+        ranked.push_back(nodes[node].descriptionEntry);
+    }
+    ranked.insert(ranked.end(), nodes[node].categoryEntries.begin(), nodes[node].categoryEntries.end());
+    std::sort(ranked.begin(), ranked.end(), [this](int a, int b)
+              { return ranksAbove(a, b); });
+}
+
+void SuggestionIndex::collectEntries(int node, std::vector<int> &found) const
+{
+    std::vector<int> pending(1, node);
+    while (!pending.empty())
+    {
+        int current = pending.back();
+        pending.pop_back();
+        if (nodes[current].descriptionEntry >= 0)
+        {
+            found.push_back(nodes[current].descriptionEntry);
+        }
+        found.insert(found.end(), nodes[current].categoryEntries.begin(), nodes[current].categoryEntries.end());
+        pending.insert(pending.end(), nodes[current].children.begin(), nodes[current].children.end());
+    }
+}
@@ -0,0 +1,76 @@
+#include "../include/TagIndex.h"
+
+void TagIndex::add(int id, const std::vector<std::string> &tags)
+{
+    allIds.add(static_cast<uint32_t>(id));
+    for (const auto &tag : tags)
+    {
+        bitmaps[tag].add(static_cast<uint32_t>(id));
+    }
+}
+
+void TagIndex::remove(int id, const std::vector<std::string> &tags)
+{
+    allIds.remove(static_cast<uint32_t>(id));
+    for (const auto &tag : tags)
+    {
+        auto entry = bitmaps.find(tag);
+        if (entry == bitmaps.end())
+        {
+            continue;
+        }
+        entry->second.remove(static_cast<uint32_t>(id));
+        if (entry->second.empty())
+        {
+            bitmaps.erase(entry);
+        }
+    }
+}
+
+const RoaringBitmap *TagIndex::find(const std::string &tag) const
+{
+    auto entry = bitmaps.find(tag);
+    return entry != bitmaps.end() ? &entry->second : nullptr;
+}
+
+const RoaringBitmap &TagIndex::all() const
+{
+    return allIds;
+}
+
+void TagIndex::getTagCounts(std::vector<std::pair<std::string, size_t>> &counts) const
+{
+    counts.clear();
+    counts.reserve(bitmaps.size());
+    for (const auto &entry : bitmaps)
+    {
+        counts.emplace_back(entry.first, entry.second.cardinality());
+    }
+}
+
+void TagIndex::clear()
+{
+    bitmaps.clear();
+    allIds.clear();
+}
+
+void TagIndex::shrinkToFit()
+{
+    allIds.shrinkToFit();
+    for (auto &entry : bitmaps)
+    {
+        entry.second.shrinkToFit();
+    }
+}
+
+size_t TagIndex::getMemoryUsage() const
+{
+    // Red-black tree node: three links and a color, then the tag and bitmap
+    size_t bytes = allIds.getMemoryUsage() +
+                   bitmaps.size() * (4 * sizeof(void *) + sizeof(std::pair<const std::string, RoaringBitmap>));
+    for (const auto &entry : bitmaps)
+    {
+        bytes += entry.first.capacity() + entry.second.getMemoryUsage();
+    }
+    return bytes;
+}
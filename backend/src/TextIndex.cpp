@@ -0,0 +1,183 @@
+#include "../include/TextIndex.h"
+#include <algorithm>
+
+static uint32_t packTrigram(const std::string &text, size_t position)
+{
+    return (static_cast<uint32_t>(static_cast<unsigned char>(text[position])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(text[position + 1])) << 8) |
+           static_cast<uint32_t>(static_cast<unsigned char>(text[position + 2]));
+}
+
+std::string TextIndex::normalize(const std::string &text)
+{
+    std::string normalized;
+    normalized.reserve(text.size() + 1);
+    bool pendingSpace = true;
+    for (char c : text)
+    {
+        unsigned char byte = static_cast<unsigned char>(c);
+        bool wordByte = (byte >= '0' && byte <= '9') || (byte >= 'a' && byte <= 'z') ||
+                        (byte >= 'A' && byte <= 'Z') || byte >= 0x80;
+        if (!wordByte)
+        {
+            pendingSpace = true;
+            continue;
+        }
+
+        if (pendingSpace)
+        {
+            normalized += ' ';
+            pendingSpace = false;
+        }
+        normalized += (byte >= 'A' && byte <= 'Z') ? static_cast<char>(byte - 'A' + 'a') : c;
+    }
+    return normalized;
+}
+
+void TextIndex::collectTrigrams(const std::string &normalized, std::vector<uint32_t> &trigrams)
+{
+    trigrams.clear();
+    for (size_t i = 0; i + 3 <= normalized.size(); i++)
+    {
+        trigrams.push_back(packTrigram(normalized, i));
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+}
+
+void TextIndex::add(int id, const std::string &description)
+{
+    std::vector<uint32_t> trigrams;
+    collectTrigrams(normalize(description), trigrams);
+    for (uint32_t trigram : trigrams)
+    {
+        std::vector<int> &ids = postings[trigram];
+        if (ids.empty() || ids.back() < id)
+        {
+            ids.push_back(id);
+            continue;
+        }
+
+        auto position = std::lower_bound(ids.begin(), ids.end(), id);
+        if (*position != id)
+        {
+            ids.insert(position, id);
+        }
+    }
+}
+
+void TextIndex::remove(int id, const std::string &description)
+{
+    std::vector<uint32_t> trigrams;
+    collectTrigrams(normalize(description), trigrams);
+    for (uint32_t trigram : trigrams)
+    {
+        auto entry = postings.find(trigram);
+        if (entry == postings.end())
+        {
+            continue;
+        }
+
+        std::vector<int> &ids = entry->second;
+        auto position = std::lower_bound(ids.begin(), ids.end(), id);
+        if (position != ids.end() && *position == id)
+        {
+            ids.erase(position);
+        }
+        if (ids.empty())
+        {
+            postings.erase(entry);
+        }
+    }
+}
+
+bool TextIndex::visitCandidates(const std::string &pattern, const std::function<bool(int)> &visit) const
+{
+    std::vector<uint32_t> trigrams;
+    collectTrigrams(pattern, trigrams);
+    if (trigrams.empty())
+    {
+        return false;
+    }
+
+    std::vector<const std::vector<int> *> lists;
+    for (uint32_t trigram : trigrams)
+    {
+        auto entry = postings.find(trigram);
+        if (entry == postings.end())
+        {
+            return true; // Some trigram occurs nowhere, so nothing matches
+        }
+        lists.push_back(&entry->second);
+    }
+
+    // Drive from the rarest list and probe the others, most selective first
+    std::sort(lists.begin(), lists.end(), [](const std::vector<int> *a, const std::vector<int> *b)
+              { return a->size() < b->size(); });
+
+    // Upper search bound per list; candidates arrive in descending order so the bounds only shrink
+    std::vector<std::vector<int>::const_iterator> limits;
+    for (const auto *ids : lists)
+    {
+        limits.push_back(ids->end());
+    }
+
+    const std::vector<int> &driver = *lists[0];
+    for (auto id = driver.rbegin(); id != driver.rend(); ++id)
+    {
+        bool inAll = true;
+        for (size_t i = 1; i < lists.size() && inAll; i++)
+        {
+            limits[i] = std::lower_bound(lists[i]->begin(), limits[i], *id);
+            inAll = limits[i] != lists[i]->end() && *limits[i] == *id;
+        }
+        if (inAll && !visit(*id))
+        {
+            break;
+        }
+    }
+    return true;
+}
+
+bool TextIndex::estimateCandidates(const std::string &pattern, size_t &estimate) const
+{
+    std::vector<uint32_t> trigrams;
+    collectTrigrams(pattern, trigrams);
+    if (trigrams.empty())
+    {
+        return false;
+    }
+
+    estimate = SIZE_MAX;
+    for (uint32_t trigram : trigrams)
+    {
+        auto entry = postings.find(trigram);
+        estimate = std::min(estimate, entry != postings.end() ? entry->second.size() : 0);
+    }
+    return true;
+}
+
+void TextIndex::clear()
+{
+    postings.clear();
+}
+
+void TextIndex::shrinkToFit()
+{
+    for (auto &entry : postings)
+    {
+        entry.second.shrink_to_fit();
+    }
+    postings.rehash(0);
+}
+
+size_t TextIndex::getMemoryUsage() const
+{
+    size_t bytes = postings.bucket_count() * sizeof(void *) +
+                   postings.size() * (sizeof(void *) + sizeof(size_t) + sizeof(std::pair<const uint32_t, std::vector<int>>));
+    for (const auto &entry : postings)
+    {
+        bytes += entry.second.capacity() * sizeof(int);
+    }
+    return bytes;
+}
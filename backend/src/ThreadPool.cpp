@@ -0,0 +1,237 @@
+#include "../include/ThreadPool.h"
+#include <algorithm>
+#include <exception>
+
+// Depth of pool activity on this thread; nested calls must not take resizeMutex again
+thread_local int t_poolDepth = 0;
+
+ThreadPool::ThreadPool(size_t threadCount)
+    : pending(0), nextQueue(0), stopping(false)
+{
+    start(threadCount);
+}
+
+ThreadPool::~ThreadPool()
+{
+    stop();
+}
+
+ThreadPool &ThreadPool::shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::start(size_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    stopping = false;
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        workers.push_back(std::make_unique<Worker>());
+    }
+
+    // Start threads only once every deque exists, since workers steal from each other
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        workers[i]->thread = std::thread(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+void ThreadPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+
+    for (auto &worker : workers)
+    {
+        if (worker->thread.joinable())
+        {
+            worker->thread.join();
+        }
+    }
+    workers.clear();
+}
+
+void ThreadPool::setThreadCount(size_t threadCount)
+{
+    std::unique_lock<std::shared_mutex> lock(resizeMutex);
+    stop();
+    start(threadCount);
+}
+
+size_t ThreadPool::getThreadCount() const
+{
+    std::shared_lock<std::shared_mutex> lock(resizeMutex, std::defer_lock);
+    if (t_poolDepth == 0)
+    {
+        lock.lock();
+    }
+    return workers.size();
+}
+
+size_t ThreadPool::chunkCount(size_t count, size_t grainSize)
+{
+    if (grainSize == 0)
+    {
+        grainSize = 1;
+    }
+    return (count + grainSize - 1) / grainSize;
+}
+
+void ThreadPool::submit(Task task)
+{
+    std::shared_lock<std::shared_mutex> lock(resizeMutex, std::defer_lock);
+    if (t_poolDepth == 0)
+    {
+        lock.lock();
+    }
+    enqueue(std::move(task));
+}
+
+void ThreadPool::enqueue(Task task)
+{
+    Worker &worker = *workers[nextQueue++ % workers.size()];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+    pending++;
+
+    // Taking poolMutex orders the increment before any worker's predicate check
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+    }
+    wakeup.notify_one();
+}
+
+bool ThreadPool::takeTask(size_t index, Task &task)
+{
+    size_t count = workers.size();
+    for (size_t k = 0; k < count; k++)
+    {
+        Worker &worker = *workers[(index + k) % count];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty())
+        {
+            continue;
+        }
+
+        // The owner works LIFO for locality, thieves take the oldest task
+        if (k == 0)
+        {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+        }
+        else
+        {
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+        }
+        pending--;
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t index)
+{
+    t_poolDepth = 1;
+    while (true)
+    {
+        Task task;
+        if (takeTask(index, task))
+        {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(poolMutex);
+        wakeup.wait(lock, [this]
+                    { return stopping || pending.load() > 0; });
+        if (stopping && pending.load() == 0)
+        {
+            return;
+        }
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grainSize,
+                             const std::function<void(size_t, size_t, size_t)> &body)
+{
+    if (grainSize == 0)
+    {
+        grainSize = 1;
+    }
+    size_t chunks = chunkCount(count, grainSize);
+
+    std::shared_lock<std::shared_mutex> lock(resizeMutex, std::defer_lock);
+    if (t_poolDepth == 0)
+    {
+        lock.lock();
+    }
+
+    // Serial fallback for small inputs or a single worker
+    if (chunks <= 1 || workers.size() <= 1)
+    {
+        for (size_t chunk = 0; chunk < chunks; chunk++)
+        {
+            body(chunk, chunk * grainSize, std::min(count, (chunk + 1) * grainSize));
+        }
+        return;
+    }
+
+    std::atomic<size_t> remaining(chunks);
+    std::mutex doneMutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+
+    t_poolDepth++;
+    for (size_t chunk = 0; chunk < chunks; chunk++)
+    {
+        enqueue([&, chunk]
+                {
+            try
+            {
+                body(chunk, chunk * grainSize, std::min(count, (chunk + 1) * grainSize));
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> errorLock(doneMutex);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+            if (--remaining == 0)
+            {
+                std::lock_guard<std::mutex> doneLock(doneMutex);
+                done.notify_all();
+            } });
+    }
+
+    // Help out instead of idling, then wait for chunks still running elsewhere
+    Task task;
+    while (remaining.load() > 0 && takeTask(nextQueue++ % workers.size(), task))
+    {
+        task();
+    }
+    {
+        std::unique_lock<std::mutex> doneLock(doneMutex);
+        done.wait(doneLock, [&]
+                  { return remaining.load() == 0; });
+    }
+    t_poolDepth--;
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
@@ -0,0 +1,168 @@
+#include "../include/Tracer.h"
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+std::atomic<bool> Tracer::enabled(false);
+
+// Nanoseconds on the steady clock
+static int64_t steadyNanos()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Ensures BUDGET_TRACKER_TRACE takes effect as soon as the library is loaded
+static bool g_tracerInitialized = (Tracer::instance(), true);
+
+Tracer::Tracer()
+    : originNanos(steadyNanos()), droppedEvents(0)
+{
+    const char *path = std::getenv("BUDGET_TRACKER_TRACE");
+    if (path != nullptr && path[0] != '\0')
+    {
+        start(path);
+    }
+}
+
+Tracer::~Tracer()
+{
+    stop();
+}
+
+Tracer &Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+bool Tracer::start(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (enabled.load(std::memory_order_relaxed))
+    {
+        return false; // Already tracing
+    }
+
+    filePath = path;
+    events.clear();
+    droppedEvents = 0;
+    originNanos.store(steadyNanos(), std::memory_order_relaxed);
+    enabled.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+bool Tracer::stop()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!enabled.load(std::memory_order_relaxed))
+    {
+        return false; // Not tracing
+    }
+
+    enabled.store(false, std::memory_order_relaxed);
+    bool success = writeFile();
+    events.clear();
+    events.shrink_to_fit();
+    return success;
+}
+
+void Tracer::record(TraceEvent &&event)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!enabled.load(std::memory_order_relaxed))
+    {
+        return; // Tracing stopped while the span was open
+    }
+
+    if (events.size() >= kMaxEvents)
+    {
+        droppedEvents++;
+        return;
+    }
+    events.push_back(std::move(event));
+}
+
+double Tracer::now() const
+{
+    return (steadyNanos() - originNanos.load(std::memory_order_relaxed)) / 1000.0;
+}
+
+uint32_t Tracer::currentThreadId()
+{
+    static std::atomic<uint32_t> nextThreadId(1);
+    thread_local uint32_t threadId = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+    return threadId;
+}
+
+bool Tracer::writeFile()
+{
+    std::ofstream file(filePath);
+    if (!file.is_open())
+    {
+        std::cerr << "Failed to open trace file for writing: " << filePath << std::endl;
+        return false;
+    }
+
+    // Default stream precision keeps six significant digits, which rounds timestamps after a few seconds
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":" << droppedEvents << "},\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        const TraceEvent &event = events[i];
+        file << (i == 0 ? "\n" : ",\n")
+             << "{\"name\":" << nlohmann::json(event.name).dump()
+             << ",\"cat\":\"" << event.category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadId
+             << ",\"ts\":" << event.startMicros << ",\"dur\":" << event.durationMicros;
+        if (!event.args.empty())
+        {
+            file << ",\"args\":{";
+            for (size_t j = 0; j < event.args.size(); j++)
+            {
+                file << (j == 0 ? "" : ",") << "\"" << event.args[j].first << "\":" << event.args[j].second;
+            }
+            file << "}";
+        }
+        file << "}";
+    }
+    file << "\n]}\n";
+
+    if (!file)
+    {
+        std::cerr << "Failed to write trace file: " << filePath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void TraceSpan::begin(const char *name, const char *category)
+{
+    event.name = name;
+    event.category = category;
+    event.threadId = Tracer::currentThreadId();
+    event.startMicros = Tracer::instance().now();
+}
+
+void TraceSpan::end()
+{
+    Tracer &tracer = Tracer::instance();
+    event.durationMicros = tracer.now() - event.startMicros;
+    tracer.record(std::move(event));
+}
+
+void TraceSpan::addArg(const char *key, long long value)
+{
+    if (active)
+    {
+        event.args.emplace_back(key, std::to_string(value));
+    }
+}
+
+void TraceSpan::addArg(const char *key, const std::string &value)
+{
+    if (active)
+    {
+        event.args.emplace_back(key, nlohmann::json(value).dump());
+    }
+}
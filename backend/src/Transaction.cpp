@@ -2,6 +2,10 @@
 #include "../include/Transaction.h"
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <cctype>
+#include "../include/ExchangeRates.h"
+#include "../include/MemoryUsage.h"
 
 // Constructor implementation
 Transaction::Transaction(int id, const std::string &date, double amount,
@@ -20,6 +24,8 @@ double Transaction::getAmount() const { return amount; }
 std::string Transaction::getDescription() const { return description; }
 int Transaction::getCategoryId() const { return categoryId; }
 bool Transaction::getIsIncome() const { return isIncome; }
+const std::vector<std::string> &Transaction::getTags() const { return tags; }
+const std::string &Transaction::getCurrency() const { return currency; }
 
 // Setters implementation
 void Transaction::setId(int id) { this->id = id; }
@@ -29,6 +35,49 @@ void Transaction::setDescription(const std::string &description) { this->descrip
 void Transaction::setCategoryId(int categoryId) { this->categoryId = categoryId; }
 void Transaction::setIsIncome(bool isIncome) { this->isIncome = isIncome; }
 
+void Transaction::setTags(const std::vector<std::string> &tags)
+{
+    std::vector<std::string> normalized;
+    normalized.reserve(tags.size());
+    for (const auto &tag : tags)
+    {
+        std::string value = normalizeTag(tag);
+        if (!value.empty())
+        {
+            normalized.push_back(std::move(value));
+        }
+    }
+    std::sort(normalized.begin(), normalized.end());
+    normalized.erase(std::unique(normalized.begin(), normalized.end()), normalized.end());
+    this->tags = std::move(normalized);
+}
+
+void Transaction::setCurrency(const std::string &currency)
+{
+    this->currency = ExchangeRates::normalizeCode(currency);
+}
+
+std::string Transaction::normalizeTag(const std::string &tag)
+{
+    size_t begin = 0;
+    size_t end = tag.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(tag[begin])))
+    {
+        begin++;
+    }
+    while (end > begin && std::isspace(static_cast<unsigned char>(tag[end - 1])))
+    {
+        end--;
+    }
+
+    std::string value = tag.substr(begin, end - begin);
+    for (char &c : value)
+    {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return value;
+}
+
 // Utility function implementation
 std::string Transaction::toString() const
 {
@@ -36,8 +85,29 @@ std::string Transaction::toString() const
     oss << "Transaction [ID: " << id
         << ", Date: " << date
         << ", Amount: " << std::fixed << std::setprecision(2) << amount
+        << (currency.empty() ? "" : " ") << currency
         << ", Description: " << description
         << ", Category ID: " << categoryId
-        << ", Type: " << (isIncome ? "Income" : "Expense") << "]";
+        << ", Type: " << (isIncome ? "Income" : "Expense");
+    if (!tags.empty())
+    {
+        oss << ", Tags:";
+        for (const auto &tag : tags)
+        {
+            oss << ' ' << tag;
+        }
+    }
+    oss << "]";
     return oss.str();
-}
\ No newline at end of file
+}
+
+size_t Transaction::getHeapSize() const
+{
+    size_t bytes = stringHeapSize(date) + stringHeapSize(description) + stringHeapSize(currency) +
+                   tags.capacity() * sizeof(std::string);
+    for (const auto &tag : tags)
+    {
+        bytes += stringHeapSize(tag);
+    }
+    return bytes;
+}
@@ -0,0 +1,369 @@
+#include "../include/TransactionExporter.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+// Buffered bytes that trigger a write to disk
+static const size_t kFlushThreshold = 1 << 20;
+
+static const char kColumnarMagic[8] = {'B', 'T', 'C', 'O', 'L', 'S', '0', '3'};
+
+static std::string toLower(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c)
+                   { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+// Shortest text that parses back to the same double, as JSON results print it
+static void appendNumber(std::string &out, double value)
+{
+    char text[32];
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    out.append(text, result.ptr);
+}
+
+static void appendNumber(std::string &out, int value)
+{
+    char text[16];
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    out.append(text, result.ptr);
+}
+
+// Quotes a CSV field when it holds a delimiter, quote or line break
+static void appendCsvField(std::string &out, const std::string &value)
+{
+    if (value.find_first_of(",\"\r\n") == std::string::npos)
+    {
+        out += value;
+        return;
+    }
+
+    out += '"';
+    for (char c : value)
+    {
+        if (c == '"')
+        {
+            out += '"';
+        }
+        out += c;
+    }
+    out += '"';
+}
+
+// Tags in one CSV field, separated by semicolons
+static std::string joinTags(const std::vector<std::string> &tags)
+{
+    std::string joined;
+    for (size_t i = 0; i < tags.size(); i++)
+    {
+        if (i > 0)
+        {
+            joined += ';';
+        }
+        joined += tags[i];
+    }
+    return joined;
+}
+
+static void appendJsonString(std::string &out, const std::string &value)
+{
+    out += '"';
+    for (char c : value)
+    {
+        switch (c)
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                out += escaped;
+            }
+            else
+            {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+TransactionExporter::TransactionExporter(ExportFormat format, const std::vector<Category> &categories)
+    : format(format), rowCount(0), bytesWritten(0)
+{
+    for (const auto &category : categories)
+    {
+        categoryNames[category.getId()] = category.getName();
+    }
+}
+
+TransactionExporter::~TransactionExporter()
+{
+    if (file.is_open())
+    {
+        file.close();
+        std::error_code error;
+        std::filesystem::remove(tempPath, error);
+    }
+}
+
+bool TransactionExporter::open(const std::string &path)
+{
+    filePath = path;
+    tempPath = path + ".tmp";
+    file.open(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "Failed to open file for writing: " << tempPath << std::endl;
+        return false;
+    }
+
+    buffer.reserve(kFlushThreshold + 4096);
+    if (format == ExportFormat::Csv)
+    {
+        buffer += "id,date,amount,description,categoryId,categoryName,isIncome,currency,tags\n";
+    }
+    else if (format == ExportFormat::Columnar)
+    {
+        append(kColumnarMagic, sizeof(kColumnarMagic));
+        dateOffsets.push_back(0);
+        descriptionOffsets.push_back(0);
+        tagOffsets.push_back(0);
+        currencyOffsets.push_back(0);
+    }
+    return true;
+}
+
+void TransactionExporter::write(const Transaction &transaction)
+{
+    rowCount++;
+    switch (format)
+    {
+    case ExportFormat::Csv:
+        appendNumber(buffer, transaction.getId());
+        buffer += ',';
+        appendCsvField(buffer, transaction.getDate());
+        buffer += ',';
+        appendNumber(buffer, transaction.getAmount());
+        buffer += ',';
+        appendCsvField(buffer, transaction.getDescription());
+        buffer += ',';
+        appendNumber(buffer, transaction.getCategoryId());
+        buffer += ',';
+        appendCsvField(buffer, categoryName(transaction.getCategoryId()));
+        buffer += transaction.getIsIncome() ? ",true," : ",false,";
+        appendCsvField(buffer, transaction.getCurrency());
+        buffer += ',';
+        appendCsvField(buffer, joinTags(transaction.getTags()));
+        buffer += '\n';
+        break;
+
+    case ExportFormat::Ndjson:
+        buffer += "{\"id\":";
+        appendNumber(buffer, transaction.getId());
+        buffer += ",\"date\":";
+        appendJsonString(buffer, transaction.getDate());
+        buffer += ",\"amount\":";
+        appendNumber(buffer, transaction.getAmount());
+        buffer += ",\"description\":";
+        appendJsonString(buffer, transaction.getDescription());
+        buffer += ",\"categoryId\":";
+        appendNumber(buffer, transaction.getCategoryId());
+        buffer += ",\"categoryName\":";
+        appendJsonString(buffer, categoryName(transaction.getCategoryId()));
+        buffer += transaction.getIsIncome() ? ",\"isIncome\":true,\"tags\":[" : ",\"isIncome\":false,\"tags\":[";
+        for (size_t i = 0; i < transaction.getTags().size(); i++)
+        {
+            if (i > 0)
+            {
+                buffer += ',';
+            }
+            appendJsonString(buffer, transaction.getTags()[i]);
+        }
+        buffer += "],\"currency\":";
+        appendJsonString(buffer, transaction.getCurrency());
+        buffer += "}\n";
+        break;
+
+    case ExportFormat::Columnar:
+        ids.push_back(transaction.getId());
+        dates += transaction.getDate();
+        dateOffsets.push_back(static_cast<uint32_t>(dates.size()));
+        amounts.push_back(transaction.getAmount());
+        descriptions += transaction.getDescription();
+        descriptionOffsets.push_back(static_cast<uint32_t>(descriptions.size()));
+        categoryIds.push_back(transaction.getCategoryId());
+        incomeFlags.push_back(transaction.getIsIncome() ? 1 : 0);
+        for (const auto &tag : transaction.getTags())
+        {
+            tags += tag;
+            tags += '\0';
+        }
+        tagOffsets.push_back(static_cast<uint32_t>(tags.size()));
+        currencies += transaction.getCurrency();
+        currencyOffsets.push_back(static_cast<uint32_t>(currencies.size()));
+        if (ids.size() == kRowGroupSize)
+        {
+            writeRowGroup();
+        }
+        return;
+    }
+
+    flush(kFlushThreshold);
+}
+
+bool TransactionExporter::close()
+{
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    if (format == ExportFormat::Columnar)
+    {
+        if (!ids.empty())
+        {
+            writeRowGroup();
+        }
+        uint32_t endMarker = 0;
+        append(&endMarker, sizeof(endMarker));
+        append(&rowCount, sizeof(rowCount));
+        append(kColumnarMagic, sizeof(kColumnarMagic));
+    }
+
+    flush(0);
+    file.close();
+    if (!file)
+    {
+        std::cerr << "Failed to write file: " << tempPath << std::endl;
+        std::error_code error;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    try
+    {
+        std::filesystem::rename(tempPath, filePath);
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error saving to file: " << e.what() << std::endl;
+        std::error_code error;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+}
+
+uint64_t TransactionExporter::getRowCount() const
+{
+    return rowCount;
+}
+
+uint64_t TransactionExporter::getBytesWritten() const
+{
+    return bytesWritten;
+}
+
+bool TransactionExporter::resolveFormat(const std::string &name, const std::string &filePath, ExportFormat &format)
+{
+    std::string key = toLower(name);
+    if (key.empty())
+    {
+        size_t dot = filePath.find_last_of('.');
+        key = dot == std::string::npos ? "" : toLower(filePath.substr(dot + 1));
+    }
+
+    if (key == "csv")
+    {
+        format = ExportFormat::Csv;
+    }
+    else if (key == "ndjson" || key == "jsonl")
+    {
+        format = ExportFormat::Ndjson;
+    }
+    else if (key == "columnar" || key == "btcol")
+    {
+        format = ExportFormat::Columnar;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+void TransactionExporter::flush(size_t threshold)
+{
+    if (buffer.size() < threshold || buffer.empty())
+    {
+        return;
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    bytesWritten += buffer.size();
+    buffer.clear();
+}
+
+void TransactionExporter::writeRowGroup()
+{
+    uint32_t rows = static_cast<uint32_t>(ids.size());
+    append(&rows, sizeof(rows));
+    append(ids.data(), ids.size() * sizeof(int32_t));
+    append(dateOffsets.data(), dateOffsets.size() * sizeof(uint32_t));
+    append(dates.data(), dates.size());
+    append(amounts.data(), amounts.size() * sizeof(double));
+    append(descriptionOffsets.data(), descriptionOffsets.size() * sizeof(uint32_t));
+    append(descriptions.data(), descriptions.size());
+    append(categoryIds.data(), categoryIds.size() * sizeof(int32_t));
+    append(incomeFlags.data(), incomeFlags.size());
+    append(tagOffsets.data(), tagOffsets.size() * sizeof(uint32_t));
+    append(tags.data(), tags.size());
+    append(currencyOffsets.data(), currencyOffsets.size() * sizeof(uint32_t));
+    append(currencies.data(), currencies.size());
+    flush(0);
+
+    // Keep the capacity for the next group
+    ids.clear();
+    dateOffsets.assign(1, 0);
+    dates.clear();
+    amounts.clear();
+    descriptionOffsets.assign(1, 0);
+    descriptions.clear();
+    categoryIds.clear();
+    incomeFlags.clear();
+    tagOffsets.assign(1, 0);
+    tags.clear();
+    currencyOffsets.assign(1, 0);
+    currencies.clear();
+}
+
+void TransactionExporter::append(const void *data, size_t size)
+{
+    buffer.append(static_cast<const char *>(data), size);
+}
+
+const std::string &TransactionExporter::categoryName(int categoryId) const
+{
+    static const std::string uncategorized = "Uncategorized";
+    auto category = categoryNames.find(categoryId);
+    return category != categoryNames.end() ? category->second : uncategorized;
+}
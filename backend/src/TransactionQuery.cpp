@@ -0,0 +1,196 @@
+#include "../include/TransactionQuery.h"
+#include <algorithm>
+#include "../include/TextIndex.h"
+#include "../include/Transaction.h"
+
+const char *queryAccessName(QueryAccess access)
+{
+    switch (access)
+    {
+    case QueryAccess::Month:
+        return "month";
+    case QueryAccess::Category:
+        return "category";
+    case QueryAccess::Text:
+        return "text";
+    case QueryAccess::Tag:
+        return "tag";
+    default:
+        return "scan";
+    }
+}
+
+TransactionQuery::TransactionQuery()
+    : minAmountSet(false), minimumAmount(0.0), maxAmountSet(false), maximumAmount(0.0),
+      incomeSet(false), incomeFlag(false), resultLimit(0), descending(false)
+{
+}
+
+TransactionQuery &TransactionQuery::inMonth(const std::string &monthYear)
+{
+    dateFilter.monthYear = monthYear;
+    return *this;
+}
+
+TransactionQuery &TransactionQuery::between(const std::string &fromDate, const std::string &toDate)
+{
+    dateFilter.fromDate = fromDate;
+    dateFilter.toDate = toDate;
+    return *this;
+}
+
+TransactionQuery &TransactionQuery::inCategory(int categoryId)
+{
+    auto position = std::lower_bound(categoryIds.begin(), categoryIds.end(), categoryId);
+    if (position == categoryIds.end() || *position != categoryId)
+    {
+        categoryIds.insert(position, categoryId);
+    }
+    return *this;
+}
+
+TransactionQuery &TransactionQuery::inCategories(const std::vector<int> &ids)
+{
+    for (int categoryId : ids)
+    {
+        inCategory(categoryId);
+    }
+    return *this;
+}
+
+TransactionQuery &TransactionQuery::minAmount(double amount)
+{
+    minAmountSet = true;
+    minimumAmount = amount;
+    return *this;
+}
+
+TransactionQuery &TransactionQuery::maxAmount(double amount)
+{
+    maxAmountSet = true;
+    maximumAmount = amount;
+    return *this;
+}
+
+TransactionQuery &TransactionQuery::income(bool isIncome)
+{
+    incomeSet = true;
+    incomeFlag = isIncome;
+    return *this;
+}
+
+TransactionQuery &TransactionQuery::containing(const std::string &text, bool prefix)
+{
+    // A leading space anchors the pattern to the start of a word
+    pattern = TextIndex::normalize(text);
+    if (!prefix && !pattern.empty())
+    {
+        pattern.erase(0, 1);
+    }
+    return *this;
+}
+
+// Inserts a normalized tag into a sorted set, ignoring tags that normalize to nothing
+static void insertTag(std::vector<std::string> &set, const std::string &tag)
+{
+    std::string value = Transaction::normalizeTag(tag);
+    auto position = std::lower_bound(set.begin(), set.end(), value);
+    if (!value.empty() && (position == set.end() || *position != value))
+    {
+        set.insert(position, std::move(value));
+    }
+}
+
+TransactionQuery &TransactionQuery::withTag(const std::string &tag)
+{
+    insertTag(tags, tag);
+    return *this;
+}
+
+TransactionQuery &TransactionQuery::withoutTag(const std::string &tag)
+{
+    insertTag(excludedTags, tag);
+    return *this;
+}
+
+TransactionQuery &TransactionQuery::limit(size_t count)
+{
+    resultLimit = count;
+    return *this;
+}
+
+TransactionQuery &TransactionQuery::newestFirst(bool newest)
+{
+    descending = newest;
+    return *this;
+}
+
+const TransactionFilter &TransactionQuery::getDateFilter() const
+{
+    return dateFilter;
+}
+
+const std::vector<int> &TransactionQuery::getCategoryIds() const
+{
+    return categoryIds;
+}
+
+bool TransactionQuery::hasMinAmount() const
+{
+    return minAmountSet;
+}
+
+double TransactionQuery::getMinAmount() const
+{
+    return minimumAmount;
+}
+
+bool TransactionQuery::hasMaxAmount() const
+{
+    return maxAmountSet;
+}
+
+double TransactionQuery::getMaxAmount() const
+{
+    return maximumAmount;
+}
+
+bool TransactionQuery::hasIncomeFlag() const
+{
+    return incomeSet;
+}
+
+bool TransactionQuery::getIsIncome() const
+{
+    return incomeFlag;
+}
+
+size_t TransactionQuery::getLimit() const
+{
+    return resultLimit;
+}
+
+bool TransactionQuery::isNewestFirst() const
+{
+    return descending;
+}
+
+const std::string &TransactionQuery::getPattern() const
+{
+    return pattern;
+}
+
+const std::vector<std::string> &TransactionQuery::getTags() const
+{
+    return tags;
+}
+
+const std::vector<std::string> &TransactionQuery::getExcludedTags() const
+{
+    return excludedTags;
+}
+
+bool TransactionQuery::hasTagPredicate() const
+{
+    return !tags.empty() || !excludedTags.empty();
+}
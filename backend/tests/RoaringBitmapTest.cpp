@@ -0,0 +1,238 @@
+/**
+ * @file RoaringBitmapTest.cpp
+ * @brief Checks RoaringBitmap against std::set around its container switch points.
+ *
+ * Runs under ctest; prints every failed check and exits non-zero if any failed.
+ */
+#include <cstdint>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+#include "../include/RoaringBitmap.h"
+#include "../include/TagIndex.h"
+
+static int g_failures = 0;
+
+static void check(bool condition, const std::string &what)
+{
+    if (!condition)
+    {
+        std::cerr << "FAILED: " << what << std::endl;
+        g_failures++;
+    }
+}
+
+// Compares every observable property of a bitmap with the expected set
+static void checkEqual(const RoaringBitmap &bitmap, const std::set<int> &expected, const std::string &what)
+{
+    std::vector<int> values;
+    bitmap.toVector(values);
+    check(values == std::vector<int>(expected.begin(), expected.end()), what + ": values");
+    check(bitmap.cardinality() == expected.size(), what + ": cardinality");
+    check(bitmap.empty() == expected.empty(), what + ": empty");
+    for (int value : expected)
+    {
+        if (!bitmap.contains(static_cast<uint32_t>(value)))
+        {
+            check(false, what + ": contains " + std::to_string(value));
+            break;
+        }
+    }
+}
+
+// Every other value of the first container, so n values never fill it
+static std::set<int> evens(size_t count, int offset = 0)
+{
+    std::set<int> values;
+    for (size_t i = 0; i < count; i++)
+    {
+        values.insert(offset + static_cast<int>(2 * i));
+    }
+    return values;
+}
+
+static RoaringBitmap fromSet(const std::set<int> &values)
+{
+    RoaringBitmap bitmap;
+    bitmap.addSorted(std::vector<int>(values.begin(), values.end()));
+    return bitmap;
+}
+
+static void testArrayLimitByAdd()
+{
+    const size_t limit = RoaringBitmap::kArrayLimit;
+    for (size_t count : {limit - 1, limit, limit + 1, limit + 2})
+    {
+        std::set<int> expected = evens(count);
+        RoaringBitmap bitmap;
+        for (int value : expected)
+        {
+            bitmap.add(static_cast<uint32_t>(value));
+        }
+        checkEqual(bitmap, expected, "add " + std::to_string(count));
+        checkEqual(fromSet(expected), expected, "addSorted " + std::to_string(count));
+
+        // Duplicates must not change the count on either side of the limit
+        bitmap.add(0);
+        bitmap.add(static_cast<uint32_t>(2 * (count - 1)));
+        checkEqual(bitmap, expected, "re-add " + std::to_string(count));
+    }
+}
+
+static void testArrayLimitByRemove()
+{
+    const size_t limit = RoaringBitmap::kArrayLimit;
+    std::set<int> expected = evens(limit + 1);
+    RoaringBitmap bitmap = fromSet(expected);
+
+    // Back across the limit, then down to a handful of values
+    while (expected.size() > 8)
+    {
+        int value = *expected.rbegin();
+        expected.erase(value);
+        bitmap.remove(static_cast<uint32_t>(value));
+        if (expected.size() + 1 >= limit || expected.size() == 8)
+        {
+            checkEqual(bitmap, expected, "remove to " + std::to_string(expected.size()));
+        }
+    }
+
+    // A bitmap container would still hold its 8 KiB of words
+    bitmap.shrinkToFit();
+    check(bitmap.getMemoryUsage() < 1024, "sparse container is an array again");
+
+    bitmap.add(1);
+    expected.insert(1);
+    checkEqual(bitmap, expected, "add after shrinking back");
+}
+
+static void testEmptyContainers()
+{
+    const size_t limit = RoaringBitmap::kArrayLimit;
+
+    // Removing the last value of a container drops it, for arrays and bitmaps alike
+    RoaringBitmap array;
+    array.add(70000);
+    array.remove(70000);
+    checkEqual(array, {}, "array emptied by remove");
+    array.remove(70000);
+    checkEqual(array, {}, "remove from empty");
+
+    std::set<int> dense = evens(limit + 100, 1 << 16);
+    std::set<int> sparse = {1, 3, 5};
+    std::set<int> both = dense;
+    both.insert(sparse.begin(), sparse.end());
+
+    // Intersections and differences that empty one container but not the other
+    RoaringBitmap disjoint = fromSet(evens(limit + 100, (1 << 16) + 1));
+    RoaringBitmap bitmap = fromSet(both);
+    bitmap.intersectWith(fromSet(sparse));
+    checkEqual(bitmap, sparse, "intersect empties the bitmap container");
+
+    bitmap = fromSet(both);
+    bitmap.intersectWith(disjoint);
+    checkEqual(bitmap, {}, "bitmap-bitmap intersection with no overlap");
+
+    bitmap = fromSet(both);
+    bitmap.subtract(fromSet(dense));
+    checkEqual(bitmap, sparse, "subtract empties the bitmap container");
+
+    bitmap = fromSet(both);
+    bitmap.subtract(fromSet(both));
+    checkEqual(bitmap, {}, "subtract everything");
+
+    RoaringBitmap empty;
+    bitmap = fromSet(both);
+    bitmap.intersectWith(empty);
+    checkEqual(bitmap, {}, "intersect with empty");
+    bitmap = fromSet(both);
+    bitmap.subtract(empty);
+    checkEqual(bitmap, both, "subtract empty");
+    bitmap.unionWith(empty);
+    checkEqual(bitmap, both, "union with empty");
+}
+
+static void testMixedOperations()
+{
+    const size_t limit = RoaringBitmap::kArrayLimit;
+
+    // Two arrays whose union crosses the limit, and a bitmap whose difference falls back under it
+    std::set<int> low = evens(limit / 2 + 10);
+    std::set<int> high = evens(limit / 2 + 10, 1);
+    std::set<int> all = low;
+    all.insert(high.begin(), high.end());
+
+    RoaringBitmap bitmap = fromSet(low);
+    bitmap.unionWith(fromSet(high));
+    checkEqual(bitmap, all, "array union crossing the limit");
+
+    bitmap.subtract(fromSet(high));
+    checkEqual(bitmap, low, "bitmap difference back under the limit");
+
+    bitmap = fromSet(all);
+    bitmap.intersectWith(fromSet(low));
+    checkEqual(bitmap, low, "bitmap-bitmap intersection under the limit");
+
+    RoaringBitmap array = fromSet(low);
+    array.intersectWith(fromSet(all));
+    checkEqual(array, low, "array-bitmap intersection");
+    array.subtract(fromSet(all));
+    checkEqual(array, {}, "array-bitmap difference");
+}
+
+static void testExcludeFromAll()
+{
+    // An exclude-only query keeps everything but the excluded tags' IDs
+    TagIndex index;
+    std::set<int> expected;
+    for (int id = 1; id <= 10000; id++)
+    {
+        std::vector<std::string> tags;
+        if (id % 3 == 0)
+        {
+            tags.push_back("rent");
+        }
+        if (id % 5 == 0)
+        {
+            tags.push_back("travel");
+        }
+        index.add(id, tags);
+        if (id % 3 != 0 && id % 5 != 0)
+        {
+            expected.insert(id);
+        }
+    }
+
+    RoaringBitmap candidates = index.all();
+    candidates.subtract(*index.find("rent"));
+    candidates.subtract(*index.find("travel"));
+    checkEqual(candidates, expected, "all minus excluded tags");
+
+    // Removing a transaction removes it from all() as well
+    index.remove(1, {});
+    expected.erase(1);
+    candidates = index.all();
+    candidates.subtract(*index.find("rent"));
+    candidates.subtract(*index.find("travel"));
+    checkEqual(candidates, expected, "all minus excluded tags after a removal");
+
+    check(index.find("unused") == nullptr, "unknown tag has no bitmap");
+}
+
+int main()
+{
+    testArrayLimitByAdd();
+    testArrayLimitByRemove();
+    testEmptyContainers();
+    testMixedOperations();
+    testExcludeFromAll();
+
+    if (g_failures != 0)
+    {
+        std::cerr << g_failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All RoaringBitmap checks passed" << std::endl;
+    return 0;
+}